@@ -24,13 +24,13 @@
  * O sistema oferece as seguintes funcionalidades integradas:
  * 
  * @subsection queue_features Fila Circular de Peças
- * - **Capacidade**: 5 peças simultâneas
+ * - **Capacidade**: CAPACIDADE_FILA peças simultâneas (padrão 5, definida na compilação)
  * - **Operações**: Inserção (enqueue) e remoção (dequeue)
  * - **Algoritmo**: Circular com índices dinâmicos
  * - **Validação**: Controle automático de overflow/underflow
  * 
  * @subsection stack_features Pilha de Reserva
- * - **Capacidade**: 3 peças reservadas
+ * - **Capacidade**: CAPACIDADE_PILHA peças reservadas (padrão 3, definida na compilação)
  * - **Operações**: Empilhamento (push) e desempilhamento (pop)
  * - **Algoritmo**: LIFO (Last In, First Out)
  * - **Estratégia**: Permite reservar peças para uso posterior
@@ -137,6 +137,37 @@
  * }
  * @endcode
  * 
+ * @subsection headless_usage Simulação Headless
+ * @code
+ * // Linha de comando: 10000 partidas de 500 jogadas com a política gulosa
+ * ./tetris --simular --partidas 10000 --jogadas 500 --politica gulosa
+ * 
+ * // Roteiro fixo de ações do menu (1=fila, 2=pilha, 3=reservar, 4=gerar)
+ * ./tetris --simular --roteiro 1131 --semente 42
+ * 
+ * // Um milhão de sessões independentes distribuídas em todos os núcleos
+ * ./tetris --simular --partidas 1000000 --threads 0
+ * 
+ * // Grava todas as ações em um log binário e depois o reproduz (auditoria)
+ * ./tetris --simular --partidas 100 --gravar partidas.log
+ * ./tetris --replay partidas.log --sessao 7
+ * 
+ * // Política guiada pelo conselheiro de jogadas (expectimax de 4 jogadas)
+ * ./tetris --simular --partidas 1000 --politica conselheiro --profundidade 4
+ * 
+ * // Ranking persistente de recordes compartilhado entre execuções
+ * ./tetris --simular --partidas 100000 --threads 0 --ranking recordes.bin
+ * ./tetris --ranking recordes.bin --top 20
+ * ./tetris --ranking recordes.bin --posicao 150000   // Posição que a pontuação ocuparia
+ * 
+ * // Jogo interativo ou em tempo real registrando o resultado no ranking
+ * ./tetris --recordes recordes.bin
+ * ./tetris --tempo-real --recordes recordes.bin
+ * 
+ * // Balanceamento: um milhão de partidas com a peça T valendo 95 e combo de 0.25x
+ * ./tetris --balanceamento --partidas 1000000 --pontos T=95 --passo-combo 0.25
+ * @endcode
+ * 
  * @section performance_sec Otimizações de Performance
  * 
  * O sistema Expert inclui várias otimizações:
@@ -144,6 +175,41 @@
  * - **Validação Automática**: Correção de inconsistências em tempo real
  * - **Algoritmos Eficientes**: Complexidade O(1) para operações críticas
  * - **Gestão de Memória**: Uso otimizado de estruturas fixas
+ * - **Pontuação em Lote**: processarJogadasLote pontua muitas sessões por
+ *   chamada (estrutura de vetores, kernels AVX2/SSE4.1 escolhidos em tempo
+ *   de execução), com resultado idêntico ao de processarJogadaExpert
+ * - **Hash Zobrist**: fila e pilha mantêm em O(1) o hash do seu conteúdo;
+ *   o conselheiro de jogadas o usa como chave de uma tabela de transposição
+ *   sem travas, compartilhada entre threads e entre consultas
+ * - **Limites de Nível Tabelados**: a progressão consulta uma tabela inteira
+ *   exata em vez de chamar pow; nivelParaPontuacao converte pontuação em
+ *   nível em O(1), sem libm
+ * - **Poço em Bitboard**: cada linha do poço é um uint16_t; colisão e
+ *   detecção de linhas completas usam palavras de 64 bits (quatro linhas
+ *   por operação, sem desvio por célula)
+ * - **Enumeração de Colocações**: quedas e notas saem do perfil de alturas
+ *   e de tabelas por rotação, memoizadas pela assinatura da superfície
+ * - **Servidor Multijogador**: um reator epoll por núcleo atende milhares de
+ *   sessões por socket Unix ou TCP com comandos de um byte e respostas de
+ *   16 bytes, sem alocação por comando; --carga mede o p99 de ponta a ponta
+ * - **Pool de Sessões**: sessões em slots de 64 bytes dentro de lajes
+ *   alinhadas de 64 KiB, com lista livre intrusiva e bitmap de ocupação;
+ *   cada shard do servidor aloca suas conexões do próprio pool
+ * - **Instrumentação**: com -DTETRIS_INSTRUMENTACAO, contadores por thread e
+ *   histogramas log-lineares de latência das operações externas do motor
+ *   (fila, pilha, jogada completa, lote, comando do servidor), mais
+ *   contadores sem cronometragem de pontuação, combos e subidas de nível,
+ *   exibidos ou exportados no formato do Prometheus (--metricas, SIGUSR1, opção 12).
+ *   Toda chamada é contada, mas só 1 em INTERVALO_AMOSTRAGEM_INSTRUMENTACAO
+ *   (64) é cronometrada: a simulação fica cerca de 15% mais lenta, contra
+ *   cerca de 2,7x cronometrando todas as chamadas
+ * - **Alimentador de Peças**: uma thread produtora sorteia peças adiantadas
+ *   em um anel SPSC sem travas; o jogo completa a fila sem esperar e o anel
+ *   conta contrapressão e faltas (--alimentador)
+ * - **Analisador de Balanceamento**: as partidas simuladas em paralelo são
+ *   pontuadas também por constantes alternativas (pontos por tipo, passo de
+ *   combo, crescimento dos níveis), com distribuição de pontuação, chance de
+ *   alcançar cada nível e histograma de combos com IC de 95% (--balanceamento)
  * 
  * @section compatibility_sec Compatibilidade
  * 
@@ -152,15 +218,100 @@
  * - **Plataformas**: Windows, Linux, macOS
  * - **Dependências**: Apenas bibliotecas padrão do C
  * 
+ * @section build_sec Compilação
+ * @code
+ * gcc -O2 -Wall -Wextra -std=c99 -pthread tetris.c -o tetris -lm
+ * 
+ * ./tetris                      // Jogo interativo
+ * ./tetris --simular [...]      // Simulação headless
+ * ./tetris --balanceamento [...] // Análise de Monte Carlo das constantes de pontuação
+ * ./tetris --benchmark [...]    // Microbenchmarks do caminho crítico
+ * ./tetris --gravar ARQ        // Jogo interativo gravado no log binário ARQ
+ * ./tetris --alimentador        // Jogo interativo com as peças sorteadas por uma thread produtora
+ * ./tetris --replay ARQ         // Reproduz um log pelo motor de pontuação
+ * ./tetris --ranking ARQ        // Exibe os melhores recordes do ranking ARQ
+ * ./tetris --tempo-real         // Jogo com gravidade e teclas sem Enter (terminal POSIX)
+ * ./tetris --tempo-real --cache-colocacoes // Idem, com o cache de colocações (fluxos repetitivos)
+ * ./tetris --simular --tabuleiro sim   // Simulação com as peças caindo no poço
+ * ./tetris --servidor [...]     // Servidor multijogador (epoll, Linux)
+ * ./tetris --carga [...]        // Gerador de carga local para o servidor
+ * 
+ * // Capacidades alternativas da fila e da pilha (modos de jogo)
+ * gcc -O2 -std=c99 -pthread -DCAPACIDADE_FILA=8 -DCAPACIDADE_PILHA=1 tetris.c -o tetris -lm
+ * 
+ * // Instrumentação do motor (sem ela, os pontos de medição não geram código)
+ * gcc -O2 -std=c99 -pthread -DTETRIS_INSTRUMENTACAO tetris.c -o tetris -lm
+ * gcc -O2 -std=c99 -pthread -DTETRIS_INSTRUMENTACAO -DINTERVALO_AMOSTRAGEM_INSTRUMENTACAO=1 tetris.c -o tetris -lm
+ * ./tetris --simular --metricas tetris_metricas.prom
+ * @endcode
+ * 
  * @author João Santos - Universidade Estácio de Sá
  * @date Janeiro 2025
  * @version 3.0.0 - Nível Expert
  */
 
+#define _POSIX_C_SOURCE 200809L  // Habilita clock_gettime e sysconf nas plataformas POSIX
+
 #include <stdio.h>   // Funções de entrada/saída (printf, scanf, getchar)
-#include <stdlib.h>  // Funções utilitárias (rand, srand, exit)
+#include <stdlib.h>  // Funções utilitárias (malloc, qsort, exit)
+#include <stdarg.h>  // Argumentos variáveis (composição do quadro de terminal)
+#include <stdint.h>  // Inteiros de largura fixa (estado do gerador de peças)
+#include <stddef.h>  // offsetof (soma de verificação do snapshot)
 #include <time.h>    // Funções de tempo (time para inicialização aleatória)
-#include <math.h>    // Funções matemáticas (pow para cálculos de progressão)
+#include <math.h>    // Funções matemáticas (sqrt nas estatísticas da simulação)
+#include <limits.h>  // INT_MAX/LLONG_MAX (limites de nível, saturação da pontuação)
+#include <string.h>  // Manipulação de strings (strcmp, strlen para argumentos)
+#include <errno.h>   // errno (chamadas interrompidas no laço de eventos)
+#include <pthread.h> // Threads POSIX (simulação paralela de sessões)
+#include <unistd.h>  // sysconf para detectar a quantidade de núcleos
+#ifndef _WIN32
+#include <fcntl.h>     // open (replay do log de jogadas)
+#include <sys/mman.h>  // mmap (replay do log sem cópia)
+#include <sys/stat.h>  // fstat (tamanho do log)
+#include <termios.h>   // Terminal em modo não canônico (jogo em tempo real)
+#include <poll.h>      // Espera por teclas com prazo (laço de eventos)
+#include <signal.h>    // sigaction (encerramento do tempo real)
+#endif
+#ifdef __linux__
+#include <fcntl.h>         // O_NONBLOCK (sockets não bloqueantes)
+#include <signal.h>        // sigaction (encerramento do servidor)
+#include <sys/epoll.h>     // Reator de eventos do servidor multijogador
+#include <sys/socket.h>    // Sockets do servidor e do gerador de carga
+#include <sys/un.h>        // Socket Unix
+#include <sys/resource.h>  // Limite de descritores abertos
+#include <netinet/in.h>    // Endereços TCP
+#include <netinet/tcp.h>   // TCP_NODELAY
+#include <arpa/inet.h>     // htons/htonl
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // Intrínsecos SSE4.1/AVX2 (pontuação em lote)
+#define LOTE_VETORIAL_X86 1
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              CONFIGURAÇÃO DE COMPILAÇÃO
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// Capacidade da fila de peças futuras (sobrescreva com -DCAPACIDADE_FILA=N)
+#ifndef CAPACIDADE_FILA
+#define CAPACIDADE_FILA 5
+#endif
+
+/// Capacidade da pilha de reserva (sobrescreva com -DCAPACIDADE_PILHA=N)
+#ifndef CAPACIDADE_PILHA
+#define CAPACIDADE_PILHA 3
+#endif
+
+#if CAPACIDADE_FILA < 1 || CAPACIDADE_PILHA < 1
+#error "CAPACIDADE_FILA e CAPACIDADE_PILHA devem ser maiores que zero"
+#endif
+
+/// Avança um índice da fila circular; potências de dois usam máscara em vez de módulo
+#if (CAPACIDADE_FILA & (CAPACIDADE_FILA - 1)) == 0
+#define INDICE_CIRCULAR(indice) ((indice) & (CAPACIDADE_FILA - 1))
+#else
+#define INDICE_CIRCULAR(indice) ((indice) % CAPACIDADE_FILA)
+#endif
 
 // ═══════════════════════════════════════════════════════════════════════════════
 //                              DEFINIÇÕES DE ESTRUTURAS
@@ -186,54 +337,113 @@ typedef struct {
     int id;     // Identificador único e sequencial (1, 2, 3, ...)
 } Peca;
 
+/**
+ * @brief Representação compacta de uma peça em 32 bits
+ * 
+ * Os 3 bits inferiores guardam o índice denso do tipo (TipoPeca) e os 29
+ * superiores guardam o ID. Ocupa metade de uma Peca (8 bytes com o
+ * preenchimento) e é o formato armazenado pela fila e pela pilha;
+ * compactarPeca e expandirPeca fazem a conversão nas bordas da API.
+ * 
+ * @note IDs acima de LIMITE_ID_COMPACTO são truncados (módulo 2^29)
+ * @note Tipos fora de I, O, T, S, Z, J, L voltam como a peça vazia 'X'
+ */
+typedef uint32_t PecaCompacta;
+
+/// Bits reservados ao tipo em uma PecaCompacta
+#define BITS_TIPO_COMPACTO 3
+
+/// Máscara do tipo em uma PecaCompacta
+#define MASCARA_TIPO_COMPACTO ((1u << BITS_TIPO_COMPACTO) - 1)
+
+/// Maior ID representável em uma PecaCompacta
+#define LIMITE_ID_COMPACTO (UINT32_MAX >> BITS_TIPO_COMPACTO)
+
+/// Níveis cujo limite de pontos cabe em int (os seguintes usam INT_MAX)
+#define NIVEIS_TABELADOS 36
+
+/// Base (ímpar) que posiciona as chaves Zobrist da fila e da pilha
+#define BASE_ZOBRIST 0x9E3779B97F4A7C15ULL
+
+/// Inverso multiplicativo de BASE_ZOBRIST módulo 2^64
+#define INVERSO_BASE_ZOBRIST 0xF1DE83E19937733DULL
+
 /**
  * @brief Estrutura que implementa uma fila circular para gerenciamento de peças
  * 
  * A fila circular otimiza o uso de memória reutilizando posições do array.
- * Mantém exatamente 5 peças em rotação constante, seguindo o padrão FIFO
+ * Mantém até CAPACIDADE_FILA peças em rotação constante, seguindo o padrão FIFO
  * (First In, First Out - primeiro a entrar, primeiro a sair).
  * 
  * Componentes da estrutura:
- * • pecas[5]: Array fixo que armazena as 5 peças
+ * • pecas[CAPACIDADE_FILA]: Array fixo que armazena as peças (formato compacto)
  * • indiceFrente: Aponta para a próxima peça a ser jogada
  * • indiceTras: Aponta para a posição da última peça inserida
- * • quantidadePecas: Contador atual de peças válidas (0 a 5)
+ * • quantidadePecas: Contador atual de peças válidas (0 a CAPACIDADE_FILA)
+ * • hashZobrist: Hash do conteúdo, atualizado em O(1) a cada inserção e remoção
+ * 
+ * O hash é a soma de zobristFila[tipo] x BASE_ZOBRIST^k, com k contado a
+ * partir da frente: depende só dos tipos e da ordem das peças, e não de
+ * onde elas estão no array circular nem de seus IDs.
  * 
- * @note A circularidade é implementada usando operação módulo (%)
+ * @note A circularidade é implementada com INDICE_CIRCULAR (módulo ou máscara)
  * @note Quando cheia, novas inserções sobrescrevem as mais antigas
  */
 typedef struct {
-    Peca pecas[5];          // Array circular com capacidade fixa de 5 peças
+    PecaCompacta pecas[CAPACIDADE_FILA]; // Array circular com capacidade fixa
     int indiceFrente;       // Índice da frente (próxima peça a jogar)
     int indiceTras;         // Índice do final (última peça inserida)
-    int quantidadePecas;    // Contador atual de peças válidas (0-5)
+    int quantidadePecas;    // Contador atual de peças válidas (0-CAPACIDADE_FILA)
+    uint64_t hashZobrist;   // Hash Zobrist posicional do conteúdo
+    uint64_t potenciaZobrist; // BASE_ZOBRIST^quantidadePecas (peso da próxima inserção)
 } FilaCircular;
 
 /**
  * @brief Estrutura que implementa uma pilha linear para reserva estratégica
  * 
- * A pilha de reserva permite armazenamento temporário de até 3 peças,
+ * A pilha de reserva permite armazenamento temporário de até CAPACIDADE_PILHA peças,
  * seguindo o padrão LIFO (Last In, First Out - último a entrar, primeiro a sair).
  * É utilizada para estratégias avançadas de gerenciamento de peças.
  * 
  * Componentes da estrutura:
- * • pecasReservadas[3]: Array linear para armazenamento das peças
- * • indiceTopo: Índice do topo da pilha (-1 = vazia, 0-2 = posições válidas)
- * • quantidadeReservada: Contador atual de peças reservadas (0 a 3)
+ * • pecasReservadas[CAPACIDADE_PILHA]: Array linear das peças (formato compacto)
+ * • indiceTopo: Índice do topo da pilha (-1 = vazia, 0 a CAPACIDADE_PILHA-1 = válido)
+ * • quantidadeReservada: Contador atual de peças reservadas (0 a CAPACIDADE_PILHA)
+ * • hashZobrist: Hash do conteúdo (zobristPilha[tipo] x BASE_ZOBRIST^posição), em O(1)
  * 
  * Operações principais:
  * • Push (empilhar): Adiciona peça no topo, incrementa indiceTopo
  * • Pop (desempilhar): Remove peça do topo, decrementa indiceTopo
  * 
  * @note O índice -1 indica pilha vazia
- * @note Máximo de 3 peças podem ser armazenadas simultaneamente
+ * @note Máximo de CAPACIDADE_PILHA peças podem ser armazenadas simultaneamente
  */
 typedef struct {
-    Peca pecasReservadas[3];    // Array linear para até 3 peças reservadas
-    int indiceTopo;             // Índice do topo (-1=vazia, 0-2=válido)
-    int quantidadeReservada;    // Contador atual de peças reservadas (0-3)
+    PecaCompacta pecasReservadas[CAPACIDADE_PILHA]; // Array linear para as peças reservadas
+    int indiceTopo;             // Índice do topo (-1=vazia)
+    int quantidadeReservada;    // Contador atual de peças reservadas
+    uint64_t hashZobrist;       // Hash Zobrist posicional do conteúdo
+    uint64_t potenciaZobrist;   // BASE_ZOBRIST^quantidadeReservada (peso do próximo topo)
 } PilhaReserva;
 
+/**
+ * @brief Índice denso dos tipos de peça, usado para indexar tabelas
+ * 
+ * A ordem é a mesma de tiposPecas: I, O, T, S, Z, J, L. Qualquer outro
+ * caractere (inclusive a peça vazia 'X') é mapeado para PECA_DESCONHECIDA.
+ */
+typedef enum {
+    PECA_I = 0,
+    PECA_O,
+    PECA_T,
+    PECA_S,
+    PECA_Z,
+    PECA_J,
+    PECA_L,
+    PECA_DESCONHECIDA,
+    TOTAL_TIPOS_PECA
+} TipoPeca;
+
 /**
  * @brief Estrutura para sistema de pontuação e estatísticas avançadas - Nível Expert
  * 
@@ -258,6 +468,7 @@ typedef struct {
     int pontuacaoNivel;          ///< Pontuação no nível atual (reset a cada nível)
     double multiplicadorAtual;   ///< Multiplicador de pontos atual (1.0x-10.0x)
     int pontosUltimaJogada;      ///< Pontos ganhos na última jogada
+    int pontosPorTipo[TOTAL_TIPOS_PECA]; ///< Cache: base x multiplicador x dificuldade por tipo
     
     // ═══════════════════════════════════════════════════════════════
     //                    SISTEMA DE COMBOS
@@ -288,11 +499,8 @@ typedef struct {
     // ═══════════════════════════════════════════════════════════════
     //                 ESTATÍSTICAS POR TIPO
     // ═══════════════════════════════════════════════════════════════
-    int contagemTipoI;           ///< Contador de peças tipo 'I' jogadas
-    int contagemTipoO;           ///< Contador de peças tipo 'O' jogadas
-    int contagemTipoT;           ///< Contador de peças tipo 'T' jogadas
-    int contagemTipoL;           ///< Contador de peças tipo 'L' jogadas
-    char tipoMaisJogado;         ///< Tipo de peça mais utilizado
+    int contagemPorTipo[TOTAL_TIPOS_PECA]; ///< Peças jogadas por tipo, indexado por TipoPeca
+    char tipoMaisJogado;         ///< Tipo de peça mais utilizado (mantido incrementalmente)
     
     // ═══════════════════════════════════════════════════════════════
     //                 CONQUISTAS E MARCOS
@@ -302,628 +510,9267 @@ typedef struct {
     int recordePessoal;          ///< Maior pontuação já alcançada
 } SistemaExpert;
 
-// ═══════════════════════════════════════════════════════════════════════════════
-//                              PROTÓTIPOS DAS FUNÇÕES
-// ═══════════════════════════════════════════════════════════════════════════════
+/**
+ * @brief Modos de sorteio do gerador de peças
+ */
+typedef enum {
+    GERADOR_UNIFORME = 0,   ///< Cada peça sorteada de forma independente (sem viés)
+    GERADOR_SACO7           ///< "7-bag": cada bloco de 7 peças contém todos os tipos
+} ModoGeradorPecas;
 
-// Funções da Fila Circular
-void inicializarFila(FilaCircular* filaPtr);
-int filaVazia(FilaCircular* filaPtr);
-int filaCheia(FilaCircular* filaPtr);
-void inserirPecaNaFila(FilaCircular* filaPtr, Peca novaPeca);
-Peca jogarPecaDaFila(FilaCircular* filaPtr);
-void exibirFila(FilaCircular* filaPtr);
+/**
+ * @brief Gerador de peças determinístico, com estado próprio por sessão
+ * 
+ * Usa o algoritmo xoshiro128** (128 bits de estado), semeado explicitamente
+ * via SplitMix64. Não depende de estado global: duas instâncias com a mesma
+ * semente produzem exatamente a mesma sequência, em qualquer thread.
+ */
+typedef struct {
+    uint32_t estado[4];          ///< Estado do xoshiro128**
+    ModoGeradorPecas modo;       ///< Modo de sorteio
+    char saco[7];                ///< Saco atual embaralhado (modo GERADOR_SACO7)
+    int posicaoSaco;             ///< Próxima posição do saco (7 = saco esgotado)
+} GeradorPecas;
 
-// Funções da Pilha de Reserva
-void inicializarPilha(PilhaReserva* pilhaPtr);
-int pilhaVazia(PilhaReserva* pilhaPtr);
-int pilhaCheia(PilhaReserva* pilhaPtr);
-void reservarPeca(PilhaReserva* pilhaPtr, Peca peca);
-Peca jogarPecaDaPilha(PilhaReserva* pilhaPtr);
-void exibirPilha(PilhaReserva* pilhaPtr);
+/**
+ * @brief Tipos de evento gravados no log binário de jogadas
+ */
+typedef enum {
+    EVENTO_INICIO_SESSAO = 1,    ///< Nova sessão (id = índice da partida); zera a pontuação no replay
+    EVENTO_JOGADA,               ///< Peça jogada; origem 0=fila, 1=pilha (mesmo flag de processarJogadaExpert)
+    EVENTO_RESERVA,              ///< Peça da frente da fila transferida para a pilha
+    EVENTO_REABASTECIMENTO,      ///< Peças geradas (quantidade) a partir do id informado
+    EVENTO_OTIMIZACAO            ///< otimizarSistemaExpert aplicado (altera multiplicadores)
+} TipoEventoLog;
 
-// Funções do Sistema Expert
-void inicializarSistemaExpert(SistemaExpert* sistemaPtr);
-int calcularPontuacao(char tipoPeca, SistemaExpert* sistemaPtr);
-double detectarCombo(SistemaExpert* sistemaPtr, char tipoPeca);
-void verificarProgressaoNivel(SistemaExpert* sistemaPtr);
-void processarJogadaExpert(Peca peca, int origem, SistemaExpert* sistemaPtr);
-void exibirEstatisticasExpert(SistemaExpert* sistemaPtr);
-int otimizarSistemaExpert(SistemaExpert* sistemaPtr);
-void gerarRelatorioExpert(SistemaExpert* sistemaPtr);
+/**
+ * @brief Registro de tamanho fixo (8 bytes) do log de jogadas
+ */
+typedef struct {
+    uint8_t evento;              ///< TipoEventoLog
+    uint8_t origem;              ///< Origem da jogada (0=fila, 1=pilha)
+    char tipo;                   ///< Tipo da peça ('X' quando não se aplica)
+    uint8_t quantidade;          ///< Peças geradas (EVENTO_REABASTECIMENTO); 1 = sessão com poço (EVENTO_INICIO_SESSAO)
+    uint32_t id;                 ///< ID da peça ou índice da sessão
+} RegistroJogada;
 
-// Funções Utilitárias
-Peca criarPeca(char tipo, int id);
-void gerarPecasAleatorias(FilaCircular* filaPtr);
-void transferirPecaFilaParaPilha(FilaCircular* filaPtr, PilhaReserva* pilhaPtr);
-void exibirEstadoCompleto(FilaCircular* filaPtr, PilhaReserva* pilhaPtr, SistemaExpert* sistemaPtr);
-void exibirMenu();
-void pausarExecucao();
+/**
+ * @brief Cabeçalho do arquivo de log, gravado uma única vez no início
+ */
+typedef struct {
+    char magica[4];              ///< Sempre "TLOG"
+    uint16_t versao;             ///< VERSAO_LOG_JOGADAS
+    uint16_t tamanhoRegistro;    ///< sizeof(RegistroJogada), conferido no replay
+    int64_t criadoEm;            ///< Instante de criação (time)
+} CabecalhoLogJogadas;
 
-// Variável global para controle de IDs sequenciais
-int proximoId = 1;
+/// Versão atual do formato do log de jogadas
+#define VERSAO_LOG_JOGADAS 1
 
-// ═══════════════════════════════════════════════════════════════════════════════
-//                              IMPLEMENTAÇÃO DAS FUNÇÕES
-// ═══════════════════════════════════════════════════════════════════════════════
+/// Registros acumulados em memória antes de cada escrita no arquivo
+#define REGISTROS_BUFFER_LOG 4096
 
 /**
- * @brief Inicializa a fila circular
- * @param filaPtr Ponteiro para a estrutura da fila
+ * @brief Gravador do log de jogadas (somente acréscimo, com buffer)
  */
-void inicializarFila(FilaCircular* filaPtr) {
-    filaPtr->indiceFrente = 0;
-    filaPtr->indiceTras = 0;
-    filaPtr->quantidadePecas = 0;
-}
+typedef struct {
+    FILE* arquivo;               ///< Arquivo aberto em modo de acréscimo
+    RegistroJogada buffer[REGISTROS_BUFFER_LOG]; ///< Registros ainda não gravados
+    int quantidade;              ///< Registros ocupados no buffer
+    long long totalRegistros;    ///< Registros gravados desde a abertura
+} LogJogadas;
+
+/// Maior profundidade (em jogadas pontuadas) aceita pelo conselheiro
+#define PROFUNDIDADE_MAXIMA_CONSELHEIRO 32
+
+/// Ações possíveis na raiz da busca: 1=fila, 2=pilha, 3=reservar
+#define ACOES_CONSELHEIRO 3
+
+/// Entradas da tabela de transposição (log2) do conselheiro em cada partida simulada
+#define BITS_CACHE_CONSELHEIRO_SIMULACAO 14
+
+/// Estados examinados por decisão na simulação (limite determinístico, no lugar do prazo)
+#define ORCAMENTO_NOS_CONSELHEIRO_SIMULACAO 2000
+
+/// Parâmetros do conselheiro no jogo interativo: resposta em até 200 ms
+#define PROFUNDIDADE_CONSELHEIRO_INTERATIVO 12
+#define ORCAMENTO_CONSELHEIRO_INTERATIVO_MS 200.0
+#define BITS_CACHE_CONSELHEIRO_INTERATIVO 18
 
 /**
- * @brief Verifica se a fila está vazia
- * @param filaPtr Ponteiro para a estrutura da fila
- * @return 1 se vazia, 0 caso contrário
+ * @brief Parâmetros do conselheiro de jogadas (busca expectimax)
  */
-int filaVazia(FilaCircular* filaPtr) {
-    return filaPtr->quantidadePecas == 0;
-}
+typedef struct {
+    int profundidade;            ///< Jogadas pontuadas examinadas à frente (1 a PROFUNDIDADE_MAXIMA_CONSELHEIRO)
+    int threads;                 ///< Threads de busca (as ações da raiz são divididas entre elas)
+    double orcamentoMs;          ///< Prazo da resposta em milissegundos (0 = sem prazo)
+    int bitsCache;               ///< Tabela de transposição com 2^bitsCache entradas
+    long long orcamentoNos;      ///< Estados examinados por consulta (0 = sem limite)
+} ConfiguracaoConselheiro;
+
+/// Entradas por balde da tabela de transposição (um balde ocupa uma linha de cache)
+#define ENTRADAS_BALDE_TRANSPOSICAO 4
 
 /**
- * @brief Verifica se a fila está cheia
- * @param filaPtr Ponteiro para a estrutura da fila
- * @return 1 se cheia, 0 caso contrário
+ * @brief Entrada da tabela de transposição
+ * 
+ * Guarda chave XOR dado: uma leitura que encontre as duas palavras de
+ * escritas diferentes (corrida entre threads) não confere com a chave e
+ * é tratada como ausência, dispensando travas.
  */
-int filaCheia(FilaCircular* filaPtr) {
-    return filaPtr->quantidadePecas == 5;
-}
+typedef struct {
+    uint64_t chaveMisturada;     ///< Chave XOR dado (0 com dado 0 = vazia)
+    uint64_t dado;               ///< Bits do valor armazenado (double)
+} EntradaTransposicao;
 
 /**
- * @brief Insere uma peça na fila
- * @param filaPtr Ponteiro para a estrutura da fila
- * @param novaPeca Peça a ser inserida
+ * @brief Balde de entradas alinhado a uma linha de cache (64 bytes)
  */
-void inserirPecaNaFila(FilaCircular* filaPtr, Peca novaPeca) {
-    if (!filaCheia(filaPtr)) {
-        filaPtr->indiceTras = (filaPtr->indiceTras + 1) % 5;
-        filaPtr->pecas[filaPtr->indiceTras] = novaPeca;
-        filaPtr->quantidadePecas++;
-    }
-}
+typedef struct {
+    EntradaTransposicao entradas[ENTRADAS_BALDE_TRANSPOSICAO];
+} BaldeTransposicao;
 
 /**
- * @brief Remove e retorna uma peça da fila
- * @param filaPtr Ponteiro para a estrutura da fila
- * @return Peça removida
+ * @brief Tabela de transposição de tamanho fixo, sem travas
+ * 
+ * Cada consulta toca uma única linha de cache. Pode ser lida e gravada
+ * por várias threads ao mesmo tempo.
  */
-Peca jogarPecaDaFila(FilaCircular* filaPtr) {
-    Peca peca = {'X', 0}; // Peça vazia por padrão
-    if (!filaVazia(filaPtr)) {
-        peca = filaPtr->pecas[filaPtr->indiceFrente];
-        filaPtr->indiceFrente = (filaPtr->indiceFrente + 1) % 5;
-        filaPtr->quantidadePecas--;
-    }
-    return peca;
-}
+typedef struct {
+    BaldeTransposicao* baldes;   ///< Baldes alinhados a 64 bytes
+    uint64_t mascara;            ///< Quantidade de baldes - 1
+} TabelaTransposicao;
 
 /**
- * @brief Exibe o conteúdo da fila
- * @param filaPtr Ponteiro para a estrutura da fila
+ * @brief Estado examinado pela busca do conselheiro
+ * 
+ * Usa a própria fila, a própria pilha e uma cópia do sistema Expert, de
+ * modo que as jogadas simuladas passam pelas mesmas operações do jogo e
+ * o hash Zobrist do estado é mantido por elas. Peças sorteadas pela busca
+ * têm ID 0, já que só o tipo importa para a pontuação.
  */
-void exibirFila(FilaCircular* filaPtr) {
-    printf("Fila: ");
-    for (int i = 0; i < filaPtr->quantidadePecas; i++) {
-        int indice = (filaPtr->indiceFrente + i) % 5;
-        printf("%c ", filaPtr->pecas[indice].tipo);
-    }
-    printf("\n");
-}
+typedef struct {
+    FilaCircular fila;           ///< Peças conhecidas (vazia = próxima peça sorteada)
+    PilhaReserva pilha;          ///< Pilha de reserva
+    int reservouAgora;           ///< 1 se a última ação foi reservar
+    SistemaExpert sistema;       ///< Pontuação simulada
+} EstadoConselheiro;
 
 /**
- * @brief Inicializa a pilha de reserva
- * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @brief Contexto de uma thread de busca do conselheiro
  */
-void inicializarPilha(PilhaReserva* pilhaPtr) {
-    pilhaPtr->indiceTopo = -1;
-    pilhaPtr->quantidadeReservada = 0;
-}
+typedef struct {
+    TabelaTransposicao* tabela;  ///< Tabela de transposição compartilhada
+    long long nos;               ///< Estados visitados na última consulta
+    long long acertosCache;      ///< Estados resolvidos pela cache na última consulta
+    double prazo;                ///< Instante limite em ns (0 = sem prazo)
+    long long limiteNos;         ///< Estados da consulta antes de abortar (0 = sem limite)
+    int abortado;                ///< 1 quando o prazo ou o orçamento de estados venceu no meio de uma profundidade
+    int indice;                  ///< Índice da thread (define as ações da raiz que examina)
+    struct ConselheiroJogadas* conselheiroPtr; ///< Conselheiro dono da thread
+} TrabalhadorConselheiro;
 
 /**
- * @brief Verifica se a pilha está vazia
- * @param pilhaPtr Ponteiro para a estrutura da pilha
- * @return 1 se vazia, 0 caso contrário
+ * @brief Conselheiro de jogadas: configuração, threads e resultados por profundidade
+ * 
+ * A tabela de transposição é compartilhada pelas threads e sobrevive entre
+ * consultas: a chave descreve o estado por completo, então valores
+ * calculados em uma jogada continuam válidos na seguinte.
  */
-int pilhaVazia(PilhaReserva* pilhaPtr) {
-    return pilhaPtr->quantidadeReservada == 0;
-}
+typedef struct ConselheiroJogadas {
+    ConfiguracaoConselheiro config; ///< Parâmetros da busca
+    TabelaTransposicao tabela;   ///< Estados já avaliados
+    TrabalhadorConselheiro* trabalhadores; ///< Um por thread de busca
+    int totalTrabalhadores;      ///< Threads efetivamente usadas (no máximo ACOES_CONSELHEIRO)
+    EstadoConselheiro raiz;      ///< Estado da consulta em andamento
+    int acoes[ACOES_CONSELHEIRO]; ///< Ações válidas na raiz
+    int totalAcoes;              ///< Quantidade de ações válidas na raiz
+    double valores[ACOES_CONSELHEIRO][PROFUNDIDADE_MAXIMA_CONSELHEIRO + 1]; ///< Valor por ação e profundidade
+    int profundidadeConcluida[ACOES_CONSELHEIRO]; ///< Maior profundidade concluída por ação
+} ConselheiroJogadas;
 
 /**
- * @brief Verifica se a pilha está cheia
- * @param pilhaPtr Ponteiro para a estrutura da pilha
- * @return 1 se cheia, 0 caso contrário
+ * @brief Resposta do conselheiro de jogadas
  */
-int pilhaCheia(PilhaReserva* pilhaPtr) {
-    return pilhaPtr->quantidadeReservada == 3;
-}
+typedef struct {
+    int acao;                    ///< Ação sugerida no formato do menu (1=fila, 2=pilha, 3=reservar, 4=gerar)
+    double valorEsperado;        ///< Pontos esperados nas próximas jogadas com a ação sugerida
+    double valorPorAcao[ACOES_CONSELHEIRO + 1]; ///< Valor de cada ação 1 a 3 (-1 = inválida)
+    int profundidade;            ///< Profundidade concluída por todas as ações
+    long long nos;               ///< Estados visitados
+    long long acertosCache;      ///< Estados resolvidos pela cache
+    double milissegundos;        ///< Tempo da consulta
+} SugestaoConselheiro;
+
+/// Colunas do poço
+#define LARGURA_TABULEIRO 10
+
+/// Linhas do poço: 20 visíveis e 2 de folga no topo, onde as peças surgem
+#define ALTURA_TABULEIRO 22
+
+/// Linhas vazias extras após o topo, para ler sempre 4 linhas em uma palavra de 64 bits
+#define LINHAS_FOLGA_TABULEIRO 4
+
+/// Máscara de uma linha completa
+#define LINHA_CHEIA_TABULEIRO ((uint16_t)((1u << LARGURA_TABULEIRO) - 1))
+
+/// Rotações tabeladas por tipo de peça
+#define ROTACOES_PECA 4
+
+/// Máximo de colocações distintas de uma peça (T, J e L: 8 + 9 + 8 + 9)
+#define COLOCACOES_MAXIMAS_PECA 34
+
+/// Log2 das entradas do cache de colocações (2^12 x 184 bytes = 736 KiB)
+#define BITS_CACHE_COLOCACOES 12
 
 /**
- * @brief Adiciona uma peça à pilha de reserva
- * @param pilhaPtr Ponteiro para a estrutura da pilha
- * @param peca Peça a ser reservada
+ * @brief Colocações de um tipo de peça sobre um perfil de alturas
+ * 
+ * A ordem das colocações é fixa (rotação, depois coluna, crescentes), por
+ * isso só a linha de queda e a parte da nota que depende das alturas são
+ * guardadas. Ambas são relativas à coluna mais baixa do poço.
  */
-void reservarPeca(PilhaReserva* pilhaPtr, Peca peca) {
-    if (!pilhaCheia(pilhaPtr)) {
-        pilhaPtr->indiceTopo++;
-        pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo] = peca;
-        pilhaPtr->quantidadeReservada++;
-    }
-}
+typedef struct {
+    uint64_t chave;              ///< Alturas relativas (5 bits por coluna) e tipo + 1; 0 = vazia
+    int32_t parciais[COLOCACOES_MAXIMAS_PECA]; ///< -87 x altura agregada - 18 x irregularidade, sem linhas removidas
+    uint8_t linhas[COLOCACOES_MAXIMAS_PECA];   ///< Linha da base após a queda
+} EntradaCacheColocacoes;
 
 /**
- * @brief Remove e retorna uma peça da pilha
- * @param pilhaPtr Ponteiro para a estrutura da pilha
- * @return Peça removida
+ * @brief Cache de colocações indexado pela assinatura da superfície do poço
+ * 
+ * Mapeamento direto: cada assinatura ocupa uma única entrada, e uma
+ * assinatura nova substitui a anterior. Não é compartilhado entre threads.
  */
-Peca jogarPecaDaPilha(PilhaReserva* pilhaPtr) {
-    Peca peca = {'X', 0}; // Peça vazia por padrão
-    if (!pilhaVazia(pilhaPtr)) {
-        peca = pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo];
-        pilhaPtr->indiceTopo--;
-        pilhaPtr->quantidadeReservada--;
-    }
-    return peca;
-}
+typedef struct {
+    EntradaCacheColocacoes* entradas; ///< Entradas alinhadas a 64 bytes
+    int deslocamento;            ///< 64 - bits de índice (o índice vem dos bits altos do hash)
+    long long consultas;         ///< Enumerações atendidas pelo cache
+    long long acertos;           ///< Enumerações que reaproveitaram uma entrada
+} CacheColocacoes;
 
 /**
- * @brief Exibe o conteúdo da pilha
- * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @brief Poço do jogo como bitboard: uma máscara de 16 bits por linha
+ * 
+ * A linha 0 é a base e o bit c de cada linha é a coluna c. Quatro linhas
+ * consecutivas formam uma palavra de 64 bits, de modo que colisão, fixação
+ * e detecção de linhas completas de uma peça custam uma operação cada.
  */
-void exibirPilha(PilhaReserva* pilhaPtr) {
-    printf("Pilha: ");
-    for (int i = pilhaPtr->indiceTopo; i >= 0; i--) {
-        printf("%c ", pilhaPtr->pecasReservadas[i].tipo);
-    }
-    printf("\n");
-}
+typedef struct {
+    uint16_t linhas[ALTURA_TABULEIRO + LINHAS_FOLGA_TABULEIRO]; ///< Ocupação por linha, da base para o topo
+    int alturaOcupada;           ///< Linhas da base até a mais alta com algum bloco
+    int pecasColocadas;          ///< Peças fixadas no poço
+    int linhasRemovidas;         ///< Linhas completas removidas
+    int derrotas;                ///< Vezes em que uma peça não coube e o poço foi esvaziado
+    CacheColocacoes* cache;      ///< Cache de colocações (NULL = enumeração sem memoização)
+} TabuleiroJogo;
 
 /**
- * @brief Inicializa o sistema Expert com valores padrão
- * @param sistemaPtr Ponteiro para a estrutura do sistema Expert
+ * @brief Posição escolhida para uma peça no poço
  */
-void inicializarSistemaExpert(SistemaExpert* sistemaPtr) {
-    // Inicialização do sistema de pontuação
-    sistemaPtr->pontuacaoTotal = 0;
-    sistemaPtr->multiplicadorAtual = 1.0;
-    sistemaPtr->fatorDificuldade = 1.0;
-    
-    // Inicialização de combos
-    sistemaPtr->comboAtual = 0;
-    sistemaPtr->melhorCombo = 0;
-    sistemaPtr->totalCombos = 0;
-    sistemaPtr->ultimoTipoJogado = 'X';
-    sistemaPtr->sequenciaTipoAtual = 0;
-    
-    // Inicialização dos níveis de dificuldade
-    sistemaPtr->nivelAtual = 1;
-    sistemaPtr->pontosParaProximoNivel = 1000;
-    sistemaPtr->limitePontosNivel = 1000;
-    
-    // Inicialização das estatísticas avançadas
-    sistemaPtr->totalJogadas = 0;
-    sistemaPtr->jogadasDaFila = 0;
-    sistemaPtr->jogadasDaPilha = 0;
-    sistemaPtr->pecasReservadas = 0;
-    sistemaPtr->eficienciaReserva = 0;
-    
-    // Inicialização das estatísticas por tipo de peça
-    sistemaPtr->contagemTipoI = 0;
-    sistemaPtr->contagemTipoO = 0;
-    sistemaPtr->contagemTipoT = 0;
-    sistemaPtr->contagemTipoL = 0;
-    sistemaPtr->tipoMaisJogado = 'I';
-    
-    // Inicialização de combos
-    sistemaPtr->comboAtual = 0;
-    sistemaPtr->melhorCombo = 0;
-    sistemaPtr->totalCombos = 0;
-    sistemaPtr->ultimoTipoJogado = 'X';
-    sistemaPtr->sequenciaTipoAtual = 0;
-    
-    // Inicialização de conquistas e marcos
-    sistemaPtr->conquistasDesbloqueadas = 0;
-    sistemaPtr->marcosAlcancados = 0;
-    sistemaPtr->recordePessoal = 0;
-}
+typedef struct {
+    int rotacao;                 ///< Rotação (índice em linhasPecaTabuleiro)
+    int coluna;                  ///< Coluna do bloco mais à esquerda
+    int linha;                   ///< Linha da base da peça após a queda
+    int linhasRemovidas;         ///< Linhas completadas pela peça
+    int avaliacao;               ///< Nota heurística do poço resultante (maior = melhor)
+} ColocacaoPeca;
 
 /**
- * @brief Calcula a pontuação base para um tipo de peça
- * @param tipoPeca Tipo da peça jogada
- * @param sistemaPtr Ponteiro para o sistema Expert
- * @return Pontuação calculada
+ * @brief Sessão de jogo independente (fila, pilha, pontuação e IDs próprios)
+ * 
+ * Cada sessão possui seu próprio contador de IDs e gerador de peças,
+ * permitindo que várias sessões rodem em paralelo sem compartilhar a
+ * variável global proximoId nem qualquer estado de sorteio.
+ */
+typedef struct {
+    FilaCircular fila;           ///< Fila de peças futuras da sessão
+    PilhaReserva pilha;          ///< Pilha de reserva da sessão
+    SistemaExpert sistema;       ///< Pontuação e estatísticas da sessão
+    int proximoId;               ///< Próximo ID de peça desta sessão
+    GeradorPecas gerador;        ///< Gerador de peças desta sessão
+    LogJogadas* log;             ///< Log binário das ações (NULL = desativado)
+    ConselheiroJogadas* conselheiro; ///< Conselheiro da POLITICA_CONSELHEIRO (NULL nas demais)
+    TabuleiroJogo* tabuleiro;    ///< Poço onde as peças jogadas são colocadas (NULL = só pontuação)
+} SessaoJogo;
+
+/// Bytes (e alinhamento) de cada laje do pool de sessões
+#define BYTES_LAJE_POOL 65536
+
+/// Máximo de slots por laje (uma palavra de ocupação)
+#define SLOTS_MAXIMOS_LAJE_POOL 64
+
+/// Bytes reservados ao cabeçalho no início de cada laje (múltiplo de 64)
+#define CABECALHO_LAJE_POOL (64 + SLOTS_MAXIMOS_LAJE_POOL * 8)
+
+/**
+ * @brief Laje do pool: cabeçalho seguido de slots contíguos
+ * 
+ * Cada laje ocupa BYTES_LAJE_POOL bytes alinhados ao próprio tamanho,
+ * então a laje de um slot é obtida mascarando o endereço do slot.
+ */
+typedef struct LajePoolSessoes {
+    struct LajePoolSessoes* proxima; ///< Próxima laje do pool
+    uint64_t ocupados;           ///< Bit i = slot i em uso
+    long long indiceSessao[SLOTS_MAXIMOS_LAJE_POOL]; ///< Índice de alocação de cada slot (semente do reinício)
+} LajePoolSessoes;
+
+/**
+ * @brief Pool de sessões em lajes alinhadas, com lista de slots livres
+ * 
+ * Cada slot guarda uma SessaoJogo inteira (fila, pilha e sistema Expert
+ * contíguos) no início de um bloco múltiplo de 64 bytes, seguida
+ * opcionalmente de dados do chamador (tamanhoSlot maior que a sessão).
+ * Slots liberados são reutilizados primeiro (LIFO), enquanto ainda estão
+ * no cache. Não é compartilhado entre threads.
+ */
+typedef struct {
+    size_t tamanhoSlot;          ///< Bytes por slot, múltiplo de 64
+    int slotsPorLaje;            ///< Slots em cada laje
+    LajePoolSessoes* lajes;      ///< Lajes alocadas
+    void* livres;                ///< Slots livres, encadeados pelo primeiro ponteiro do slot
+    long long lajesAlocadas;     ///< Quantidade de lajes
+    long long emUso;             ///< Slots ocupados
+    long long maiorEmUso;        ///< Pico de slots ocupados
+    long long alocacoes;         ///< Slots entregues desde a criação
+    long long liberacoes;        ///< Slots devolvidos desde a criação
+} PoolSessoes;
+
+/// Posições do anel do alimentador de peças (potência de dois)
+#define CAPACIDADE_ALIMENTADOR 1024
+
+/// Peças geradas e publicadas de uma vez pelo produtor
+#define LOTE_ALIMENTADOR 64
+
+/// Espera do produtor com o anel cheio (ns)
+#define ESPERA_ALIMENTADOR_NS 100000L
+
+/**
+ * @brief Anel produtor/consumidor único que alimenta a fila de peças
+ * 
+ * Uma thread produtora sorteia peças adiantadas com gerador e IDs
+ * próprios; a thread do jogo as retira sem travas e sem esperar. Cada
+ * índice é escrito por um só lado, e os campos de cada lado ficam
+ * separados por uma linha de cache de folga, sem compartilhamento falso.
+ * Cada lado guarda a última posição vista do outro e só relê o índice
+ * alheio quando ela não basta.
+ */
+typedef struct {
+    // Lado do produtor
+    unsigned int cauda;          ///< Próxima posição a escrever (publicada com release)
+    unsigned int cabecaVista;    ///< Última cabeça lida pelo produtor
+    GeradorPecas gerador;        ///< Gerador usado pelo produtor
+    int proximoId;               ///< ID da próxima peça produzida
+    long long produzidas;        ///< Peças publicadas no anel
+    long long esperasCheio;      ///< Vezes em que o produtor esperou por anel cheio (contrapressão)
+    char folgaProdutor[64];      ///< Separa os lados em linhas de cache distintas
+    
+    // Lado do consumidor
+    unsigned int cabeca;         ///< Próxima posição a ler (publicada com release)
+    unsigned int caudaVista;     ///< Última cauda lida pelo consumidor
+    long long consumidas;        ///< Peças retiradas do anel
+    long long faltas;            ///< Retiradas atendidas só em parte (anel vazio)
+    long long pecasFaltantes;    ///< Peças pedidas que o anel não tinha
+    char folgaConsumidor[64];    ///< Separa o consumidor do controle e das peças
+    
+    int encerrando;              ///< 1 pede o fim da thread produtora
+    int ativo;                   ///< 1 enquanto a thread produtora existe
+    pthread_t thread;            ///< Thread produtora
+    Peca pecas[CAPACIDADE_ALIMENTADOR]; ///< Peças produzidas e ainda não retiradas
+} AlimentadorPecas;
+
+/// Arquivo gravado pela opção de instrumentação do menu
+#define ARQUIVO_METRICAS_PADRAO "tetris_metricas.prom"
+
+/**
+ * @brief Operações do motor medidas pela instrumentação (-DTETRIS_INSTRUMENTACAO)
+ */
+typedef enum {
+    OPERACAO_FILA_INSERIR = 0,   ///< inserirPecaNaFila e inserirPecasNaFila
+    OPERACAO_FILA_REMOVER,       ///< jogarPecaDaFila e jogarPecasDaFila
+    OPERACAO_PILHA_RESERVAR,     ///< reservarPeca
+    OPERACAO_PILHA_REMOVER,      ///< jogarPecaDaPilha
+    OPERACAO_JOGADA,             ///< processarJogadaExpert completa (pontuação, combo e nível)
+    OPERACAO_JOGADAS_LOTE,       ///< processarJogadasLote (uma medida por lote)
+    OPERACAO_COMANDO_SERVIDOR,   ///< aplicarComandoServidor
+    OPERACAO_PONTUACAO,          ///< calcularPontuacao em uma jogada (apenas contada)
+    OPERACAO_COMBO,              ///< Jogadas com combo ativo (apenas contadas)
+    OPERACAO_NIVEL,              ///< Subidas de nível (apenas contadas)
+    TOTAL_OPERACOES_INSTRUMENTADAS
+} OperacaoInstrumentada;
+
+/// Operações a partir desta são só contadas: sem leitura do relógio nem histograma
+#define PRIMEIRA_OPERACAO_CONTADA OPERACAO_PONTUACAO
+
+#ifdef TETRIS_INSTRUMENTACAO
+/// Uma a cada tantas chamadas de cada operação é cronometrada (1 = todas)
+#ifndef INTERVALO_AMOSTRAGEM_INSTRUMENTACAO
+#define INTERVALO_AMOSTRAGEM_INSTRUMENTACAO 64
+#endif
+
+/// Subfaixas por potência de dois nos histogramas (erro relativo de até 12,5%)
+#define SUBFAIXAS_HISTOGRAMA 8
+
+/// Faixas que cobrem todos os valores de 64 bits: 8 exatas e 8 por expoente de 3 a 63
+#define FAIXAS_HISTOGRAMA (SUBFAIXAS_HISTOGRAMA * 62)
+
+/**
+ * @brief Histograma de latências em escala log-linear (estilo HDR)
+ * 
+ * Cada potência de dois é dividida em SUBFAIXAS_HISTOGRAMA faixas iguais,
+ * de modo que a precisão relativa é a mesma de 10 ns a vários segundos.
+ * Os valores são tiques do relógio da instrumentação. Todas as chamadas
+ * são contadas, mas só as amostradas entram na soma, no máximo e nas faixas.
+ */
+typedef struct {
+    uint64_t chamadas;           ///< Operações registradas
+    uint64_t amostras;           ///< Operações cronometradas
+    uint64_t somaTiques;         ///< Soma das durações amostradas
+    uint64_t maximoTiques;       ///< Maior duração amostrada
+    uint32_t ateAmostra;         ///< Chamadas restantes até a próxima amostra
+    uint64_t faixas[FAIXAS_HISTOGRAMA]; ///< Contagem por faixa
+} HistogramaLatencia;
+
+/**
+ * @brief Contadores de uma thread, escritos apenas por ela
+ * 
+ * Criados no primeiro registro da thread e nunca liberados, para que o
+ * despejo inclua também threads que já terminaram.
+ */
+typedef struct InstrumentacaoThread {
+    HistogramaLatencia operacoes[TOTAL_OPERACOES_INSTRUMENTADAS]; ///< Um histograma por operação
+    struct InstrumentacaoThread* proxima; ///< Lista de todas as threads instrumentadas
+    int indice;                  ///< Ordem de criação (rótulo thread nas métricas)
+} InstrumentacaoThread;
+#endif
+
+/// Versão atual do formato de snapshot
+#define VERSAO_SNAPSHOT 2
+
+/// Arquivo usado pelas opções de salvar/carregar do menu
+#define ARQUIVO_SNAPSHOT_PADRAO "tetris_snapshot.bin"
+
+/**
+ * @brief Retrato binário de layout fixo do estado completo de um jogo
+ * 
+ * Contém as próprias estruturas do jogo, de modo que salvar e carregar são
+ * uma única escrita/leitura de sizeof(SnapshotJogo) bytes, com custo
+ * constante independente da duração da sessão. As capacidades de
+ * compilação são gravadas para recusar snapshots de outra configuração, e
+ * a soma de verificação (FNV-1a de 32 bits sobre todos os bytes
+ * anteriores) detecta arquivos truncados ou corrompidos.
+ */
+typedef struct {
+    char magica[4];              ///< Sempre "TSNP"
+    uint16_t versao;             ///< VERSAO_SNAPSHOT
+    uint16_t reservado;          ///< Sempre zero
+    uint32_t tamanho;            ///< sizeof(SnapshotJogo)
+    uint32_t capacidadeFila;     ///< CAPACIDADE_FILA de quem gravou
+    uint32_t capacidadePilha;    ///< CAPACIDADE_PILHA de quem gravou
+    int32_t proximoId;           ///< Próximo ID de peça
+    FilaCircular fila;           ///< Fila de peças futuras
+    PilhaReserva pilha;          ///< Pilha de reserva
+    SistemaExpert sistema;       ///< Pontuação e estatísticas
+    GeradorPecas gerador;        ///< Estado do gerador (a sequência continua igual)
+    uint32_t somaVerificacao;    ///< FNV-1a dos bytes anteriores a este campo
+} SnapshotJogo;
+
+/// Níveis máximos da skip list do ranking (suficiente para milhões de recordes)
+#define NIVEIS_RANKING 16
+
+/// Recordes mantidos por um ranking criado sem capacidade explícita
+#define CAPACIDADE_RANKING_PADRAO 16384
+
+/// Versão atual do formato do arquivo de ranking
+#define VERSAO_RANKING 1
+
+/**
+ * @brief Recorde de uma partida, como gravado no ranking
+ */
+typedef struct {
+    int32_t pontuacao;           ///< Pontuação final
+    int32_t nivel;               ///< Nível alcançado
+    int32_t melhorCombo;         ///< Maior combo da partida
+    int32_t totalJogadas;        ///< Peças jogadas
+    uint64_t sequencia;          ///< Ordem de inserção (no empate, o mais antigo fica à frente)
+    int64_t registradoEm;        ///< Instante do registro (time)
+} RegistroRecorde;
+
+/**
+ * @brief Nó da skip list do ranking, armazenado diretamente no arquivo
+ * 
+ * Os ponteiros são índices de nós (0 = cabeça/fim), válidos em qualquer
+ * endereço de mapeamento. salto[i] é quantas posições proximo[i] avança,
+ * o que permite calcular a posição de uma pontuação em O(log n).
+ */
+typedef struct {
+    RegistroRecorde registro;    ///< Dados do recorde
+    uint32_t proximo[NIVEIS_RANKING]; ///< Próximo nó em cada nível
+    uint32_t salto[NIVEIS_RANKING];   ///< Posições avançadas em cada nível
+} NoRanking;
+
+/**
+ * @brief Cabeçalho do arquivo de ranking (seguido de capacidade+1 nós)
+ */
+typedef struct {
+    char magica[4];              ///< Sempre "TRNK"
+    uint32_t versao;             ///< VERSAO_RANKING
+    uint32_t capacidade;         ///< Recordes mantidos (os piores são descartados)
+    uint32_t quantidade;         ///< Recordes atualmente no ranking
+    uint32_t niveis;             ///< Níveis em uso na skip list (1 a NIVEIS_RANKING)
+    int32_t menorPontuacao;      ///< Pontuação do último colocado (válida com o ranking cheio)
+    uint64_t sequencia;          ///< Próximo número de sequência
+    uint64_t estadoAleatorio;    ///< Estado do sorteio de níveis (xorshift64)
+} CabecalhoRanking;
+
+/**
+ * @brief Modo da trava de registro sobre o arquivo do ranking
+ */
+typedef enum {
+    TRAVA_RANKING_LIVRE = 0,         ///< Libera a trava
+    TRAVA_RANKING_COMPARTILHADA,     ///< Leitura (vários processos ao mesmo tempo)
+    TRAVA_RANKING_EXCLUSIVA          ///< Escrita (um processo por vez)
+} ModoTravaRanking;
+
+/**
+ * @brief Ranking persistente de recordes aberto em memória
+ * 
+ * O arquivo é mapeado com MAP_SHARED: as alterações vão para o disco sem
+ * serialização explícita (sem mmap, ele é lido ao abrir e regravado ao
+ * fechar). Threads do mesmo processo são serializadas pelo mutex e
+ * processos diferentes pela trava de registro POSIX (fcntl) sobre o
+ * arquivo inteiro, exclusiva para inserir e compartilhada para ler; o
+ * sistema a libera se o processo terminar com ela tomada. Pontuações que
+ * não entrariam em um ranking cheio são descartadas antes de tomá-las.
+ */
+typedef struct {
+    CabecalhoRanking* cabecalho; ///< Início do mapeamento
+    NoRanking* nos;              ///< Nós (índice 0 = cabeça da skip list)
+    size_t tamanhoMapeado;       ///< Bytes mapeados
+    int descritor;               ///< Descritor do arquivo (-1 sem mmap)
+    const char* caminho;         ///< Caminho do arquivo (regravação sem mmap)
+    pthread_mutex_t trava;       ///< Serializa as threads deste processo
+} RankingRecordes;
+
+/**
+ * @brief Lote de sistemas Expert em estrutura de vetores (uma coluna por campo)
+ * 
+ * Guarda o estado de muitas sessões lado a lado para que uma única chamada
+ * pontue todas com instruções SIMD. Os campos char do SistemaExpert são
+ * armazenados como int32 para que todas as colunas tenham a mesma largura.
+ * Todas as colunas vivem em um único bloco alinhado a 64 bytes.
+ */
+typedef struct {
+    void* bloco;                 ///< Bloco único de memória das colunas
+    int capacidade;              ///< Sessões alocadas (múltiplo de 8)
+    int quantidade;              ///< Sessões em uso
+    int32_t* pontuacaoTotal;
+    int32_t* pontuacaoNivel;
+    int32_t* pontosUltimaJogada;
+    int32_t* comboAtual;
+    int32_t* melhorCombo;
+    int32_t* totalCombos;
+    int32_t* ultimoTipoJogado;
+    int32_t* sequenciaTipoAtual;
+    int32_t* nivelAtual;
+    int32_t* pontosParaProximoNivel;
+    int32_t* limitePontosNivel;
+    int32_t* totalJogadas;
+    int32_t* jogadasDaFila;
+    int32_t* jogadasDaPilha;
+    int32_t* pecasReservadas;
+    int32_t* eficienciaReserva;
+    int32_t* indiceMaisJogado;   ///< TipoPeca do tipo mais jogado (índice denso)
+    int32_t* conquistasDesbloqueadas;
+    int32_t* marcosAlcancados;
+    int32_t* recordePessoal;
+    int32_t* pontosPorTipo;      ///< Cache de pontos por tipo, em [tipo * capacidade + sessão]
+    int32_t* contagemPorTipo;    ///< Peças jogadas por tipo, em [tipo * capacidade + sessão]
+    double* multiplicadorAtual;
+    double* fatorDificuldade;
+    int32_t* entradaTipo;        ///< Caractere da peça de cada sessão nesta jogada
+    int32_t* entradaIndice;      ///< Índice denso da peça de cada sessão nesta jogada
+    int32_t* entradaOrigem;      ///< Origem da peça (0=fila, 1=pilha)
+    int32_t* progressaoPendente; ///< 1 se a sessão subiu de nível ou tem conquista pendente
+} LoteSistemasExpert;
+
+/**
+ * @brief Assinatura dos kernels de pontuação em lote (escalar, SSE4.1, AVX2)
+ * 
+ * Retornam diferente de zero se alguma sessão de [inicio, fim) ficou com
+ * progressão pendente.
+ */
+typedef int (*KernelLote)(LoteSistemasExpert* lotePtr, int inicio, int fim);
+
+/// Níveis cobertos pela tabela de limites das regras de balanceamento
+#define NIVEIS_BALANCEAMENTO 64
+
+/// Faixas dos histogramas de combo do analisador (a última acumula os maiores)
+#define FAIXAS_COMBO_BALANCEAMENTO 32
+
+/// Faixas do histograma de pontuação final exibido pelo analisador
+#define FAIXAS_PONTUACAO_BALANCEAMENTO 12
+
+/// Partidas simuladas por padrão no modo --balanceamento
+#define PARTIDAS_BALANCEAMENTO_PADRAO 100000
+
+/**
+ * @brief Constantes de pontuação avaliadas pelo analisador de balanceamento
+ * 
+ * Os valores padrão são os do motor (pontuacaoBasePorTipo, combo de 0.2x
+ * por repetição e limites 1000 * 1.5^(nível - 1)); os incrementos de
+ * dificuldade e de multiplicador por nível seguem os de aplicarProgressaoNivel.
+ */
+typedef struct {
+    int pontosBase[TOTAL_TIPOS_PECA];   ///< Pontuação base por tipo, indexada por TipoPeca
+    double passoCombo;                  ///< Acréscimo ao multiplicador por repetição a partir da terceira peça igual
+    double crescimentoNivel;            ///< Razão entre os limites de dois níveis consecutivos
+    int limiteInicial;                  ///< Pontos para concluir o nível 1
+    int limites[NIVEIS_BALANCEAMENTO];  ///< Limite de cada nível (preenchido por prepararRegrasPontuacao)
+    int padrao;                         ///< 1 se as regras coincidem com as do motor
+} RegrasPontuacao;
+
+/**
+ * @brief Pontuação de uma partida segundo RegrasPontuacao
+ * 
+ * Acompanha a partida jogada pelo motor, recebendo as mesmas peças na
+ * mesma ordem, mas pontuando-as com as regras em avaliação.
+ */
+typedef struct {
+    long long pontuacao;                  ///< Pontuação acumulada (saturada em LLONG_MAX)
+    int nivel;                            ///< Nível atual (a partir de 1)
+    int limite;                           ///< Pontos para concluir o nível atual
+    double multiplicador;                 ///< Multiplicador base do nível
+    double dificuldade;                   ///< Fator de dificuldade do nível
+    int pontosPorTipo[TOTAL_TIPOS_PECA];  ///< Pontos por tipo no nível atual
+    char ultimoTipo;                      ///< Tipo da última peça jogada
+    int sequencia;                        ///< Peças iguais consecutivas
+    int melhorCombo;                      ///< Maior combo da partida
+} EstadoBalanceamento;
+
+/**
+ * @brief Políticas de decisão disponíveis para a simulação headless
+ * 
+ * A política define qual ação do menu é executada a cada passo quando
+ * o jogo roda sem interação do usuário.
+ */
+typedef enum {
+    POLITICA_ROTEIRO = 0,   ///< Repete ciclicamente um roteiro de ações ("1", "2", "3", "4")
+    POLITICA_ALEATORIA,     ///< Sorteia ações válidas a cada passo
+    POLITICA_GULOSA,        ///< Prioriza peças que prolongam a sequência atual (combos)
+    POLITICA_CONSELHEIRO    ///< Segue o conselheiro de jogadas (busca expectimax)
+} PoliticaSimulacao;
+
+/**
+ * @brief Parâmetros de uma execução da simulação headless
+ * 
+ * As ações do roteiro usam a mesma numeração do menu interativo:
+ * 1 = jogar da fila, 2 = jogar da pilha, 3 = reservar, 4 = gerar peças.
+ */
+typedef struct {
+    long long totalPartidas;     ///< Quantidade de partidas independentes
+    int jogadasPorPartida;       ///< Peças jogadas (pontuadas) por partida
+    PoliticaSimulacao politica;  ///< Política usada para escolher as ações
+    const char* roteiro;         ///< Sequência de ações para POLITICA_ROTEIRO
+    unsigned int semente;        ///< Semente base; cada partida deriva a sua
+    ModoGeradorPecas modoGerador; ///< Modo de sorteio das peças
+    int threads;                 ///< Threads de trabalho (1 = serial)
+    const char* arquivoLog;      ///< Arquivo do log de jogadas (NULL = não gravar)
+    LogJogadas* log;             ///< Log aberto a partir de arquivoLog (exige 1 thread)
+    const char* arquivoRanking;  ///< Ranking que recebe o resultado de cada partida (NULL = nenhum)
+    RankingRecordes* ranking;    ///< Ranking aberto a partir de arquivoRanking
+    int profundidadeConselheiro; ///< Jogadas examinadas à frente por POLITICA_CONSELHEIRO
+    long long orcamentoNosConselheiro; ///< Estados por decisão de POLITICA_CONSELHEIRO (0 = sem limite)
+    int usarTabuleiro;           ///< 1 = cada partida coloca as peças em um poço (bônus por linhas)
+    const char* arquivoMetricas; ///< Métricas da instrumentação gravadas ao final (NULL = não despejar)
+    const RegrasPontuacao* regras; ///< Regras pontuadas em paralelo ao motor (NULL = sem análise de balanceamento)
+    long long* pontuacoesBalanceamento; ///< Pontuação final de cada partida segundo regras (índice = partida)
+} ConfiguracaoSimulacao;
+
+/**
+ * @brief Resultado agregado de uma simulação headless
+ */
+typedef struct {
+    long long partidas;          ///< Partidas concluídas
+    long long totalJogadas;      ///< Peças jogadas em todas as partidas
+    long long jogadasDaFila;     ///< Peças jogadas diretamente da fila
+    long long jogadasDaPilha;    ///< Peças jogadas da pilha de reserva
+    long long reservas;          ///< Transferências da fila para a pilha
+    long long reabastecimentos;  ///< Gerações de novas peças na fila
+    long long acoesInvalidas;    ///< Ações ignoradas por estrutura vazia/cheia
+    long long pontuacaoSomada;   ///< Soma das pontuações finais
+    double pontuacaoSomaQuadrados; ///< Soma dos quadrados (para o desvio padrão)
+    int melhorPontuacao;         ///< Maior pontuação final de uma partida
+    int piorPontuacao;           ///< Menor pontuação final de uma partida
+    int maiorNivel;              ///< Maior nível alcançado
+    int melhorCombo;             ///< Maior combo alcançado
+    long long linhasRemovidas;   ///< Linhas completadas nos poços (com usarTabuleiro)
+    long long derrotas;          ///< Poços esvaziados por falta de espaço (com usarTabuleiro)
+    double segundos;             ///< Tempo de relógio da simulação
+    // Preenchidos apenas quando a configuração traz regras de balanceamento
+    long long partidasPorNivel[NIVEIS_BALANCEAMENTO + 1];           ///< Partidas por nível final (índice = nível)
+    long long jogadasPorCombo[FAIXAS_COMBO_BALANCEAMENTO];          ///< Jogadas por combo vigente na jogada
+    long long partidasPorMelhorCombo[FAIXAS_COMBO_BALANCEAMENTO];   ///< Partidas por melhor combo
+    long long divergencias;      ///< Partidas em que as regras padrão não reproduziram o motor
+} ResultadoSimulacao;
+
+/**
+ * @brief Totais da reprodução de um log de jogadas (--replay)
+ */
+typedef struct {
+    long long sessoes;           ///< Sessões reproduzidas
+    long long registros;         ///< Registros lidos do log
+    long long jogadas;           ///< Registros EVENTO_JOGADA pontuados
+    long long registrosInvalidos; ///< Registros com evento desconhecido
+    long long bytesIgnorados;    ///< Bytes de um registro final incompleto
+    long long pontuacaoSomada;   ///< Soma das pontuações finais
+    int melhorPontuacao;         ///< Maior pontuação final de uma sessão
+    int piorPontuacao;           ///< Menor pontuação final de uma sessão
+    double segundos;             ///< Tempo da reprodução
+} ResultadoReplay;
+
+/**
+ * @brief Deque de tarefas de uma thread do pool com roubo de trabalho
+ * 
+ * As tarefas são blocos consecutivos de partidas no intervalo [inicio, fim).
+ * A thread dona consome pelo fim (LIFO) e as threads ociosas roubam metade
+ * do intervalo restante pelo início.
+ */
+typedef struct {
+    pthread_mutex_t trava;       ///< Protege inicio/fim
+    long long inicio;            ///< Primeiro bloco ainda não consumido
+    long long fim;               ///< Uma posição após o último bloco
+} FilaTarefas;
+
+/**
+ * @brief Estado compartilhado do pool de simulação paralela
+ */
+typedef struct {
+    const ConfiguracaoSimulacao* configPtr;  ///< Configuração da simulação
+    FilaTarefas* tarefas;                    ///< Um deque por thread
+    ResultadoSimulacao* parciais;            ///< Um resultado parcial por thread
+    int totalThreads;                        ///< Quantidade de threads
+    long long totalBlocos;                   ///< Quantidade de blocos de partidas
+} PoolSimulacao;
+
+/**
+ * @brief Argumento entregue a cada thread do pool
+ */
+typedef struct {
+    PoolSimulacao* poolPtr;      ///< Pool compartilhado
+    int indice;                  ///< Índice da thread no pool
+} TrabalhadorSimulacao;
+
+/**
+ * @brief Distribuições de peças usadas nos microbenchmarks
+ */
+typedef enum {
+    DISTRIBUICAO_UNIFORME = 0,  ///< Sete tipos com a mesma probabilidade
+    DISTRIBUICAO_UNICA,         ///< Sempre 'I' (sequências e combos máximos)
+    DISTRIBUICAO_ALTERNADA,     ///< 'I' e 'O' alternados (nenhum combo)
+    DISTRIBUICAO_ENVIESADA,     ///< 50% 'I', restante dividido entre os demais tipos
+    TOTAL_DISTRIBUICOES
+} DistribuicaoPecas;
+
+/**
+ * @brief Parâmetros de uma execução dos microbenchmarks
+ */
+typedef struct {
+    int amostras;                ///< Amostras cronometradas por medição
+    int operacoesPorAmostra;     ///< Operações executadas em cada amostra
+    const char* arquivoSaida;    ///< Arquivo JSON com os resultados
+    const char* rotulo;          ///< Identificação da revisão medida
+    unsigned int semente;        ///< Semente usada para gerar as distribuições
+} ConfiguracaoBenchmark;
+
+/**
+ * @brief Estatísticas de uma medição (operação x distribuição)
+ * 
+ * Todos os tempos são em nanossegundos por operação; os percentis são
+ * calculados sobre as amostras.
+ */
+typedef struct {
+    const char* operacao;        ///< Nome da operação medida
+    const char* distribuicao;    ///< Nome da distribuição de peças
+    double media;                ///< Média de ns/op entre as amostras
+    double minimo;               ///< Menor ns/op observado
+    double p50;                  ///< Mediana de ns/op
+    double p90;                  ///< Percentil 90 de ns/op
+    double p99;                  ///< Percentil 99 de ns/op
+    double maximo;               ///< Maior ns/op observado
+    double operacoesPorSegundo;  ///< Vazão derivada da média
+} ResultadoBenchmark;
+
+/**
+ * @brief Assinatura das funções cronometradas pelo benchmark
+ * @param tipos Sequência de tipos de peça da distribuição
+ * @param quantidade Número de operações a executar
+ * @return Tempo gasto em nanossegundos
+ */
+typedef double (*FuncaoBenchmark)(const char* tipos, int quantidade);
+
+/// Linhas do quadro de terminal (cabe em um terminal padrão 80x24)
+#define LINHAS_QUADRO 24
+
+/// Colunas do quadro de terminal
+#define COLUNAS_QUADRO 80
+
+/// Células iguais toleradas dentro de um trecho alterado (mais barato que reposicionar o cursor)
+#define INTERVALO_FUSAO_QUADRO 6
+
+/// Capacidade do buffer de saída de um quadro (pior caso: todas as células e um trecho a cada 7)
+#define CAPACIDADE_SAIDA_QUADRO 8192
+
+/**
+ * @brief Quadro de terminal com o quadro anterior para renderização diferencial
+ * 
+ * O quadro é composto linha a linha em memória. apresentarQuadroTerminal
+ * compara com o quadro anterior e emite apenas os trechos alterados, como
+ * posicionamentos de cursor ANSI seguidos do texto, em uma única chamada a
+ * write. emitirQuadroTerminal emite as linhas compostas em sequência, para
+ * as telas do menu, que rolam em vez de serem redesenhadas.
+ */
+typedef struct {
+    char celulas[LINHAS_QUADRO][COLUNAS_QUADRO];   ///< Quadro em composição
+    char anteriores[LINHAS_QUADRO][COLUNAS_QUADRO]; ///< Último quadro apresentado
+    int comprimentos[LINHAS_QUADRO]; ///< Caracteres escritos em cada linha
+    int linhaAtual;              ///< Próxima linha a ser escrita
+    int anteriorValido;          ///< 0 = o próximo quadro limpa a tela e é desenhado por inteiro
+    char saida[CAPACIDADE_SAIDA_QUADRO]; ///< Sequência emitida no último quadro
+    double inicioNs;             ///< Início da composição do quadro atual
+    long long quadros;           ///< Quadros apresentados
+    long long bytes;             ///< Bytes emitidos
+    long long celulasAlteradas;  ///< Células que mudaram entre quadros
+    int ultimosBytes;            ///< Bytes emitidos no último quadro
+    double ultimoNs;             ///< Tempo do último quadro (composição, diferença e write)
+    double somaNs;               ///< Soma dos tempos de quadro
+    double maiorNs;              ///< Maior tempo de quadro
+} QuadroTerminal;
+
+/// Duração do passo fixo do jogo em tempo real (ms)
+#define PASSO_TEMPO_REAL_MS 10
+
+/// Passos entre quedas automáticas no nível 1 (1 segundo)
+#define PASSOS_QUEDA_INICIAL 100
+
+/// Menor intervalo entre quedas automáticas, em passos (100 ms)
+#define PASSOS_QUEDA_MINIMO 10
+
+/// Passos atrasados recuperados de uma vez antes de descartar o atraso
+#define PASSOS_ATRASADOS_MAXIMO 5
+
+/// Latência entrada -> estado tolerada no jogo em tempo real (ns)
+#define LIMITE_LATENCIA_TEMPO_REAL_NS 1000000.0
+
+/// Bytes lidos do terminal a cada despertar do laço de eventos
+#define TECLAS_POR_LEITURA 64
+
+/**
+ * @brief Latência entre a chegada de uma tecla e a aplicação da ação no estado
+ */
+typedef struct {
+    long long teclas;            ///< Teclas processadas
+    long long acimaLimite;       ///< Teclas acima de LIMITE_LATENCIA_TEMPO_REAL_NS
+    double somaNs;               ///< Soma das latências
+    double maiorNs;              ///< Maior latência observada
+} MetricasLatencia;
+
+/**
+ * @brief Estado do jogo em tempo real (laço de eventos com gravidade)
+ */
+typedef struct {
+    SessaoJogo sessao;           ///< Fila, pilha, pontuação e gerador da partida
+    TabuleiroJogo tabuleiro;     ///< Poço onde as peças jogadas caem
+    CacheColocacoes cache;       ///< Colocações já enumeradas (entradas NULL se não alocado)
+    int passosAteQueda;          ///< Passos restantes até a próxima queda automática
+    int pausado;                 ///< 1 enquanto a gravidade está suspensa
+    int encerrado;               ///< 1 quando o jogador pediu para sair
+    int alterado;                ///< 1 se o estado mudou desde o último quadro
+    char mensagem[64];           ///< Mensagem exibida no rodapé do quadro
+    long long passos;            ///< Passos fixos executados
+    long long quedas;            ///< Peças jogadas pela gravidade
+    MetricasLatencia latencia;   ///< Latência entrada -> estado
+    QuadroTerminal quadro;       ///< Renderizador diferencial da tela
+} JogoTempoReal;
+
+/// Caminho padrão do socket Unix do servidor multijogador
+#define SOCKET_SERVIDOR_PADRAO "/tmp/tetris.sock"
+
+/// Respostas acumuladas por conexão antes de parar de ler comandos
+#define RESPOSTAS_PENDENTES_CONEXAO 64
+
+/// Eventos tratados por chamada a epoll_wait
+#define EVENTOS_POR_ESPERA 256
+
+/// Meta de latência p99 verificada pelo gerador de carga (ns)
+#define LIMITE_P99_SERVIDOR_NS 100000.0
+
+/// Valor de RespostaServidor.aplicado para comandos desconhecidos
+#define COMANDO_DESCONHECIDO 0xFF
+
+/**
+ * @brief Comandos do protocolo binário do servidor (um byte cada)
+ * 
+ * De 1 a 4 usam a mesma numeração do menu interativo e de
+ * executarAcaoHeadless; 5 apenas consulta o estado da sessão.
+ */
+typedef enum {
+    COMANDO_JOGAR_FILA = 1,      ///< Jogar a peça da frente da fila
+    COMANDO_JOGAR_PILHA = 2,     ///< Jogar a peça do topo da pilha
+    COMANDO_RESERVAR = 3,        ///< Mover a peça da frente da fila para a pilha
+    COMANDO_GERAR = 4,           ///< Reabastecer a fila
+    COMANDO_ESTATISTICAS = 5     ///< Consultar pontuação e estado
+} ComandoServidor;
+
+/**
+ * @brief Resposta de tamanho fixo (16 bytes) a cada comando
+ * 
+ * Os campos usam a ordem de bytes da máquina: cliente e servidor rodam
+ * no mesmo host (socket Unix ou TCP local).
+ */
+typedef struct {
+    uint8_t comando;             ///< Comando respondido
+    uint8_t aplicado;            ///< 1 = aplicado, 0 = ignorado (vazia/cheia), COMANDO_DESCONHECIDO
+    uint8_t pecasFila;           ///< Peças na fila após o comando
+    uint8_t pecasPilha;          ///< Peças na pilha após o comando
+    char ultimoTipo;             ///< Último tipo jogado (SistemaExpert.ultimoTipoJogado)
+    uint8_t nivel;               ///< Nível atual
+    uint16_t combo;              ///< Combo atual
+    int32_t pontuacao;           ///< Pontuação total da sessão
+    int32_t jogadas;             ///< Peças jogadas na sessão
+} RespostaServidor;
+
+/**
+ * @brief Conexão de um jogador: sessão própria e respostas ainda não enviadas
+ * 
+ * Ocupa um slot do pool de sessões do shard; por isso a sessão é o
+ * primeiro campo (o slot devolvido por alocarSessoesPool é a conexão).
+ */
+typedef struct ConexaoServidor {
+    SessaoJogo sessao;           ///< Fila, pilha e sistema Expert do jogador
+    int descritor;               ///< Socket do jogador
+    int pendentes;               ///< Respostas em saida ainda não enviadas por inteiro
+    int bytesEnviados;           ///< Bytes de saida já enviados
+    int aguardandoEscrita;       ///< 1 enquanto espera EPOLLOUT (leitura suspensa)
+    struct ConexaoServidor* anterior; ///< Lista de conexões do shard
+    struct ConexaoServidor* proxima;  ///< Lista de conexões do shard
+    RespostaServidor saida[RESPOSTAS_PENDENTES_CONEXAO]; ///< Respostas a enviar
+} ConexaoServidor;
+
+/**
+ * @brief Parâmetros do modo --servidor
+ */
+typedef struct {
+    const char* caminhoSocket;   ///< Socket Unix (NULL = TCP em porta)
+    int porta;                   ///< Porta TCP em 127.0.0.1
+    int shards;                  ///< Threads do reator, cada uma com seu epoll
+    unsigned int semente;        ///< Semente base; cada conexão deriva a sua
+    double duracao;              ///< Segundos até encerrar (0 = até SIGINT/SIGTERM)
+    const char* arquivoMetricas; ///< Destino das métricas em SIGUSR1 e no encerramento (NULL = stdout)
+} ConfiguracaoServidor;
+
+/**
+ * @brief Reator de um núcleo: epoll próprio e conexões aceitas por ele
+ * 
+ * Todos os shards esperam pelo mesmo socket de escuta (EPOLLEXCLUSIVE),
+ * e quem aceita a conexão a atende até o fim, sem travas entre shards.
+ */
+typedef struct {
+    int indice;                  ///< Posição do shard
+    int epoll;                   ///< Descritor epoll do shard
+    int escuta;                  ///< Socket de escuta compartilhado
+    int tcp;                     ///< 1 se as conexões são TCP (TCP_NODELAY)
+    const ConfiguracaoServidor* config; ///< Configuração do servidor
+    pthread_t thread;            ///< Thread do reator
+    ConexaoServidor* conexoes;   ///< Conexões abertas neste shard
+    PoolSessoes pool;            ///< Slots das conexões deste shard
+    long long conexoesAceitas;   ///< Conexões aceitas por este shard
+    long long ativas;            ///< Conexões abertas neste shard
+    long long maiorAtivas;       ///< Maior número de conexões simultâneas neste shard
+    long long comandos;          ///< Comandos atendidos
+    long long comandosInvalidos; ///< Comandos desconhecidos
+    char folga[64];              ///< Separa os contadores de shards vizinhos em linhas de cache
+} ShardServidor;
+
+/**
+ * @brief Parâmetros do modo --carga (gerador de carga local)
+ */
+typedef struct {
+    const char* caminhoSocket;   ///< Socket Unix do servidor (NULL = TCP em porta)
+    int porta;                   ///< Porta TCP em 127.0.0.1
+    int sessoes;                 ///< Conexões abertas simultaneamente
+    long long comandos;          ///< Comandos medidos no total
+    int emVoo;                   ///< Comandos aguardando resposta ao mesmo tempo
+    int threads;                 ///< Threads geradoras (as sessões são divididas entre elas)
+} ConfiguracaoCarga;
+
+/**
+ * @brief Sessão do gerador de carga (uma conexão ao servidor)
+ */
+typedef struct {
+    int descritor;               ///< Socket conectado
+    int recebidos;               ///< Bytes da resposta em andamento
+    int emVoo;                   ///< 1 enquanto o comando aguarda resposta
+    unsigned int passo;          ///< Posição no roteiro de comandos
+    double enviadoNs;            ///< Instante de envio do comando em voo
+    RespostaServidor resposta;   ///< Resposta em montagem
+} SessaoCarga;
+
+/**
+ * @brief Thread do gerador de carga e suas medições
+ */
+typedef struct {
+    const ConfiguracaoCarga* config; ///< Configuração da carga
+    pthread_t thread;            ///< Thread geradora
+    int emThread;                ///< 1 se a thread foi criada (0 = executada pela chamadora)
+    SessaoCarga* sessoes;        ///< Sessões desta thread
+    int quantidade;              ///< Quantidade de sessões
+    long long comandos;          ///< Comandos a medir
+    int emVoo;                   ///< Comandos em voo desta thread
+    double* latencias;           ///< Latência de cada comando (ns)
+    long long medidos;           ///< Latências registradas
+    long long respostasInvalidas; ///< Respostas a comandos desconhecidos
+    int falhou;                  ///< 1 se a conexão caiu ou o servidor parou de responder
+} TrabalhadorCarga;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              PROTÓTIPOS DAS FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+// Funções da Fila Circular
+void inicializarFila(FilaCircular* filaPtr);
+int filaVazia(FilaCircular* filaPtr);
+int filaCheia(FilaCircular* filaPtr);
+void inserirPecaNaFila(FilaCircular* filaPtr, Peca novaPeca);
+Peca jogarPecaDaFila(FilaCircular* filaPtr);
+int inserirPecasNaFila(FilaCircular* filaPtr, const Peca* pecas, int quantidade);
+int jogarPecasDaFila(FilaCircular* filaPtr, Peca* destino, int quantidade);
+int espiarPecasDaFila(const FilaCircular* filaPtr, Peca* destino, int quantidade);
+void exibirFila(FilaCircular* filaPtr);
+
+// Funções da Pilha de Reserva
+void inicializarPilha(PilhaReserva* pilhaPtr);
+int pilhaVazia(PilhaReserva* pilhaPtr);
+int pilhaCheia(PilhaReserva* pilhaPtr);
+void reservarPeca(PilhaReserva* pilhaPtr, Peca peca);
+Peca jogarPecaDaPilha(PilhaReserva* pilhaPtr);
+void exibirPilha(PilhaReserva* pilhaPtr);
+
+// Funções do Sistema Expert
+void inicializarSistemaExpert(SistemaExpert* sistemaPtr);
+TipoPeca indiceTipoPeca(char tipoPeca);
+void atualizarTabelaPontuacao(SistemaExpert* sistemaPtr);
+int calcularPontuacao(char tipoPeca, SistemaExpert* sistemaPtr);
+double detectarCombo(SistemaExpert* sistemaPtr, char tipoPeca);
+int limitePontosDoNivel(int nivel);
+int nivelParaPontuacao(int pontuacao);
+int aplicarProgressaoNivel(SistemaExpert* sistemaPtr);
+void verificarProgressaoNivel(SistemaExpert* sistemaPtr);
+void processarJogadaExpert(Peca peca, int origem, SistemaExpert* sistemaPtr);
+int consultarDistribuicaoTipos(const SistemaExpert* sistemaPtr, int contagens[7]);
+void exibirEstatisticasExpert(SistemaExpert* sistemaPtr);
+int otimizarSistemaExpert(SistemaExpert* sistemaPtr);
+void gerarRelatorioExpert(SistemaExpert* sistemaPtr);
+
+// Funções Utilitárias
+Peca criarPeca(char tipo, int id);
+PecaCompacta compactarPeca(Peca peca);
+Peca expandirPeca(PecaCompacta compacta);
+char tipoPecaCompacta(PecaCompacta compacta);
+void gerarPecasAleatorias(FilaCircular* filaPtr);
+void transferirPecaFilaParaPilha(FilaCircular* filaPtr, PilhaReserva* pilhaPtr);
+void exibirEstadoCompleto(FilaCircular* filaPtr, PilhaReserva* pilhaPtr, SistemaExpert* sistemaPtr);
+void exibirMenu();
+void pausarExecucao();
+
+// Funções do Gerador de Peças
+void inicializarGeradorPecas(GeradorPecas* geradorPtr, uint64_t semente, ModoGeradorPecas modo);
+uint32_t proximoNumeroAleatorio(GeradorPecas* geradorPtr);
+uint32_t sortearLimitado(GeradorPecas* geradorPtr, uint32_t limite);
+char sortearTipoPeca(GeradorPecas* geradorPtr);
+void preencherTiposPecas(GeradorPecas* geradorPtr, char* tipos, int quantidade);
+
+// Funções de Sessão
+void inicializarSessaoJogo(SessaoJogo* sessaoPtr, uint64_t semente, ModoGeradorPecas modo);
+void gerarPecasAleatoriasSessao(SessaoJogo* sessaoPtr);
+uint64_t derivarSemente(uint64_t sementeBase, long long indice);
+
+// Funções do Pool de Sessões
+void inicializarPoolSessoes(PoolSessoes* poolPtr, size_t tamanhoSlot);
+void liberarPoolSessoes(PoolSessoes* poolPtr);
+int alocarSessoesPool(PoolSessoes* poolPtr, SessaoJogo** destino, int quantidade, uint64_t sementeBase,
+                      long long primeiroIndice, ModoGeradorPecas modo);
+void liberarSessaoPool(PoolSessoes* poolPtr, SessaoJogo* sessaoPtr);
+void reinicializarSessoesPool(PoolSessoes* poolPtr, uint64_t sementeBase, ModoGeradorPecas modo);
+void exibirOcupacaoPool(const PoolSessoes* poolPtr);
+
+// Funções do Alimentador de Peças
+int iniciarAlimentadorPecas(AlimentadorPecas* alimentadorPtr, const GeradorPecas* geradorPtr, int proximoId);
+void pararAlimentadorPecas(AlimentadorPecas* alimentadorPtr);
+int retomarAlimentadorPecas(AlimentadorPecas* alimentadorPtr);
+void redefinirAlimentadorPecas(AlimentadorPecas* alimentadorPtr, const GeradorPecas* geradorPtr, int proximoId);
+int retirarPecasAlimentador(AlimentadorPecas* alimentadorPtr, Peca* destino, int quantidade);
+int abastecerFilaAlimentador(AlimentadorPecas* alimentadorPtr, FilaCircular* filaPtr, LogJogadas* logPtr);
+void exibirEstatisticasAlimentador(const AlimentadorPecas* alimentadorPtr);
+
+// Funções da Instrumentação
+void exibirInstrumentacao();
+int exportarInstrumentacaoPrometheus(const char* caminho);
+
+// Funções do Tabuleiro (Bitboard)
+void inicializarTabuleiro(TabuleiroJogo* tabuleiroPtr);
+int colideTabuleiro(const TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna, int linha);
+int soltarPecaTabuleiro(const TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna);
+int fixarPecaTabuleiro(TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna, int linha);
+int avaliarTabuleiro(const TabuleiroJogo* tabuleiroPtr);
+int inicializarCacheColocacoes(CacheColocacoes* cachePtr, int bits);
+void liberarCacheColocacoes(CacheColocacoes* cachePtr);
+int enumerarColocacoes(const TabuleiroJogo* tabuleiroPtr, int tipo, ColocacaoPeca colocacoes[COLOCACOES_MAXIMAS_PECA]);
+int escolherColocacao(const TabuleiroJogo* tabuleiroPtr, int tipo, ColocacaoPeca* melhorPtr);
+int posicionarPecaTabuleiro(TabuleiroJogo* tabuleiroPtr, char tipoPeca);
+int calcularPontuacaoLinhas(int linhas, const SistemaExpert* sistemaPtr);
+int processarJogadaTabuleiro(Peca peca, int origem, SistemaExpert* sistemaPtr, TabuleiroJogo* tabuleiroPtr);
+
+// Funções da Pontuação em Lote
+int inicializarLoteSistemasExpert(LoteSistemasExpert* lotePtr, int capacidade);
+void liberarLoteSistemasExpert(LoteSistemasExpert* lotePtr);
+void carregarSistemaNoLote(LoteSistemasExpert* lotePtr, int indice, const SistemaExpert* sistemaPtr);
+void extrairSistemaDoLote(const LoteSistemasExpert* lotePtr, int indice, SistemaExpert* sistemaPtr);
+void processarJogadasLote(LoteSistemasExpert* lotePtr, const Peca* pecas, const int* origens);
+const char* nomeKernelLote();
+
+// Funções do Log de Jogadas
+int abrirLogJogadas(LogJogadas* logPtr, const char* caminho);
+int descarregarLogJogadas(LogJogadas* logPtr);
+void registrarEventoLog(LogJogadas* logPtr, TipoEventoLog evento, int origem, Peca peca, int quantidade);
+void fecharLogJogadas(LogJogadas* logPtr);
+int reproduzirLogJogadas(const char* caminho, long long sessaoDetalhada, ResultadoReplay* resultadoPtr);
+void exibirResumoReplay(const char* caminho, const ResultadoReplay* resultadoPtr);
+
+// Funções de Snapshot
+void capturarSnapshotJogo(SnapshotJogo* snapshotPtr, const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr,
+                          const SistemaExpert* sistemaPtr, int proximoIdAtual, const GeradorPecas* geradorPtr);
+void capturarSnapshotSessao(SnapshotJogo* snapshotPtr, const SessaoJogo* sessaoPtr);
+void restaurarSnapshotSessao(const SnapshotJogo* snapshotPtr, SessaoJogo* sessaoPtr);
+int gravarSnapshotJogo(const char* caminho, SnapshotJogo* snapshotPtr);
+int lerSnapshotJogo(const char* caminho, SnapshotJogo* snapshotPtr);
+
+// Funções do Ranking de Recordes
+int abrirRanking(RankingRecordes* rankingPtr, const char* caminho, uint32_t capacidade);
+void fecharRanking(RankingRecordes* rankingPtr);
+int registrarRecorde(RankingRecordes* rankingPtr, const SistemaExpert* sistemaPtr);
+int posicaoNoRanking(RankingRecordes* rankingPtr, int pontuacao);
+int consultarMelhoresRecordes(RankingRecordes* rankingPtr, RegistroRecorde* destino, int quantidade);
+void exibirRanking(RankingRecordes* rankingPtr, int quantidade);
+
+// Funções do Hash Zobrist e da Tabela de Transposição
+uint64_t hashZobristEstado(const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr, const SistemaExpert* sistemaPtr);
+int inicializarTabelaTransposicao(TabelaTransposicao* tabelaPtr, int bits);
+void liberarTabelaTransposicao(TabelaTransposicao* tabelaPtr);
+int consultarTabelaTransposicao(const TabelaTransposicao* tabelaPtr, uint64_t chave, double* valorPtr);
+void gravarTabelaTransposicao(TabelaTransposicao* tabelaPtr, uint64_t chave, double valor);
+
+// Funções do Conselheiro de Jogadas
+int inicializarConselheiro(ConselheiroJogadas* conselheiroPtr, const ConfiguracaoConselheiro* configPtr);
+void liberarConselheiro(ConselheiroJogadas* conselheiroPtr);
+int aconselharJogada(ConselheiroJogadas* conselheiroPtr, const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr,
+                     const SistemaExpert* sistemaPtr, SugestaoConselheiro* sugestaoPtr);
+void exibirSugestaoConselheiro(const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr, const SugestaoConselheiro* sugestaoPtr);
+
+// Funções da Simulação Headless
+int executarAcaoHeadless(int acao, SessaoJogo* sessaoPtr);
+int escolherAcaoPolitica(const ConfiguracaoSimulacao* configPtr, SessaoJogo* sessaoPtr, long long passo);
+void simularPartidaHeadless(const ConfiguracaoSimulacao* configPtr, long long indicePartida, ResultadoSimulacao* resultadoPtr);
+void combinarResultadosSimulacao(ResultadoSimulacao* destinoPtr, const ResultadoSimulacao* origemPtr);
+void executarSimulacaoHeadless(const ConfiguracaoSimulacao* configPtr, ResultadoSimulacao* resultadoPtr);
+void* executarTrabalhadorSimulacao(void* argumento);
+void executarSimulacaoParalela(const ConfiguracaoSimulacao* configPtr, ResultadoSimulacao* resultadoPtr);
+void exibirResumoSimulacao(const ConfiguracaoSimulacao* configPtr, const ResultadoSimulacao* resultadoPtr);
+int interpretarArgumentosSimulacao(int argc, char* argv[], ConfiguracaoSimulacao* configPtr);
+
+// Funções do Analisador de Balanceamento
+void prepararRegrasPontuacao(RegrasPontuacao* regrasPtr);
+void inicializarEstadoBalanceamento(const RegrasPontuacao* regrasPtr, EstadoBalanceamento* estadoPtr);
+int aplicarJogadaBalanceamento(const RegrasPontuacao* regrasPtr, EstadoBalanceamento* estadoPtr, char tipoPeca);
+void registrarPartidaBalanceamento(const ConfiguracaoSimulacao* configPtr, long long indicePartida,
+                                   const EstadoBalanceamento* estadoPtr, const SistemaExpert* sistemaPtr,
+                                   ResultadoSimulacao* resultadoPtr);
+void intervaloWilson(long long sucessos, long long total, double* inferiorPtr, double* superiorPtr);
+void exibirAnaliseBalanceamento(const ConfiguracaoSimulacao* configPtr, const RegrasPontuacao* regrasPtr,
+                                const ResultadoSimulacao* resultadoPtr);
+int interpretarListaPontos(const char* lista, RegrasPontuacao* regrasPtr);
+int interpretarArgumentosBalanceamento(int argc, char* argv[], ConfiguracaoSimulacao* configPtr, RegrasPontuacao* regrasPtr);
+
+// Funções do Benchmark
+double obterTempoNanossegundos();
+void gerarDistribuicaoPecas(GeradorPecas* geradorPtr, DistribuicaoPecas distribuicao, char* tipos, int quantidade);
+double medirGeradorPecas(const char* tipos, int quantidade);
+double medirFilaCircular(const char* tipos, int quantidade);
+double medirFilaCircularLote(const char* tipos, int quantidade);
+double medirPilhaReserva(const char* tipos, int quantidade);
+double medirCalculoPontuacao(const char* tipos, int quantidade);
+double medirDeteccaoCombo(const char* tipos, int quantidade);
+double medirNivelParaPontuacao(const char* tipos, int quantidade);
+double medirTabuleiroSoltarFixar(const char* tipos, int quantidade);
+double medirTabuleiroColocacao(const char* tipos, int quantidade);
+double medirTabuleiroColocacaoCache(const char* tipos, int quantidade);
+double medirJogadaExpert(const char* tipos, int quantidade);
+double medirJogadaExpertLote(const char* tipos, int quantidade);
+double medirSessoesMalloc(const char* tipos, int quantidade);
+double medirSessoesPool(const char* tipos, int quantidade);
+double medirSessoesPoolLote(const char* tipos, int quantidade);
+double medirSessoesPoolReinicio(const char* tipos, int quantidade);
+int verificarSessoesPool();
+int verificarPontuacaoLote(const char* tipos, int quantidade);
+void medirOperacao(const ConfiguracaoBenchmark* configPtr, FuncaoBenchmark funcao, const char* tipos, ResultadoBenchmark* resultadoPtr);
+int executarBenchmark(const ConfiguracaoBenchmark* configPtr);
+int interpretarArgumentosBenchmark(int argc, char* argv[], ConfiguracaoBenchmark* configPtr);
+
+// Funções do Renderizador de Terminal
+void inicializarQuadroTerminal(QuadroTerminal* quadroPtr);
+void limparQuadroTerminal(QuadroTerminal* quadroPtr);
+void escreverLinhaQuadro(QuadroTerminal* quadroPtr, const char* formato, ...);
+void comporFila(QuadroTerminal* quadroPtr, const FilaCircular* filaPtr);
+void comporPilha(QuadroTerminal* quadroPtr, const PilhaReserva* pilhaPtr);
+void comporEstatisticasExpert(QuadroTerminal* quadroPtr, const SistemaExpert* sistemaPtr);
+void escreverQuadroEm(QuadroTerminal* quadroPtr, int linha, int coluna, const char* texto);
+void comporTabuleiro(QuadroTerminal* quadroPtr, const TabuleiroJogo* tabuleiroPtr, int coluna);
+int apresentarQuadroTerminal(QuadroTerminal* quadroPtr);
+int emitirQuadroTerminal(QuadroTerminal* quadroPtr);
+void encerrarQuadroTerminal(QuadroTerminal* quadroPtr);
+
+// Funções do Jogo em Tempo Real
+int passosEntreQuedas(int nivel);
+void inicializarJogoTempoReal(JogoTempoReal* jogoPtr, uint64_t semente, LogJogadas* logPtr, int usarCacheColocacoes);
+void processarTeclaTempoReal(JogoTempoReal* jogoPtr, unsigned char tecla);
+void executarPassoTempoReal(JogoTempoReal* jogoPtr);
+void registrarLatencia(MetricasLatencia* metricasPtr, double nanossegundos);
+void desenharQuadroTempoReal(JogoTempoReal* jogoPtr);
+void exibirResumoTempoReal(const JogoTempoReal* jogoPtr);
+int executarJogoTempoReal(LogJogadas* logPtr, RankingRecordes* rankingPtr, int usarCacheColocacoes);
+
+// Funções do Servidor Multijogador
+int aplicarComandoServidor(SessaoJogo* sessaoPtr, unsigned char comando, RespostaServidor* respostaPtr);
+int executarServidor(const ConfiguracaoServidor* configPtr);
+int interpretarArgumentosServidor(int argc, char* argv[], ConfiguracaoServidor* configPtr);
+int executarCarga(const ConfiguracaoCarga* configPtr);
+int interpretarArgumentosCarga(int argc, char* argv[], ConfiguracaoCarga* configPtr);
+
+// Variável global para controle de IDs sequenciais
+int proximoId = 1;
+
+// Tipos de peça na ordem usada por todos os sorteios
+const char tiposPecas[7] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
+
+// Gerador de peças do jogo interativo (semeado em main)
+GeradorPecas geradorGlobal;
+
+// Pontuação base por tipo de peça, indexada por TipoPeca
+const int pontuacaoBasePorTipo[TOTAL_TIPOS_PECA] = {
+    100,    // I: Linha reta
+    80,     // O: Quadrado
+    90,     // T
+    85,     // S
+    85,     // Z
+    75,     // J
+    75,     // L
+    50      // Peça desconhecida
+};
+
+// Limite de pontos de cada nível (índice = nível - 1): floor(1000 * 3^k / 2^k)
+// com k = nível - 1, calculado em aritmética inteira exata. Coincide com o
+// antigo (int)(1000 * pow(1.5, k)) em todos os níveis que cabem em int.
+const int limitesPontosNivel[NIVEIS_TABELADOS] = {
+    1000, 1500, 2250, 3375, 5062, 7593,
+    11390, 17085, 25628, 38443, 57665, 86497,
+    129746, 194619, 291929, 437893, 656840, 985261,
+    1477891, 2216837, 3325256, 4987885, 7481827, 11222741,
+    16834112, 25251168, 37876752, 56815128, 85222692, 127834039,
+    191751059, 287626588, 431439883, 647159824, 970739737, 1456109606
+};
+
+// Quantidade de limites menores que 2^b, indexada por b: ponto de partida de
+// nivelParaPontuacao, que a partir daí avança no máximo dois limites
+const unsigned char limitesAbaixoDaPotencia[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 6, 7, 9,
+    11, 13, 14, 16, 18, 19, 21, 23, 24, 26, 28, 30, 31, 33, 35, 36
+};
+
+// Conversão caractere -> TipoPeca. Os valores são guardados com XOR
+// PECA_DESCONHECIDA para que as posições não listadas (zero) resultem
+// em PECA_DESCONHECIDA sem nenhum desvio condicional na consulta.
+const unsigned char tabelaIndiceTipo[256] = {
+    ['I'] = PECA_I ^ PECA_DESCONHECIDA,
+    ['O'] = PECA_O ^ PECA_DESCONHECIDA,
+    ['T'] = PECA_T ^ PECA_DESCONHECIDA,
+    ['S'] = PECA_S ^ PECA_DESCONHECIDA,
+    ['Z'] = PECA_Z ^ PECA_DESCONHECIDA,
+    ['J'] = PECA_J ^ PECA_DESCONHECIDA,
+    ['L'] = PECA_L ^ PECA_DESCONHECIDA
+};
+
+// Conversão TipoPeca -> caractere (inversa de tabelaIndiceTipo; 'X' = peça vazia)
+const char caracterePorTipo[TOTAL_TIPOS_PECA] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L', 'X'};
+
+// Chaves Zobrist por TipoPeca: peças da fila, peças da pilha e último tipo jogado
+const uint64_t zobristFila[TOTAL_TIPOS_PECA] = {
+    0x138A5B5EF614BC05ULL, 0xAFE51ED1DF170D3FULL, 0xE03708E4B64B18ECULL, 0x371D1CB69A3B9012ULL,
+    0x64A009D169DBF780ULL, 0x59CFE813E64B6E7AULL, 0x3FA9AE0FAE142CD7ULL, 0xBE7C04814DC00B6EULL
+};
+const uint64_t zobristPilha[TOTAL_TIPOS_PECA] = {
+    0x7CCB586F7D0E1E84ULL, 0xE6D7522DE8468E59ULL, 0xC27BA7EE69413425ULL, 0xE2C089A3690275F1ULL,
+    0xA347B7CB512F570CULL, 0x4DF325B8E3C12E90ULL, 0x58C01565E44EF040ULL, 0x8132C38D379F02D3ULL
+};
+const uint64_t zobristUltimoTipo[TOTAL_TIPOS_PECA] = {
+    0x959591E8F6E87586ULL, 0x68FBF2AE69DBF535ULL, 0xB5264ACEE56EF297ULL, 0xC429ECBA1E890573ULL,
+    0x6041115FC1AFEC87ULL, 0x0276811BFF486340ULL, 0x20AE3A6FAAE5F5D8ULL, 0xE26E8FBC7EBAD745ULL
+};
+
+// Formas das peças no poço por TipoPeca e rotação: uma máscara por linha, da
+// base para o topo, com o bloco mais à esquerda no bit 0
+const uint16_t linhasPecaTabuleiro[PECA_DESCONHECIDA][ROTACOES_PECA][4] = {
+    {{0xF},       {1, 1, 1, 1}, {0xF},       {1, 1, 1, 1}},  // I
+    {{3, 3},      {3, 3},       {3, 3},      {3, 3}},        // O
+    {{7, 2},      {1, 3, 1},    {2, 7},      {2, 3, 2}},     // T
+    {{3, 6},      {2, 3, 1},    {3, 6},      {2, 3, 1}},     // S
+    {{6, 3},      {1, 3, 2},    {6, 3},      {1, 3, 2}},     // Z
+    {{7, 1},      {3, 1, 1},    {4, 7},      {2, 2, 3}},     // J
+    {{7, 4},      {1, 1, 3},    {1, 7},      {3, 2, 2}}      // L
+};
+const unsigned char larguraPecaTabuleiro[PECA_DESCONHECIDA][ROTACOES_PECA] = {
+    {4, 1, 4, 1}, {2, 2, 2, 2}, {3, 2, 3, 2}, {3, 2, 3, 2}, {3, 2, 3, 2}, {3, 2, 3, 2}, {3, 2, 3, 2}
+};
+const unsigned char alturaPecaTabuleiro[PECA_DESCONHECIDA][ROTACOES_PECA] = {
+    {1, 4, 1, 4}, {2, 2, 2, 2}, {2, 3, 2, 3}, {2, 3, 2, 3}, {2, 3, 2, 3}, {2, 3, 2, 3}, {2, 3, 2, 3}
+};
+
+// Perfil de cada rotação por coluna da peça: linha do bloco mais baixo e
+// altura do bloco mais alto + 1, ambas relativas à base da peça
+const unsigned char fundoPecaTabuleiro[PECA_DESCONHECIDA][ROTACOES_PECA][4] = {
+    {{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}},  // I
+    {{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}},  // O
+    {{0, 0, 0, 0}, {0, 1, 0, 0}, {1, 0, 1, 0}, {1, 0, 0, 0}},  // T
+    {{0, 0, 1, 0}, {1, 0, 0, 0}, {0, 0, 1, 0}, {1, 0, 0, 0}},  // S
+    {{1, 0, 0, 0}, {0, 1, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}},  // Z
+    {{0, 0, 0, 0}, {0, 0, 0, 0}, {1, 1, 0, 0}, {2, 0, 0, 0}},  // J
+    {{0, 0, 0, 0}, {0, 2, 0, 0}, {0, 1, 1, 0}, {0, 0, 0, 0}}   // L
+};
+const unsigned char topoPecaTabuleiro[PECA_DESCONHECIDA][ROTACOES_PECA][4] = {
+    {{1, 1, 1, 1}, {4, 0, 0, 0}, {1, 1, 1, 1}, {4, 0, 0, 0}},  // I
+    {{2, 2, 0, 0}, {2, 2, 0, 0}, {2, 2, 0, 0}, {2, 2, 0, 0}},  // O
+    {{1, 2, 1, 0}, {3, 2, 0, 0}, {2, 2, 2, 0}, {2, 3, 0, 0}},  // T
+    {{1, 2, 2, 0}, {3, 2, 0, 0}, {1, 2, 2, 0}, {3, 2, 0, 0}},  // S
+    {{2, 2, 1, 0}, {2, 3, 0, 0}, {2, 2, 1, 0}, {2, 3, 0, 0}},  // Z
+    {{2, 1, 1, 0}, {3, 1, 0, 0}, {2, 2, 2, 0}, {3, 3, 0, 0}},  // J
+    {{1, 1, 2, 0}, {3, 3, 0, 0}, {2, 2, 2, 0}, {1, 3, 0, 0}}   // L
+};
+
+// Rotações distintas por TipoPeca (as demais repetem a forma)
+const unsigned char rotacoesDistintasPeca[PECA_DESCONHECIDA] = {2, 1, 4, 2, 2, 4, 4};
+
+// Bônus base por linhas completadas de uma vez (0 a 4)
+const int bonusBasePorLinhas[5] = {0, 100, 300, 500, 800};
+
+// Variável global que suprime as mensagens de jogo (usada pela simulação headless)
+int modoSilencioso = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                          INSTRUMENTAÇÃO DO MOTOR
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#ifdef TETRIS_INSTRUMENTACAO
+
+#if defined(__GNUC__)
+#define LOCAL_DA_THREAD __thread
+#else
+#define LOCAL_DA_THREAD _Thread_local
+#endif
+
+/// Contadores da thread atual (NULL até o primeiro registro)
+static LOCAL_DA_THREAD InstrumentacaoThread* instrumentacaoLocal = NULL;
+
+/// Todas as threads instrumentadas, da mais recente para a mais antiga
+static InstrumentacaoThread* blocosInstrumentacao = NULL;
+static int totalBlocosInstrumentacao = 0;
+static pthread_mutex_t travaInstrumentacao = PTHREAD_MUTEX_INITIALIZER;
+
+/// Instante do primeiro registro, em tiques e em ns (calibração do relógio)
+static uint64_t tiquesReferencia = 0;
+static double nsReferencia = 0.0;
+
+/// Limites fixos (em ns) dos baldes exportados ao Prometheus, de 10 ns a 1 s
+static const double limitesBaldesPrometheusNs[] = {
+    10, 20, 50, 100, 200, 500, 1e3, 2e3, 5e3, 1e4, 2e4, 5e4, 1e5, 2e5, 5e5, 1e6, 2e6, 5e6, 1e7, 2e7, 5e7, 1e8, 2e8, 5e8, 1e9
+};
+
+static const char* const nomesOperacoesInstrumentadas[TOTAL_OPERACOES_INSTRUMENTADAS] = {
+    "fila_inserir", "fila_remover", "pilha_reservar", "pilha_remover",
+    "processar_jogada", "processar_jogadas_lote", "comando_servidor",
+    "calcular_pontuacao", "combo_aplicado", "subida_nivel"
+};
+
+/**
+ * @brief Lê o relógio da instrumentação
+ * 
+ * Em x86 usa o contador de ciclos (sem chamada ao sistema); nas demais
+ * plataformas, o relógio monotônico em ns.
+ */
+static inline uint64_t lerTiquesInstrumentacao(void) {
+#ifdef LOTE_VETORIAL_X86
+    return __rdtsc();
+#else
+    return (uint64_t)obterTempoNanossegundos();
+#endif
+}
+
+/**
+ * @brief Cria e registra os contadores da thread atual
+ * @return Contadores da thread, ou NULL se faltou memória
+ */
+static InstrumentacaoThread* criarInstrumentacaoThread(void) {
+    InstrumentacaoThread* blocoPtr = calloc(1, sizeof(InstrumentacaoThread));
+    if (blocoPtr == NULL) {
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&travaInstrumentacao);
+    if (blocosInstrumentacao == NULL) {
+        nsReferencia = obterTempoNanossegundos();
+        tiquesReferencia = lerTiquesInstrumentacao();
+    }
+    blocoPtr->indice = totalBlocosInstrumentacao++;
+    blocoPtr->proxima = blocosInstrumentacao;
+    blocosInstrumentacao = blocoPtr;
+    pthread_mutex_unlock(&travaInstrumentacao);
+    
+    instrumentacaoLocal = blocoPtr;
+    return blocoPtr;
+}
+
+/**
+ * @brief Faixa do histograma que contém uma duração
+ * @param tiques Duração
+ * @return Índice de 0 a FAIXAS_HISTOGRAMA - 1
+ * 
+ * Abaixo de SUBFAIXAS_HISTOGRAMA cada valor tem sua faixa; acima, os três
+ * bits seguintes ao bit mais alto escolhem a subfaixa do expoente.
+ */
+static inline int faixaHistograma(uint64_t tiques) {
+    if (tiques < SUBFAIXAS_HISTOGRAMA) {
+        return (int)tiques;
+    }
+#if defined(__GNUC__)
+    int expoente = 63 - __builtin_clzll(tiques);
+#else
+    int expoente = 0;
+    for (uint64_t resto = tiques >> 1; resto != 0; resto >>= 1) {
+        expoente++;
+    }
+#endif
+    return (expoente - 2) * SUBFAIXAS_HISTOGRAMA + (int)((tiques >> (expoente - 3)) & (SUBFAIXAS_HISTOGRAMA - 1));
+}
+
+/**
+ * @brief Menor duração contida em uma faixa do histograma
+ */
+static uint64_t inicioFaixaHistograma(int faixa) {
+    if (faixa < SUBFAIXAS_HISTOGRAMA) {
+        return (uint64_t)faixa;
+    }
+    int expoente = faixa / SUBFAIXAS_HISTOGRAMA + 2;
+    return (uint64_t)(SUBFAIXAS_HISTOGRAMA + faixa % SUBFAIXAS_HISTOGRAMA) << (expoente - 3);
+}
+
+/**
+ * @brief Maior duração contida em uma faixa do histograma
+ */
+static uint64_t fimFaixaHistograma(int faixa) {
+    return faixa + 1 < FAIXAS_HISTOGRAMA ? inicioFaixaHistograma(faixa + 1) - 1 : UINT64_MAX;
+}
+
+/**
+ * @brief Conta uma chamada e decide se ela será cronometrada
+ * @param operacao Operação iniciada
+ * @return Leitura de lerTiquesInstrumentacao, ou 0 se a chamada não é amostrada
+ * 
+ * Cada operação tem a própria contagem regressiva, de modo que operações
+ * que se alternam (remover da fila e pontuar, por exemplo) são amostradas
+ * na mesma proporção. A primeira chamada de cada thread é sempre medida.
+ */
+static inline uint64_t iniciarInstrumentacao(OperacaoInstrumentada operacao) {
+    InstrumentacaoThread* blocoPtr = instrumentacaoLocal;
+    if (blocoPtr == NULL && (blocoPtr = criarInstrumentacaoThread()) == NULL) {
+        return 0;
+    }
+    HistogramaLatencia* histogramaPtr = &blocoPtr->operacoes[operacao];
+    histogramaPtr->chamadas++;
+    if (histogramaPtr->ateAmostra > 0) {
+        histogramaPtr->ateAmostra--;
+        return 0;
+    }
+    histogramaPtr->ateAmostra = INTERVALO_AMOSTRAGEM_INSTRUMENTACAO - 1;
+    return lerTiquesInstrumentacao();
+}
+
+/**
+ * @brief Registra a duração de uma chamada amostrada
+ * @param operacao Operação medida
+ * @param inicio Valor devolvido por iniciarInstrumentacao (0 = não amostrada)
+ * 
+ * Sem travas nem atômicas: cada thread escreve apenas os próprios
+ * contadores. O despejo os lê sem sincronização e pode ficar algumas
+ * operações atrás das threads ainda em execução.
+ */
+static inline void registrarInstrumentacao(OperacaoInstrumentada operacao, uint64_t inicio) {
+    if (inicio == 0) {
+        return;
+    }
+    uint64_t tiques = lerTiquesInstrumentacao() - inicio;
+    if ((int64_t)tiques < 0) {
+        tiques = 0;  // Contadores de ciclos de núcleos diferentes após migração
+    }
+    
+    HistogramaLatencia* histogramaPtr = &instrumentacaoLocal->operacoes[operacao];
+    histogramaPtr->amostras++;
+    histogramaPtr->somaTiques += tiques;
+    if (tiques > histogramaPtr->maximoTiques) {
+        histogramaPtr->maximoTiques = tiques;
+    }
+    histogramaPtr->faixas[faixaHistograma(tiques)]++;
+}
+
+/**
+ * @brief Conta uma ocorrência de uma operação sem cronometrá-la
+ * @param operacao Operação a partir de PRIMEIRA_OPERACAO_CONTADA
+ * 
+ * Um incremento no bloco da própria thread: barato o bastante para os
+ * passos internos de cada jogada, que são só consultas a tabelas.
+ */
+static inline void contarInstrumentacao(OperacaoInstrumentada operacao) {
+    InstrumentacaoThread* blocoPtr = instrumentacaoLocal;
+    if (blocoPtr == NULL && (blocoPtr = criarInstrumentacaoThread()) == NULL) {
+        return;
+    }
+    blocoPtr->operacoes[operacao].chamadas++;
+}
+
+/// Marca o início de uma operação instrumentada (declara a variável marca)
+#define INSTRUMENTAR_INICIO(operacao, marca) uint64_t marca = iniciarInstrumentacao(operacao)
+
+/// Registra a duração da operação iniciada em marca, se ela foi amostrada
+#define INSTRUMENTAR_FIM(operacao, marca) registrarInstrumentacao((operacao), (marca))
+
+/// Conta uma ocorrência de uma operação apenas contada
+#define INSTRUMENTAR_CONTAR(operacao) contarInstrumentacao(operacao)
+
+#else
+
+// Sem -DTETRIS_INSTRUMENTACAO os pontos de medição não geram código
+#define INSTRUMENTAR_INICIO(operacao, marca) ((void)0)
+#define INSTRUMENTAR_FIM(operacao, marca) ((void)0)
+#define INSTRUMENTAR_CONTAR(operacao) ((void)0)
+
+#endif
+
+#ifdef TETRIS_INSTRUMENTACAO
+
+/**
+ * @brief Converte tiques do relógio da instrumentação em nanossegundos
+ * @return Nanossegundos por tique
+ * 
+ * O contador de ciclos é calibrado contra o relógio monotônico desde o
+ * primeiro registro; se passou pouco tempo, espera completar 10 ms.
+ */
+static double nanossegundosPorTique(void) {
+#ifdef LOTE_VETORIAL_X86
+    double decorrido;
+    while ((decorrido = obterTempoNanossegundos() - nsReferencia) < 1e7) {
+    }
+    uint64_t tiques = lerTiquesInstrumentacao() - tiquesReferencia;
+    return tiques > 0 ? decorrido / (double)tiques : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * @brief Soma os histogramas de todas as threads
+ * @param total Recebe um histograma por operação
+ * @return Quantidade de threads instrumentadas
+ */
+static int somarInstrumentacao(HistogramaLatencia total[TOTAL_OPERACOES_INSTRUMENTADAS]) {
+    memset(total, 0, TOTAL_OPERACOES_INSTRUMENTADAS * sizeof(HistogramaLatencia));
+    
+    pthread_mutex_lock(&travaInstrumentacao);
+    for (InstrumentacaoThread* blocoPtr = blocosInstrumentacao; blocoPtr != NULL; blocoPtr = blocoPtr->proxima) {
+        for (int o = 0; o < TOTAL_OPERACOES_INSTRUMENTADAS; o++) {
+            const HistogramaLatencia* origem = &blocoPtr->operacoes[o];
+            total[o].chamadas += origem->chamadas;
+            total[o].amostras += origem->amostras;
+            total[o].somaTiques += origem->somaTiques;
+            if (origem->maximoTiques > total[o].maximoTiques) {
+                total[o].maximoTiques = origem->maximoTiques;
+            }
+            for (int f = 0; f < FAIXAS_HISTOGRAMA; f++) {
+                total[o].faixas[f] += origem->faixas[f];
+            }
+        }
+    }
+    int threads = totalBlocosInstrumentacao;
+    pthread_mutex_unlock(&travaInstrumentacao);
+    return threads;
+}
+
+/**
+ * @brief Percentil de um histograma
+ * @param histogramaPtr Histograma
+ * @param fracao Fração das operações amostradas (0.99 = p99)
+ * @return Maior duração da faixa que contém o percentil, limitada ao máximo
+ */
+static uint64_t percentilHistograma(const HistogramaLatencia* histogramaPtr, double fracao) {
+    uint64_t alvo = (uint64_t)ceil(fracao * (double)histogramaPtr->amostras);
+    uint64_t acumulado = 0;
+    
+    for (int f = 0; f < FAIXAS_HISTOGRAMA; f++) {
+        acumulado += histogramaPtr->faixas[f];
+        if (acumulado >= alvo && acumulado > 0) {
+            uint64_t fim = fimFaixaHistograma(f);
+            return fim < histogramaPtr->maximoTiques ? fim : histogramaPtr->maximoTiques;
+        }
+    }
+    return histogramaPtr->maximoTiques;
+}
+
+#endif
+
+/**
+ * @brief Exibe contadores e percentis de latência de cada operação do motor
+ * 
+ * Soma as threads que já registraram alguma operação, inclusive as que
+ * terminaram. Só há dados em compilações com -DTETRIS_INSTRUMENTACAO.
+ */
+void exibirInstrumentacao() {
+#ifndef TETRIS_INSTRUMENTACAO
+    printf("Instrumentacao desativada nesta compilacao (recompile com -DTETRIS_INSTRUMENTACAO).\n");
+#else
+    static HistogramaLatencia total[TOTAL_OPERACOES_INSTRUMENTADAS];
+    int threads = somarInstrumentacao(total);
+    if (threads == 0) {
+        printf("Nenhuma operacao instrumentada registrada ainda.\n");
+        return;
+    }
+    double nsPorTique = nanossegundosPorTique();
+    
+    printf("\n*** INSTRUMENTACAO DO MOTOR (%d threads, %.3f ns por tique, 1 amostra a cada %d chamadas):\n",
+           threads, nsPorTique, INTERVALO_AMOSTRAGEM_INSTRUMENTACAO);
+    printf("   %-24s %14s %12s %10s %10s %10s %10s %12s\n", "operacao", "chamadas", "amostras",
+           "media ns", "p50 ns", "p90 ns", "p99 ns", "maxima ns");
+    for (int o = 0; o < TOTAL_OPERACOES_INSTRUMENTADAS; o++) {
+        const HistogramaLatencia* histogramaPtr = &total[o];
+        if (o >= PRIMEIRA_OPERACAO_CONTADA && histogramaPtr->chamadas > 0) {
+            printf("   %-24s %14llu %12s\n", nomesOperacoesInstrumentadas[o],
+                   (unsigned long long)histogramaPtr->chamadas, "-");
+        }
+        if (histogramaPtr->amostras == 0) {
+            continue;
+        }
+        printf("   %-24s %14llu %12llu %10.1f %10.1f %10.1f %10.1f %12.1f\n", nomesOperacoesInstrumentadas[o],
+               (unsigned long long)histogramaPtr->chamadas, (unsigned long long)histogramaPtr->amostras,
+               histogramaPtr->somaTiques * nsPorTique / histogramaPtr->amostras,
+               percentilHistograma(histogramaPtr, 0.50) * nsPorTique,
+               percentilHistograma(histogramaPtr, 0.90) * nsPorTique,
+               percentilHistograma(histogramaPtr, 0.99) * nsPorTique,
+               histogramaPtr->maximoTiques * nsPorTique);
+    }
+#endif
+}
+
+/**
+ * @brief Grava as métricas da instrumentação no formato texto do Prometheus
+ * @param caminho Arquivo de destino
+ * @return 1 em caso de sucesso, 0 se a instrumentação está desativada ou o arquivo falhou
+ * 
+ * Exporta um contador de chamadas por operação e por thread e um
+ * histograma de latência por operação cronometrada (as apenas contadas,
+ * a partir de PRIMEIRA_OPERACAO_CONTADA, têm só o contador). Todas as séries e todos os baldes
+ * (limitesBaldesPrometheusNs) são escritos em todo despejo, mesmo vazios,
+ * para que rate() e histogram_quantile vejam o mesmo conjunto de rótulos
+ * entre coletas; cada faixa interna entra no primeiro balde que contém
+ * o seu fim. O arquivo é escrito ao lado e renomeado, para que um
+ * coletor nunca leia um despejo pela metade.
+ */
+int exportarInstrumentacaoPrometheus(const char* caminho) {
+#ifndef TETRIS_INSTRUMENTACAO
+    (void)caminho;
+    return 0;
+#else
+    static HistogramaLatencia total[TOTAL_OPERACOES_INSTRUMENTADAS];
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    FILE* saida = fopen(temporario, "w");
+    if (saida == NULL) {
+        printf("Nao foi possivel criar %s\n", temporario);
+        return 0;
+    }
+    
+    int threads = somarInstrumentacao(total);
+    double nsPorTique = threads > 0 ? nanossegundosPorTique() : 1.0;
+    
+    fprintf(saida, "# HELP tetris_instrumentacao_threads Threads que registraram operacoes\n");
+    fprintf(saida, "# TYPE tetris_instrumentacao_threads gauge\n");
+    fprintf(saida, "tetris_instrumentacao_threads %d\n", threads);
+    
+    fprintf(saida, "# HELP tetris_instrumentacao_ns_por_tique Calibracao do relogio da instrumentacao\n");
+    fprintf(saida, "# TYPE tetris_instrumentacao_ns_por_tique gauge\n");
+    fprintf(saida, "tetris_instrumentacao_ns_por_tique %.6f\n", nsPorTique);
+    
+    fprintf(saida, "# HELP tetris_instrumentacao_intervalo_amostragem Chamadas por amostra cronometrada\n");
+    fprintf(saida, "# TYPE tetris_instrumentacao_intervalo_amostragem gauge\n");
+    fprintf(saida, "tetris_instrumentacao_intervalo_amostragem %d\n", INTERVALO_AMOSTRAGEM_INSTRUMENTACAO);
+    
+    fprintf(saida, "# HELP tetris_operacoes_total Chamadas de cada operacao do motor por thread\n");
+    fprintf(saida, "# TYPE tetris_operacoes_total counter\n");
+    pthread_mutex_lock(&travaInstrumentacao);
+    for (InstrumentacaoThread* blocoPtr = blocosInstrumentacao; blocoPtr != NULL; blocoPtr = blocoPtr->proxima) {
+        for (int o = 0; o < TOTAL_OPERACOES_INSTRUMENTADAS; o++) {
+            fprintf(saida, "tetris_operacoes_total{operacao=\"%s\",thread=\"%d\"} %llu\n",
+                    nomesOperacoesInstrumentadas[o], blocoPtr->indice,
+                    (unsigned long long)blocoPtr->operacoes[o].chamadas);
+        }
+    }
+    pthread_mutex_unlock(&travaInstrumentacao);
+    
+    fprintf(saida, "# HELP tetris_operacao_latencia_ns Latencia amostrada de cada operacao do motor em nanossegundos\n");
+    fprintf(saida, "# TYPE tetris_operacao_latencia_ns histogram\n");
+    for (int o = 0; o < PRIMEIRA_OPERACAO_CONTADA; o++) {
+        const HistogramaLatencia* histogramaPtr = &total[o];
+        uint64_t acumulado = 0;
+        int f = 0;
+        for (int b = 0; b < (int)(sizeof(limitesBaldesPrometheusNs) / sizeof(limitesBaldesPrometheusNs[0])); b++) {
+            while (f < FAIXAS_HISTOGRAMA - 1 && fimFaixaHistograma(f) * nsPorTique <= limitesBaldesPrometheusNs[b]) {
+                acumulado += histogramaPtr->faixas[f++];
+            }
+            fprintf(saida, "tetris_operacao_latencia_ns_bucket{operacao=\"%s\",le=\"%.0f\"} %llu\n",
+                    nomesOperacoesInstrumentadas[o], limitesBaldesPrometheusNs[b], (unsigned long long)acumulado);
+        }
+        fprintf(saida, "tetris_operacao_latencia_ns_bucket{operacao=\"%s\",le=\"+Inf\"} %llu\n",
+                nomesOperacoesInstrumentadas[o], (unsigned long long)histogramaPtr->amostras);
+        fprintf(saida, "tetris_operacao_latencia_ns_sum{operacao=\"%s\"} %.1f\n",
+                nomesOperacoesInstrumentadas[o], histogramaPtr->somaTiques * nsPorTique);
+        fprintf(saida, "tetris_operacao_latencia_ns_count{operacao=\"%s\"} %llu\n",
+                nomesOperacoesInstrumentadas[o], (unsigned long long)histogramaPtr->amostras);
+    }
+    
+    fprintf(saida, "# HELP tetris_operacao_latencia_maxima_ns Maior latencia amostrada de cada operacao\n");
+    fprintf(saida, "# TYPE tetris_operacao_latencia_maxima_ns gauge\n");
+    for (int o = 0; o < PRIMEIRA_OPERACAO_CONTADA; o++) {
+        fprintf(saida, "tetris_operacao_latencia_maxima_ns{operacao=\"%s\"} %.1f\n",
+                nomesOperacoesInstrumentadas[o], total[o].maximoTiques * nsPorTique);
+    }
+    
+    int gravado = (fclose(saida) == 0);
+    if (!gravado || rename(temporario, caminho) != 0) {
+        printf("Nao foi possivel gravar %s\n", caminho);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              IMPLEMENTAÇÃO DAS FUNÇÕES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Inicializa a fila circular
+ * @param filaPtr Ponteiro para a estrutura da fila
+ */
+void inicializarFila(FilaCircular* filaPtr) {
+    filaPtr->indiceFrente = 0;
+    filaPtr->indiceTras = CAPACIDADE_FILA - 1;  // A primeira inserção avança para a posição 0
+    filaPtr->quantidadePecas = 0;
+    filaPtr->hashZobrist = 0;
+    filaPtr->potenciaZobrist = 1;
+}
+
+/**
+ * @brief Acrescenta uma peça ao final do hash Zobrist da fila
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param compacta Peça inserida
+ */
+static inline void acrescentarHashFila(FilaCircular* filaPtr, PecaCompacta compacta) {
+    filaPtr->hashZobrist += zobristFila[compacta & MASCARA_TIPO_COMPACTO] * filaPtr->potenciaZobrist;
+    filaPtr->potenciaZobrist *= BASE_ZOBRIST;
+}
+
+/**
+ * @brief Retira a peça da frente do hash Zobrist da fila
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param compacta Peça removida (a da frente)
+ * 
+ * Subtrai o peso 1 da frente e divide por BASE_ZOBRIST (multiplicação pelo
+ * inverso), de modo que as demais peças avançam uma posição no hash.
+ */
+static inline void retirarHashFila(FilaCircular* filaPtr, PecaCompacta compacta) {
+    filaPtr->hashZobrist = (filaPtr->hashZobrist - zobristFila[compacta & MASCARA_TIPO_COMPACTO]) * INVERSO_BASE_ZOBRIST;
+    filaPtr->potenciaZobrist *= INVERSO_BASE_ZOBRIST;
+}
+
+/**
+ * @brief Acumula as chaves de um bloco contíguo de peças no hash da fila
+ * @param pecas Primeira peça do bloco
+ * @param quantidade Peças no bloco (pode ser zero)
+ * @param somaPtr Soma acumulada das chaves ponderadas
+ * @param pesoPtr Peso da primeira peça do bloco; sai com o peso da seguinte
+ * 
+ * Usada pelas operações em lote, que percorrem a fila nos mesmos dois
+ * blocos contíguos da cópia, sem cálculo de índice circular por peça.
+ */
+static inline void acumularHashPecas(const PecaCompacta* pecas, int quantidade, uint64_t* somaPtr, uint64_t* pesoPtr) {
+    uint64_t soma = *somaPtr;
+    uint64_t peso = *pesoPtr;
+    for (int i = 0; i < quantidade; i++) {
+        soma += zobristFila[pecas[i] & MASCARA_TIPO_COMPACTO] * peso;
+        peso *= BASE_ZOBRIST;
+    }
+    *somaPtr = soma;
+    *pesoPtr = peso;
+}
+
+/**
+ * @brief Verifica se a fila está vazia
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @return 1 se vazia, 0 caso contrário
+ */
+int filaVazia(FilaCircular* filaPtr) {
+    return filaPtr->quantidadePecas == 0;
+}
+
+/**
+ * @brief Verifica se a fila está cheia
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @return 1 se cheia, 0 caso contrário
+ */
+int filaCheia(FilaCircular* filaPtr) {
+    return filaPtr->quantidadePecas == CAPACIDADE_FILA;
+}
+
+/**
+ * @brief Insere uma peça na fila
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param novaPeca Peça a ser inserida
+ */
+void inserirPecaNaFila(FilaCircular* filaPtr, Peca novaPeca) {
+    INSTRUMENTAR_INICIO(OPERACAO_FILA_INSERIR, inicio);
+    if (!filaCheia(filaPtr)) {
+        filaPtr->indiceTras = INDICE_CIRCULAR(filaPtr->indiceTras + 1);
+        filaPtr->pecas[filaPtr->indiceTras] = compactarPeca(novaPeca);
+        filaPtr->quantidadePecas++;
+        acrescentarHashFila(filaPtr, filaPtr->pecas[filaPtr->indiceTras]);
+    }
+    INSTRUMENTAR_FIM(OPERACAO_FILA_INSERIR, inicio);
+}
+
+/**
+ * @brief Remove e retorna uma peça da fila
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @return Peça removida
+ */
+Peca jogarPecaDaFila(FilaCircular* filaPtr) {
+    INSTRUMENTAR_INICIO(OPERACAO_FILA_REMOVER, inicio);
+    Peca peca = {'X', 0}; // Peça vazia por padrão
+    if (!filaVazia(filaPtr)) {
+        peca = expandirPeca(filaPtr->pecas[filaPtr->indiceFrente]);
+        retirarHashFila(filaPtr, filaPtr->pecas[filaPtr->indiceFrente]);
+        filaPtr->indiceFrente = INDICE_CIRCULAR(filaPtr->indiceFrente + 1);
+        filaPtr->quantidadePecas--;
+    }
+    INSTRUMENTAR_FIM(OPERACAO_FILA_REMOVER, inicio);
+    return peca;
+}
+
+/**
+ * @brief Compacta um bloco contíguo de peças
+ * @param destino Primeira posição de destino
+ * @param origem Primeira posição de origem
+ * @param quantidade Número de peças (pode ser zero)
+ * 
+ * Os blocos da fila são pequenos e limitados por CAPACIDADE_FILA; um laço
+ * simples evita o custo fixo da chamada a memcpy com tamanho variável.
+ */
+static inline void compactarPecas(PecaCompacta* destino, const Peca* origem, int quantidade) {
+    for (int i = 0; i < quantidade; i++) {
+        destino[i] = compactarPeca(origem[i]);
+    }
+}
+
+/**
+ * @brief Expande um bloco contíguo de peças compactas
+ * @param destino Primeira posição de destino
+ * @param origem Primeira posição de origem
+ * @param quantidade Número de peças (pode ser zero)
+ */
+static inline void expandirPecas(Peca* destino, const PecaCompacta* origem, int quantidade) {
+    for (int i = 0; i < quantidade; i++) {
+        destino[i] = expandirPeca(origem[i]);
+    }
+}
+
+/**
+ * @brief Insere várias peças no final da fila em uma única operação
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param pecas Peças a inserir, na ordem de chegada
+ * @param quantidade Número de peças disponíveis em pecas
+ * @return Número de peças efetivamente inseridas (limitado ao espaço livre)
+ * 
+ * A cópia é feita em no máximo dois blocos contíguos: do final atual até
+ * o fim do array e, se necessário, do início do array em diante.
+ */
+int inserirPecasNaFila(FilaCircular* filaPtr, const Peca* pecas, int quantidade) {
+    int livres = CAPACIDADE_FILA - filaPtr->quantidadePecas;
+    if (quantidade > livres) {
+        quantidade = livres;
+    }
+    if (quantidade <= 0) {
+        return 0;
+    }
+    
+    INSTRUMENTAR_INICIO(OPERACAO_FILA_INSERIR, inicio);
+    int posicao = INDICE_CIRCULAR(filaPtr->indiceTras + 1);
+    int primeiroBloco = CAPACIDADE_FILA - posicao;
+    if (primeiroBloco > quantidade) {
+        primeiroBloco = quantidade;
+    }
+    compactarPecas(&filaPtr->pecas[posicao], pecas, primeiroBloco);
+    compactarPecas(&filaPtr->pecas[0], pecas + primeiroBloco, quantidade - primeiroBloco);
+    
+    // Hash: as novas peças entram com pesos BASE_ZOBRIST^quantidadePecas em diante
+    uint64_t soma = 0;
+    acumularHashPecas(&filaPtr->pecas[posicao], primeiroBloco, &soma, &filaPtr->potenciaZobrist);
+    acumularHashPecas(&filaPtr->pecas[0], quantidade - primeiroBloco, &soma, &filaPtr->potenciaZobrist);
+    filaPtr->hashZobrist += soma;
+    
+    filaPtr->indiceTras = INDICE_CIRCULAR(filaPtr->indiceTras + quantidade);
+    filaPtr->quantidadePecas += quantidade;
+    INSTRUMENTAR_FIM(OPERACAO_FILA_INSERIR, inicio);
+    return quantidade;
+}
+
+/**
+ * @brief Copia as próximas peças da fila sem removê-las
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param destino Vetor que recebe as peças, da frente para o final
+ * @param quantidade Número máximo de peças a copiar
+ * @return Número de peças copiadas (limitado à quantidade na fila)
+ */
+int espiarPecasDaFila(const FilaCircular* filaPtr, Peca* destino, int quantidade) {
+    if (quantidade > filaPtr->quantidadePecas) {
+        quantidade = filaPtr->quantidadePecas;
+    }
+    if (quantidade <= 0) {
+        return 0;
+    }
+    
+    int primeiroBloco = CAPACIDADE_FILA - filaPtr->indiceFrente;
+    if (primeiroBloco > quantidade) {
+        primeiroBloco = quantidade;
+    }
+    expandirPecas(destino, &filaPtr->pecas[filaPtr->indiceFrente], primeiroBloco);
+    expandirPecas(destino + primeiroBloco, &filaPtr->pecas[0], quantidade - primeiroBloco);
+    return quantidade;
+}
+
+/**
+ * @brief Remove várias peças da frente da fila em uma única operação
+ * @param filaPtr Ponteiro para a estrutura da fila
+ * @param destino Vetor que recebe as peças removidas, na ordem de saída
+ * @param quantidade Número máximo de peças a remover
+ * @return Número de peças removidas (limitado à quantidade na fila)
+ */
+int jogarPecasDaFila(FilaCircular* filaPtr, Peca* destino, int quantidade) {
+    INSTRUMENTAR_INICIO(OPERACAO_FILA_REMOVER, inicio);
+    quantidade = espiarPecasDaFila(filaPtr, destino, quantidade);
+    
+    // Hash: subtrai as peças removidas (pesos 1, BASE_ZOBRIST, ...) e divide por BASE_ZOBRIST^quantidade
+    int primeiroBloco = CAPACIDADE_FILA - filaPtr->indiceFrente;
+    if (primeiroBloco > quantidade) {
+        primeiroBloco = quantidade;
+    }
+    uint64_t soma = 0;
+    uint64_t peso = 1;
+    uint64_t inverso = 1;
+    acumularHashPecas(&filaPtr->pecas[filaPtr->indiceFrente], primeiroBloco, &soma, &peso);
+    acumularHashPecas(&filaPtr->pecas[0], quantidade - primeiroBloco, &soma, &peso);
+    for (int i = 0; i < quantidade; i++) {
+        inverso *= INVERSO_BASE_ZOBRIST;
+    }
+    filaPtr->hashZobrist = (filaPtr->hashZobrist - soma) * inverso;
+    filaPtr->potenciaZobrist *= inverso;
+    filaPtr->indiceFrente = INDICE_CIRCULAR(filaPtr->indiceFrente + quantidade);
+    filaPtr->quantidadePecas -= quantidade;
+    INSTRUMENTAR_FIM(OPERACAO_FILA_REMOVER, inicio);
+    return quantidade;
+}
+
+/**
+ * @brief Exibe o conteúdo da fila
+ * @param filaPtr Ponteiro para a estrutura da fila
+ */
+void exibirFila(FilaCircular* filaPtr) {
+    QuadroTerminal quadro;
+    inicializarQuadroTerminal(&quadro);
+    comporFila(&quadro, filaPtr);
+    emitirQuadroTerminal(&quadro);
+}
+
+/**
+ * @brief Inicializa a pilha de reserva
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ */
+void inicializarPilha(PilhaReserva* pilhaPtr) {
+    pilhaPtr->indiceTopo = -1;
+    pilhaPtr->quantidadeReservada = 0;
+    pilhaPtr->hashZobrist = 0;
+    pilhaPtr->potenciaZobrist = 1;
+}
+
+/**
+ * @brief Verifica se a pilha está vazia
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @return 1 se vazia, 0 caso contrário
+ */
+int pilhaVazia(PilhaReserva* pilhaPtr) {
+    return pilhaPtr->quantidadeReservada == 0;
+}
+
+/**
+ * @brief Verifica se a pilha está cheia
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @return 1 se cheia, 0 caso contrário
+ */
+int pilhaCheia(PilhaReserva* pilhaPtr) {
+    return pilhaPtr->quantidadeReservada == CAPACIDADE_PILHA;
+}
+
+/**
+ * @brief Adiciona uma peça à pilha de reserva
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @param peca Peça a ser reservada
+ */
+void reservarPeca(PilhaReserva* pilhaPtr, Peca peca) {
+    INSTRUMENTAR_INICIO(OPERACAO_PILHA_RESERVAR, inicio);
+    if (!pilhaCheia(pilhaPtr)) {
+        pilhaPtr->indiceTopo++;
+        pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo] = compactarPeca(peca);
+        pilhaPtr->quantidadeReservada++;
+        pilhaPtr->hashZobrist += zobristPilha[pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo] & MASCARA_TIPO_COMPACTO] *
+                                 pilhaPtr->potenciaZobrist;
+        pilhaPtr->potenciaZobrist *= BASE_ZOBRIST;
+    }
+    INSTRUMENTAR_FIM(OPERACAO_PILHA_RESERVAR, inicio);
+}
+
+/**
+ * @brief Remove e retorna uma peça da pilha
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ * @return Peça removida
+ */
+Peca jogarPecaDaPilha(PilhaReserva* pilhaPtr) {
+    INSTRUMENTAR_INICIO(OPERACAO_PILHA_REMOVER, inicio);
+    Peca peca = {'X', 0}; // Peça vazia por padrão
+    if (!pilhaVazia(pilhaPtr)) {
+        peca = expandirPeca(pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo]);
+        pilhaPtr->potenciaZobrist *= INVERSO_BASE_ZOBRIST;
+        pilhaPtr->hashZobrist -= zobristPilha[pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo] & MASCARA_TIPO_COMPACTO] *
+                                 pilhaPtr->potenciaZobrist;
+        pilhaPtr->indiceTopo--;
+        pilhaPtr->quantidadeReservada--;
+    }
+    INSTRUMENTAR_FIM(OPERACAO_PILHA_REMOVER, inicio);
+    return peca;
+}
+
+/**
+ * @brief Exibe o conteúdo da pilha
+ * @param pilhaPtr Ponteiro para a estrutura da pilha
+ */
+void exibirPilha(PilhaReserva* pilhaPtr) {
+    QuadroTerminal quadro;
+    inicializarQuadroTerminal(&quadro);
+    comporPilha(&quadro, pilhaPtr);
+    emitirQuadroTerminal(&quadro);
+}
+
+/**
+ * @brief Inicializa o sistema Expert com valores padrão
+ * @param sistemaPtr Ponteiro para a estrutura do sistema Expert
+ */
+void inicializarSistemaExpert(SistemaExpert* sistemaPtr) {
+    // Inicialização do sistema de pontuação
+    sistemaPtr->pontuacaoTotal = 0;
+    sistemaPtr->pontuacaoNivel = 0;
+    sistemaPtr->pontosUltimaJogada = 0;
+    sistemaPtr->multiplicadorAtual = 1.0;
+    sistemaPtr->fatorDificuldade = 1.0;
+    
+    // Inicialização de combos
+    sistemaPtr->comboAtual = 0;
+    sistemaPtr->melhorCombo = 0;
+    sistemaPtr->totalCombos = 0;
+    sistemaPtr->ultimoTipoJogado = 'X';
+    sistemaPtr->sequenciaTipoAtual = 0;
+    
+    // Inicialização dos níveis de dificuldade
+    sistemaPtr->nivelAtual = 1;
+    sistemaPtr->pontosParaProximoNivel = 1000;
+    sistemaPtr->limitePontosNivel = 1000;
+    
+    // Inicialização das estatísticas avançadas
+    sistemaPtr->totalJogadas = 0;
+    sistemaPtr->jogadasDaFila = 0;
+    sistemaPtr->jogadasDaPilha = 0;
+    sistemaPtr->pecasReservadas = 0;
+    sistemaPtr->eficienciaReserva = 0;
+    
+    // Inicialização das estatísticas por tipo de peça
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        sistemaPtr->contagemPorTipo[i] = 0;
+    }
+    sistemaPtr->tipoMaisJogado = 'I';
+    
+    // Inicialização de combos
+    sistemaPtr->comboAtual = 0;
+    sistemaPtr->melhorCombo = 0;
+    sistemaPtr->totalCombos = 0;
+    sistemaPtr->ultimoTipoJogado = 'X';
+    sistemaPtr->sequenciaTipoAtual = 0;
+    
+    // Inicialização de conquistas e marcos
+    sistemaPtr->conquistasDesbloqueadas = 0;
+    sistemaPtr->marcosAlcancados = 0;
+    sistemaPtr->recordePessoal = 0;
+    
+    atualizarTabelaPontuacao(sistemaPtr);
+}
+
+/**
+ * @brief Converte o caractere de uma peça no seu índice denso
+ * @param tipoPeca Tipo da peça ('I', 'O', 'T', 'S', 'Z', 'J', 'L' ou outro)
+ * @return Índice correspondente, ou PECA_DESCONHECIDA
+ */
+TipoPeca indiceTipoPeca(char tipoPeca) {
+    return (TipoPeca)(tabelaIndiceTipo[(unsigned char)tipoPeca] ^ PECA_DESCONHECIDA);
+}
+
+/**
+ * @brief Recalcula o cache de pontos por tipo após mudança de multiplicadores
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * 
+ * Usa exatamente a mesma expressão em ponto flutuante de antes
+ * (base x multiplicador x dificuldade, truncado), de modo que os pontos
+ * são idênticos aos calculados a cada jogada. Deve ser chamada sempre que
+ * multiplicadorAtual ou fatorDificuldade forem alterados.
+ */
+void atualizarTabelaPontuacao(SistemaExpert* sistemaPtr) {
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        sistemaPtr->pontosPorTipo[i] = (int)(pontuacaoBasePorTipo[i] * sistemaPtr->multiplicadorAtual * sistemaPtr->fatorDificuldade);
+    }
+}
+
+/**
+ * @brief Calcula a pontuação base para um tipo de peça
+ * @param tipoPeca Tipo da peça jogada
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @return Pontuação calculada
+ * 
+ * Consulta direta ao cache pontosPorTipo: sem switch e sem ponto flutuante.
+ */
+int calcularPontuacao(char tipoPeca, SistemaExpert* sistemaPtr) {
+    return sistemaPtr->pontosPorTipo[indiceTipoPeca(tipoPeca)];
+}
+
+/**
+ * @brief Detecta e processa combos de peças consecutivas
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @param tipoPeca Tipo da peça atual
+ * @return Multiplicador de combo aplicado
+ * 
+ * A sequência cresce enquanto o tipo se repete e volta a 1 quando muda;
+ * a partir da terceira peça igual, cada repetição soma 0.2x ao combo.
+ * Implementada com aritmética inteira, sem desvios condicionais.
+ */
+double detectarCombo(SistemaExpert* sistemaPtr, char tipoPeca) {
+    int mesmoTipo = (sistemaPtr->ultimoTipoJogado == tipoPeca);
+    int sequencia = sistemaPtr->sequenciaTipoAtual * mesmoTipo + 1;
+    int combo = sequencia - 2;
+    combo &= -(combo > 0);
+    
+    sistemaPtr->sequenciaTipoAtual = sequencia;
+    sistemaPtr->comboAtual = combo;
+    sistemaPtr->melhorCombo = combo > sistemaPtr->melhorCombo ? combo : sistemaPtr->melhorCombo;
+    sistemaPtr->ultimoTipoJogado = tipoPeca;
+    
+    return 1.0 + (combo * 0.2);
+}
+
+/**
+ * @brief Informa a pontuação necessária para concluir um nível
+ * @param nivel Nível consultado (a partir de 1)
+ * @return Limite de pontos do nível, ou INT_MAX além do último nível tabelado
+ * 
+ * Substitui o cálculo 1000 * 1.5^(nível - 1) em ponto flutuante por uma
+ * consulta à tabela limitesPontosNivel.
+ */
+int limitePontosDoNivel(int nivel) {
+    if (nivel < 1) {
+        return limitesPontosNivel[0];
+    }
+    if (nivel > NIVEIS_TABELADOS) {
+        return INT_MAX;
+    }
+    return limitesPontosNivel[nivel - 1];
+}
+
+/**
+ * @brief Calcula o nível correspondente a uma pontuação total
+ * @param pontuacao Pontuação acumulada
+ * @return Nível em que a pontuação se encontra (1 para pontuações abaixo de 1000)
+ * 
+ * Equivale a contar os limites já alcançados, em tempo constante: o bit
+ * mais alto da pontuação indexa limitesAbaixoDaPotencia e, como cada
+ * intervalo [2^b, 2^(b+1)) contém no máximo dois limites, bastam até
+ * duas comparações para concluir. Não depende de libm.
+ */
+int nivelParaPontuacao(int pontuacao) {
+    if (pontuacao < limitesPontosNivel[0]) {
+        return 1;
+    }
+    
+#if defined(__GNUC__)
+    int bitMaisAlto = 31 - __builtin_clz((unsigned int)pontuacao);
+#else
+    int bitMaisAlto = 0;
+    for (unsigned int resto = (unsigned int)pontuacao >> 1; resto != 0; resto >>= 1) {
+        bitMaisAlto++;
+    }
+#endif
+    
+    int alcancados = limitesAbaixoDaPotencia[bitMaisAlto];
+    while (alcancados < NIVEIS_TABELADOS && limitesPontosNivel[alcancados] <= pontuacao) {
+        alcancados++;
+    }
+    return alcancados + 1;
+}
+
+/**
+ * @brief Aplica a progressão de nível, sem mensagens nem conquistas
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @return 1 se o sistema subiu de nível, 0 caso contrário
+ * 
+ * Núcleo de verificarProgressaoNivel, usado também pelo conselheiro de
+ * jogadas para simular jogadas futuras com as mesmas regras.
+ */
+int aplicarProgressaoNivel(SistemaExpert* sistemaPtr) {
+    // Verificar se atingiu pontos suficientes para próximo nível
+    if (sistemaPtr->pontuacaoTotal >= sistemaPtr->limitePontosNivel) {
+        sistemaPtr->nivelAtual++;
+        
+        // Novo limite da progressão exponencial (tabela pré-calculada)
+        sistemaPtr->limitePontosNivel = limitePontosDoNivel(sistemaPtr->nivelAtual);
+        sistemaPtr->pontosParaProximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
+        
+        // Aumentar fator de dificuldade (máximo 3.0)
+        if (sistemaPtr->fatorDificuldade < 3.0) {
+            sistemaPtr->fatorDificuldade += 0.2;
+        }
+        
+        // Aumentar multiplicador base (máximo 10.0)
+        if (sistemaPtr->multiplicadorAtual < 10.0) {
+            sistemaPtr->multiplicadorAtual += 0.5;
+        }
+        atualizarTabelaPontuacao(sistemaPtr);
+        
+        // Registrar marco alcançado
+        sistemaPtr->marcosAlcancados++;
+        return 1;
+    }
+    
+    // Atualizar pontos restantes para próximo nível
+    sistemaPtr->pontosParaProximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
+    return 0;
+}
+
+/**
+ * @brief Verifica e processa a progressão de nível baseada na pontuação
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * 
+ * Esta função implementa um sistema dinâmico de progressão que:
+ * - Monitora a pontuação atual do nível
+ * - Calcula progressão exponencial de dificuldade
+ * - Ajusta automaticamente multiplicadores e limites
+ * - Fornece feedback visual da evolução
+ */
+void verificarProgressaoNivel(SistemaExpert* sistemaPtr) {
+    if (aplicarProgressaoNivel(sistemaPtr)) {
+        INSTRUMENTAR_CONTAR(OPERACAO_NIVEL);
+        if (!modoSilencioso) {
+            printf("\n*** NIVEL %d ALCANCADO! ***\n", sistemaPtr->nivelAtual);
+            printf("Novo multiplicador: %.1fx\n", sistemaPtr->multiplicadorAtual);
+            printf("Fator de dificuldade: %.1f\n", sistemaPtr->fatorDificuldade);
+        }
+    }
+    
+    // Verificar conquistas especiais
+    if (sistemaPtr->nivelAtual == 5 && !(sistemaPtr->conquistasDesbloqueadas & 1)) {
+        sistemaPtr->conquistasDesbloqueadas |= 1; // Primeira conquista
+        if (!modoSilencioso) {
+            printf("*** CONQUISTA DESBLOQUEADA: Veterano (Nivel 5)\n");
+        }
+    }
+    
+    if (sistemaPtr->nivelAtual == 10 && !(sistemaPtr->conquistasDesbloqueadas & 2)) {
+        sistemaPtr->conquistasDesbloqueadas |= 2; // Segunda conquista
+        if (!modoSilencioso) {
+            printf("*** CONQUISTA DESBLOQUEADA: Mestre (Nivel 10)\n");
+        }
+    }
+}
+
+/**
+ * @brief Indica se o tipo recém-contado passou a ser o mais jogado
+ * @param contagem Contagens por tipo (já incluindo a jogada atual)
+ * @param tipo Índice do tipo jogado
+ * @param maisJogado Índice do tipo mais jogado antes da jogada
+ * @return 1 se tipo assume a posição de mais jogado, 0 caso contrário
+ * 
+ * Como só a contagem de tipo mudou (em uma unidade), basta compará-la com
+ * a do atual mais jogado; no empate prevalece o primeiro tipo na ordem
+ * I, O, T, S, Z, J, L, exatamente como em uma varredura completa.
+ */
+static inline int superaTipoMaisJogado(const int* contagem, int tipo, int maisJogado) {
+    return (tipo != PECA_DESCONHECIDA) &
+           ((contagem[tipo] > contagem[maisJogado]) | ((contagem[tipo] == contagem[maisJogado]) & (tipo < maisJogado)));
+}
+
+/**
+ * @brief Copia a distribuição de peças jogadas por tipo
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @param contagens Vetor de 7 posições, na ordem de tiposPecas (I, O, T, S, Z, J, L)
+ * @return Total de peças contabilizadas
+ */
+int consultarDistribuicaoTipos(const SistemaExpert* sistemaPtr, int contagens[7]) {
+    int total = 0;
+    for (int i = 0; i < PECA_DESCONHECIDA; i++) {
+        contagens[i] = sistemaPtr->contagemPorTipo[i];
+        total += contagens[i];
+    }
+    return total;
+}
+
+/**
+ * @brief Processa uma jogada completa no sistema Expert
+ * @param peca Peça jogada
+ * @param origem Origem da peça (0=fila, 1=pilha)
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ */
+void processarJogadaExpert(Peca peca, int origem, SistemaExpert* sistemaPtr) {
+    INSTRUMENTAR_INICIO(OPERACAO_JOGADA, inicio);
+    
+    // Cálculo da pontuação
+    int pontos = calcularPontuacao(peca.tipo, sistemaPtr);
+    INSTRUMENTAR_CONTAR(OPERACAO_PONTUACAO);
+    
+    // Detectar combo e aplicar multiplicador
+    double multiplicadorCombo = detectarCombo(sistemaPtr, peca.tipo);
+    if (sistemaPtr->comboAtual > 0) {
+        INSTRUMENTAR_CONTAR(OPERACAO_COMBO);
+    }
+    
+    // Aplicar multiplicador de combo à pontuação
+    pontos = (int)(pontos * multiplicadorCombo);
+    
+    // Atualização das pontuações
+    sistemaPtr->pontosUltimaJogada = pontos;
+    sistemaPtr->pontuacaoTotal += pontos;
+    sistemaPtr->pontuacaoNivel += pontos;
+    
+    // Atualização do recorde pessoal
+    if (sistemaPtr->pontuacaoTotal > sistemaPtr->recordePessoal) {
+        sistemaPtr->recordePessoal = sistemaPtr->pontuacaoTotal;
+    }
+    
+    // Estatísticas de origem das jogadas
+    sistemaPtr->totalJogadas++;
+    sistemaPtr->jogadasDaFila += (origem == 0);
+    sistemaPtr->jogadasDaPilha += (origem != 0);
+    
+    // Atualizar contador do tipo e, em O(1), o tipo mais jogado
+    int tipo = indiceTipoPeca(peca.tipo);
+    int maisJogado = indiceTipoPeca(sistemaPtr->tipoMaisJogado);
+    sistemaPtr->contagemPorTipo[tipo] += (tipo != PECA_DESCONHECIDA);
+    if (superaTipoMaisJogado(sistemaPtr->contagemPorTipo, tipo, maisJogado)) {
+        sistemaPtr->tipoMaisJogado = peca.tipo;
+    }
+    
+    // Calcular eficiência da reserva
+    if (sistemaPtr->totalJogadas > 0) {
+        sistemaPtr->eficienciaReserva = (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100.0;
+    }
+    
+    // Verificação de progressão de nível
+    verificarProgressaoNivel(sistemaPtr);
+    INSTRUMENTAR_FIM(OPERACAO_JOGADA, inicio);
+}
+
+/**
+ * @brief Exibe estatísticas avançadas do sistema Expert
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ */
+void exibirEstatisticasExpert(SistemaExpert* sistemaPtr) {
+    QuadroTerminal quadro;
+    inicializarQuadroTerminal(&quadro);
+    escreverLinhaQuadro(&quadro, "");
+    comporEstatisticasExpert(&quadro, sistemaPtr);
+    emitirQuadroTerminal(&quadro);
+}
+
+/**
+ * @brief Otimiza e valida o sistema Expert
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @return 1 se otimização foi aplicada, 0 caso contrário
+ */
+int otimizarSistemaExpert(SistemaExpert* sistemaPtr) {
+    int otimizacaoAplicada = 0;
+    
+    // Validação e correção de valores inconsistentes
+    if (sistemaPtr->multiplicadorAtual > 10.0) {
+        sistemaPtr->multiplicadorAtual = 10.0;
+        otimizacaoAplicada = 1;
+    }
+    
+    if (sistemaPtr->multiplicadorAtual < 1.0) {
+        sistemaPtr->multiplicadorAtual = 1.0;
+        otimizacaoAplicada = 1;
+    }
+    
+    // Recálculo da eficiência se necessário
+    if (sistemaPtr->totalJogadas > 0) {
+        double novaEficiencia = (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100.0;
+        if (abs((int)(novaEficiencia - sistemaPtr->eficienciaReserva)) > 1) {
+            sistemaPtr->eficienciaReserva = novaEficiencia;
+            otimizacaoAplicada = 1;
+        }
+    }
+    
+    // Ajuste automático da dificuldade baseado no desempenho
+    if (sistemaPtr->nivelAtual > 5 && sistemaPtr->fatorDificuldade < 2.0) {
+        sistemaPtr->fatorDificuldade = 1.0 + (sistemaPtr->nivelAtual - 1) * 0.2;
+        otimizacaoAplicada = 1;
+    }
+    
+    if (otimizacaoAplicada) {
+        atualizarTabelaPontuacao(sistemaPtr);
+    }
+    return otimizacaoAplicada;
+}
+
+/**
+ * @brief Gera relatório detalhado do sistema Expert
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ */
+void gerarRelatorioExpert(SistemaExpert* sistemaPtr) {
+    printf("\n+==============================================================+\n");
+    printf("|                     RELATORIO EXPERT                        |\n");
+    printf("+==============================================================+\n");
+    
+    // Analise de Performance
+    printf("\n*** ANALISE DE PERFORMANCE:\n");
+    printf("   * Pontuacao Media por Jogada: %.1f\n", 
+           sistemaPtr->totalJogadas > 0 ? (double)sistemaPtr->pontuacaoTotal / sistemaPtr->totalJogadas : 0);
+    printf("   * Taxa de Uso da Reserva: %.1f%%\n", 
+           sistemaPtr->totalJogadas > 0 ? (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100 : 0);
+    printf("   * Progressao de Nivel: %d niveis alcancados\n", sistemaPtr->nivelAtual - 1);
+    
+    // Recomendacoes Estrategicas
+    printf("\n*** RECOMENDACOES ESTRATEGICAS:\n");
+    if (sistemaPtr->eficienciaReserva < 20) {
+        printf("   * Utilize mais a pilha de reserva para melhor estrategia\n");
+    }
+    if (sistemaPtr->melhorCombo < 5) {
+        printf("   * Foque em formar combos de pecas consecutivas\n");
+    }
+    if (sistemaPtr->sequenciaTipoAtual < 3) {
+        printf("   * Mantenha sequencias longas para maximizar multiplicadores\n");
+    }
+    
+    // Projecoes de Melhoria
+    printf("\n*** PROJECOES DE MELHORIA:\n");
+    int proximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
+    printf("   * Pontos para proximo nivel: %d\n", proximoNivel);
+    printf("   * Potencial de pontuacao com combo maximo: %d\n", 
+           sistemaPtr->pontuacaoTotal + (sistemaPtr->melhorCombo * 100));
+    printf("   * Eficiencia otima da reserva: 40-60%%\n");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              GERADOR DE PEÇAS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Rotaciona um inteiro de 32 bits para a esquerda
+ */
+static inline uint32_t rotacionarEsquerda(uint32_t valor, int bits) {
+    return (valor << bits) | (valor >> (32 - bits));
+}
+
+/**
+ * @brief Inicializa um gerador de peças com semente explícita
+ * @param geradorPtr Ponteiro para o gerador
+ * @param semente Semente de 64 bits (qualquer valor, inclusive 0)
+ * @param modo Modo de sorteio (uniforme ou saco de 7)
+ * 
+ * O estado de 128 bits é expandido a partir da semente pelo SplitMix64,
+ * o que garante um estado inicial nunca totalmente nulo.
+ */
+void inicializarGeradorPecas(GeradorPecas* geradorPtr, uint64_t semente, ModoGeradorPecas modo) {
+    uint64_t z = semente;
+    for (int i = 0; i < 4; i += 2) {
+        z += 0x9E3779B97F4A7C15ULL;
+        uint64_t misturado = z;
+        misturado = (misturado ^ (misturado >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        misturado = (misturado ^ (misturado >> 27)) * 0x94D049BB133111EBULL;
+        misturado ^= misturado >> 31;
+        geradorPtr->estado[i] = (uint32_t)misturado;
+        geradorPtr->estado[i + 1] = (uint32_t)(misturado >> 32);
+    }
+    geradorPtr->modo = modo;
+    geradorPtr->posicaoSaco = 7;
+}
+
+/**
+ * @brief Produz o próximo número de 32 bits (xoshiro128**)
+ * @param geradorPtr Ponteiro para o gerador
+ * @return Número pseudoaleatório uniforme em [0, 2^32)
+ */
+uint32_t proximoNumeroAleatorio(GeradorPecas* geradorPtr) {
+    uint32_t* e = geradorPtr->estado;
+    uint32_t resultado = rotacionarEsquerda(e[1] * 5, 7) * 9;
+    uint32_t t = e[1] << 9;
+    
+    e[2] ^= e[0];
+    e[3] ^= e[1];
+    e[1] ^= e[2];
+    e[0] ^= e[3];
+    e[2] ^= t;
+    e[3] = rotacionarEsquerda(e[3], 11);
+    
+    return resultado;
+}
+
+/**
+ * @brief Sorteia um inteiro sem viés no intervalo [0, limite)
+ * @param geradorPtr Ponteiro para o gerador
+ * @param limite Limite superior exclusivo (maior que zero)
+ * @return Número sorteado
+ * 
+ * Usa o método de multiplicação de Lemire: evita a divisão do "% n" e
+ * rejeita a pequena faixa que causaria viés.
+ */
+uint32_t sortearLimitado(GeradorPecas* geradorPtr, uint32_t limite) {
+    uint64_t produto = (uint64_t)proximoNumeroAleatorio(geradorPtr) * limite;
+    uint32_t parteBaixa = (uint32_t)produto;
+    if (parteBaixa < limite) {
+        uint32_t piso = (0u - limite) % limite;
+        while (parteBaixa < piso) {
+            produto = (uint64_t)proximoNumeroAleatorio(geradorPtr) * limite;
+            parteBaixa = (uint32_t)produto;
+        }
+    }
+    return (uint32_t)(produto >> 32);
+}
+
+/**
+ * @brief Sorteia o tipo da próxima peça segundo o modo do gerador
+ * @param geradorPtr Ponteiro para o gerador
+ * @return Tipo da peça ('I', 'O', 'T', 'S', 'Z', 'J' ou 'L')
+ */
+char sortearTipoPeca(GeradorPecas* geradorPtr) {
+    if (geradorPtr->modo == GERADOR_UNIFORME) {
+        return tiposPecas[sortearLimitado(geradorPtr, 7)];
+    }
+    
+    // Saco de 7: embaralhamento de Fisher-Yates quando o saco esvazia
+    if (geradorPtr->posicaoSaco >= 7) {
+        for (int i = 0; i < 7; i++) {
+            geradorPtr->saco[i] = tiposPecas[i];
+        }
+        for (int i = 6; i > 0; i--) {
+            int j = (int)sortearLimitado(geradorPtr, (uint32_t)(i + 1));
+            char temporario = geradorPtr->saco[i];
+            geradorPtr->saco[i] = geradorPtr->saco[j];
+            geradorPtr->saco[j] = temporario;
+        }
+        geradorPtr->posicaoSaco = 0;
+    }
+    return geradorPtr->saco[geradorPtr->posicaoSaco++];
+}
+
+/// 7^11: maior potência de 7 que cabe em 32 bits (11 peças por sorteio)
+#define POTENCIA_SETE_11 1977326743u
+
+/**
+ * @brief Preenche um vetor com tipos de peça em lote
+ * @param geradorPtr Ponteiro para o gerador
+ * @param tipos Vetor de saída
+ * @param quantidade Número de tipos a gerar
+ * 
+ * No modo uniforme, cada número de 32 bits sorteado abaixo de 2 * 7^11 é
+ * decomposto em 11 dígitos na base 7, ou seja, 11 peças sem viés por
+ * chamada ao xoshiro (a rejeição ocorre em menos de 8% dos sorteios).
+ */
+void preencherTiposPecas(GeradorPecas* geradorPtr, char* tipos, int quantidade) {
+    if (geradorPtr->modo != GERADOR_UNIFORME) {
+        for (int i = 0; i < quantidade; i++) {
+            tipos[i] = sortearTipoPeca(geradorPtr);
+        }
+        return;
+    }
+    
+    int i = 0;
+    while (i < quantidade) {
+        uint32_t sorteio = proximoNumeroAleatorio(geradorPtr);
+        if (sorteio >= 2u * POTENCIA_SETE_11) {
+            continue;
+        }
+        sorteio %= POTENCIA_SETE_11;
+        for (int digito = 0; digito < 11 && i < quantidade; digito++) {
+            tipos[i++] = tiposPecas[sorteio % 7];
+            sorteio /= 7;
+        }
+    }
+}
+
+/**
+ * @brief Cria uma nova peça
+ * @param tipo Tipo da peça
+ * @param id ID da peça
+ * @return Nova peça criada
+ */
+Peca criarPeca(char tipo, int id) {
+    Peca novaPeca;
+    novaPeca.tipo = tipo;
+    novaPeca.id = id;
+    return novaPeca;
+}
+
+/**
+ * @brief Converte uma peça para a representação compacta de 32 bits
+ * @param peca Peça a converter
+ * @return Peça compacta (tipo nos 3 bits inferiores, ID nos demais)
+ */
+PecaCompacta compactarPeca(Peca peca) {
+    return ((uint32_t)peca.id << BITS_TIPO_COMPACTO) | (uint32_t)indiceTipoPeca(peca.tipo);
+}
+
+/**
+ * @brief Obtém o caractere do tipo de uma peça compacta
+ * @param compacta Peça compacta
+ * @return 'I', 'O', 'T', 'S', 'Z', 'J', 'L' ou 'X' (peça vazia)
+ */
+char tipoPecaCompacta(PecaCompacta compacta) {
+    return caracterePorTipo[compacta & MASCARA_TIPO_COMPACTO];
+}
+
+/**
+ * @brief Converte uma peça compacta de volta para Peca (exibição e API)
+ * @param compacta Peça compacta
+ * @return Peça equivalente
+ */
+Peca expandirPeca(PecaCompacta compacta) {
+    return criarPeca(tipoPecaCompacta(compacta), (int)(compacta >> BITS_TIPO_COMPACTO));
+}
+
+/**
+ * @brief Gera peças aleatórias para a fila
+ * @param filaPtr Ponteiro para a fila
+ */
+void gerarPecasAleatorias(FilaCircular* filaPtr) {
+    char tipos[CAPACIDADE_FILA];
+    Peca novasPecas[CAPACIDADE_FILA];
+    int livres = CAPACIDADE_FILA - filaPtr->quantidadePecas;
+    
+    // Apenas as posições livres são sorteadas, e a inserção é feita em lote
+    preencherTiposPecas(&geradorGlobal, tipos, livres);
+    for (int i = 0; i < livres; i++) {
+        novasPecas[i] = criarPeca(tipos[i], proximoId++);
+    }
+    inserirPecasNaFila(filaPtr, novasPecas, livres);
+}
+
+/**
+ * @brief Inicializa uma sessão de jogo independente
+ * @param sessaoPtr Ponteiro para a sessão
+ * @param semente Semente do gerador de peças da sessão
+ * @param modo Modo de sorteio das peças
+ */
+void inicializarSessaoJogo(SessaoJogo* sessaoPtr, uint64_t semente, ModoGeradorPecas modo) {
+    inicializarFila(&sessaoPtr->fila);
+    inicializarPilha(&sessaoPtr->pilha);
+    inicializarSistemaExpert(&sessaoPtr->sistema);
+    sessaoPtr->proximoId = 1;
+    sessaoPtr->log = NULL;
+    sessaoPtr->conselheiro = NULL;
+    sessaoPtr->tabuleiro = NULL;
+    inicializarGeradorPecas(&sessaoPtr->gerador, semente, modo);
+}
+
+/**
+ * @brief Gera peças aleatórias para a fila de uma sessão
+ * @param sessaoPtr Ponteiro para a sessão
+ * 
+ * Equivalente a gerarPecasAleatorias, mas usa o contador de IDs e o
+ * gerador de peças da própria sessão, podendo rodar em várias threads.
+ */
+void gerarPecasAleatoriasSessao(SessaoJogo* sessaoPtr) {
+    char tipos[CAPACIDADE_FILA];
+    Peca novasPecas[CAPACIDADE_FILA];
+    int livres = CAPACIDADE_FILA - sessaoPtr->fila.quantidadePecas;
+    if (livres == 0) {
+        return;
+    }
+    
+    // Apenas as posições livres são sorteadas, e a inserção é feita em lote
+    preencherTiposPecas(&sessaoPtr->gerador, tipos, livres);
+    for (int i = 0; i < livres; i++) {
+        novasPecas[i] = criarPeca(tipos[i], sessaoPtr->proximoId++);
+    }
+    inserirPecasNaFila(&sessaoPtr->fila, novasPecas, livres);
+    registrarEventoLog(sessaoPtr->log, EVENTO_REABASTECIMENTO, 0, novasPecas[0], livres);
+}
+
+/**
+ * @brief Deriva a semente de uma partida a partir da semente base
+ * @param sementeBase Semente informada pelo usuário
+ * @param indice Índice da partida
+ * @return Semente independente para a partida
+ * 
+ * Usa a função de mistura do SplitMix64, de modo que o resultado de cada
+ * partida não depende de qual thread a executou nem da ordem de execução.
+ */
+uint64_t derivarSemente(uint64_t sementeBase, long long indice) {
+    uint64_t z = (sementeBase << 32) + (uint64_t)indice;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Transfere uma peça da fila para a pilha
+ * @param filaPtr Ponteiro para a fila
+ * @param pilhaPtr Ponteiro para a pilha
+ */
+void transferirPecaFilaParaPilha(FilaCircular* filaPtr, PilhaReserva* pilhaPtr) {
+    if (!filaVazia(filaPtr) && !pilhaCheia(pilhaPtr)) {
+        Peca peca = jogarPecaDaFila(filaPtr);
+        reservarPeca(pilhaPtr, peca);
+        if (!modoSilencioso) {
+            printf("Peca %c transferida da fila para a pilha de reserva.\n", peca.tipo);
+        }
+    }
+}
+
+/**
+ * @brief Exibe o estado completo do sistema
+ * @param filaPtr Ponteiro para a fila
+ * @param pilhaPtr Ponteiro para a pilha
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ */
+void exibirEstadoCompleto(FilaCircular* filaPtr, PilhaReserva* pilhaPtr, SistemaExpert* sistemaPtr) {
+    QuadroTerminal quadro;
+    inicializarQuadroTerminal(&quadro);
+    escreverLinhaQuadro(&quadro, "");
+    escreverLinhaQuadro(&quadro, "===============================================================");
+    escreverLinhaQuadro(&quadro, "                    ESTADO ATUAL DO SISTEMA");
+    escreverLinhaQuadro(&quadro, "===============================================================");
+    
+    // Uma única escrita para a tela inteira (24 linhas)
+    comporFila(&quadro, filaPtr);
+    comporPilha(&quadro, pilhaPtr);
+    escreverLinhaQuadro(&quadro, "");
+    comporEstatisticasExpert(&quadro, sistemaPtr);
+    emitirQuadroTerminal(&quadro);
+}
+
+/**
+ * @brief Exibe o menu principal
+ */
+void exibirMenu() {
+    printf("\n+==============================================================+\n");
+    printf("|                    TETRIS EXPERT SYSTEM                     |\n");
+    printf("+==============================================================+\n");
+    printf("| 1. Jogar peca da fila                                       |\n");
+    printf("| 2. Jogar peca da pilha de reserva                           |\n");
+    printf("| 3. Transferir peca da fila para reserva                     |\n");
+    printf("| 4. Gerar novas pecas aleatorias                             |\n");
+    printf("| 5. Exibir estado completo                                   |\n");
+    printf("| 6. Exibir estatisticas Expert                               |\n");
+    printf("| 7. Otimizar sistema Expert                                  |\n");
+    printf("| 8. Gerar relatorio Expert                                   |\n");
+    printf("| 9. Salvar estado (snapshot)                                 |\n");
+    printf("| 10. Carregar estado (snapshot)                              |\n");
+    printf("| 11. Sugerir jogada (conselheiro)                            |\n");
+    printf("| 12. Instrumentacao do motor                                 |\n");
+    printf("| 0. Sair                                                     |\n");
+    printf("+==============================================================+\n");
+    printf("Escolha uma opcao: ");
+}
+
+/**
+ * @brief Pausa a execução aguardando entrada do usuário
+ */
+void pausarExecucao() {
+    printf("\nPressione Enter para continuar...");
+    getchar();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                          POOL DE SESSÕES (LAJES ALINHADAS)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Prepara um pool vazio (as lajes são alocadas sob demanda)
+ * @param poolPtr Pool
+ * @param tamanhoSlot Bytes por slot (ao menos sizeof(SessaoJogo), no máximo
+ *                    BYTES_LAJE_POOL - CABECALHO_LAJE_POOL); é arredondado para múltiplo de 64
+ */
+void inicializarPoolSessoes(PoolSessoes* poolPtr, size_t tamanhoSlot) {
+    if (tamanhoSlot < sizeof(SessaoJogo)) {
+        tamanhoSlot = sizeof(SessaoJogo);
+    }
+    memset(poolPtr, 0, sizeof(*poolPtr));
+    poolPtr->tamanhoSlot = (tamanhoSlot + 63) / 64 * 64;
+    poolPtr->slotsPorLaje = (int)((BYTES_LAJE_POOL - CABECALHO_LAJE_POOL) / poolPtr->tamanhoSlot);
+    if (poolPtr->slotsPorLaje > SLOTS_MAXIMOS_LAJE_POOL) {
+        poolPtr->slotsPorLaje = SLOTS_MAXIMOS_LAJE_POOL;
+    }
+}
+
+/**
+ * @brief Devolve ao sistema todas as lajes do pool
+ * @param poolPtr Pool (as sessões ainda em uso deixam de ser válidas)
+ */
+void liberarPoolSessoes(PoolSessoes* poolPtr) {
+    while (poolPtr->lajes != NULL) {
+        LajePoolSessoes* proxima = poolPtr->lajes->proxima;
+        free(poolPtr->lajes);
+        poolPtr->lajes = proxima;
+    }
+    poolPtr->livres = NULL;
+    poolPtr->emUso = 0;
+}
+
+/**
+ * @brief Endereço do slot i de uma laje
+ */
+static inline unsigned char* slotLajePool(const PoolSessoes* poolPtr, LajePoolSessoes* lajePtr, int indice) {
+    return (unsigned char*)lajePtr + CABECALHO_LAJE_POOL + (size_t)indice * poolPtr->tamanhoSlot;
+}
+
+/**
+ * @brief Laje que contém um slot e a posição do slot nela
+ */
+static inline LajePoolSessoes* lajeDoSlotPool(const PoolSessoes* poolPtr, const void* slot, int* indicePtr) {
+    LajePoolSessoes* lajePtr = (LajePoolSessoes*)((uintptr_t)slot & ~(uintptr_t)(BYTES_LAJE_POOL - 1));
+    *indicePtr = (int)(((const unsigned char*)slot - (const unsigned char*)lajePtr - CABECALHO_LAJE_POOL) /
+                       poolPtr->tamanhoSlot);
+    return lajePtr;
+}
+
+/**
+ * @brief Aloca uma laje nova e põe seus slots na lista de livres
+ * @return 1 em caso de sucesso, 0 se faltou memória
+ */
+static int acrescentarLajePool(PoolSessoes* poolPtr) {
+    void* bloco;
+    if (poolPtr->slotsPorLaje == 0 || posix_memalign(&bloco, BYTES_LAJE_POOL, BYTES_LAJE_POOL) != 0) {
+        return 0;
+    }
+    
+    LajePoolSessoes* lajePtr = bloco;
+    lajePtr->proxima = poolPtr->lajes;
+    lajePtr->ocupados = 0;
+    poolPtr->lajesAlocadas++;
+    poolPtr->lajes = lajePtr;
+    
+    // Empilhados do último para o primeiro: a laje é entregue em ordem de endereço
+    for (int i = poolPtr->slotsPorLaje - 1; i >= 0; i--) {
+        void** slot = (void**)slotLajePool(poolPtr, lajePtr, i);
+        *slot = poolPtr->livres;
+        poolPtr->livres = slot;
+    }
+    return 1;
+}
+
+/**
+ * @brief Aloca e inicializa várias sessões de uma vez
+ * @param poolPtr Pool
+ * @param destino Recebe os ponteiros das sessões
+ * @param quantidade Sessões pedidas
+ * @param sementeBase Semente base (cada sessão usa derivarSemente(sementeBase, primeiroIndice + i))
+ * @param primeiroIndice Índice da primeira sessão
+ * @param modo Modo de sorteio das peças
+ * @return Sessões alocadas (menos que quantidade só se faltou memória)
+ * 
+ * O resultado equivale a inicializarSessaoJogo em cada sessão, mas só a
+ * primeira é inicializada campo a campo: as demais copiam a primeira em
+ * bloco e apenas semeiam o próprio gerador.
+ */
+int alocarSessoesPool(PoolSessoes* poolPtr, SessaoJogo** destino, int quantidade, uint64_t sementeBase,
+                      long long primeiroIndice, ModoGeradorPecas modo) {
+    int alocadas = 0;
+    
+    for (; alocadas < quantidade; alocadas++) {
+        if (poolPtr->livres == NULL && !acrescentarLajePool(poolPtr)) {
+            break;
+        }
+        void** slot = poolPtr->livres;
+        poolPtr->livres = *slot;
+        int indice;
+        LajePoolSessoes* lajePtr = lajeDoSlotPool(poolPtr, slot, &indice);
+        lajePtr->ocupados |= 1ULL << indice;
+        lajePtr->indiceSessao[indice] = primeiroIndice + alocadas;
+        
+        SessaoJogo* sessaoPtr = (SessaoJogo*)slot;
+        uint64_t semente = derivarSemente(sementeBase, primeiroIndice + alocadas);
+        if (alocadas == 0) {
+            inicializarSessaoJogo(sessaoPtr, semente, modo);
+        } else {
+            memcpy(sessaoPtr, destino[0], sizeof(SessaoJogo));
+            inicializarGeradorPecas(&sessaoPtr->gerador, semente, modo);
+        }
+        destino[alocadas] = sessaoPtr;
+    }
+    
+    poolPtr->emUso += alocadas;
+    poolPtr->alocacoes += alocadas;
+    if (poolPtr->emUso > poolPtr->maiorEmUso) {
+        poolPtr->maiorEmUso = poolPtr->emUso;
+    }
+    return alocadas;
+}
+
+/**
+ * @brief Devolve o slot de uma sessão ao pool
+ * @param poolPtr Pool de onde a sessão veio
+ * @param sessaoPtr Sessão (deixa de ser válida)
+ */
+void liberarSessaoPool(PoolSessoes* poolPtr, SessaoJogo* sessaoPtr) {
+    int indice;
+    LajePoolSessoes* lajePtr = lajeDoSlotPool(poolPtr, sessaoPtr, &indice);
+    lajePtr->ocupados &= ~(1ULL << indice);
+    
+    void** slot = (void**)sessaoPtr;
+    *slot = poolPtr->livres;
+    poolPtr->livres = slot;
+    poolPtr->emUso--;
+    poolPtr->liberacoes++;
+}
+
+/**
+ * @brief Reinicia todas as sessões em uso, laje por laje
+ * @param poolPtr Pool
+ * @param sementeBase Semente base
+ * @param modo Modo de sorteio das peças
+ * 
+ * Equivale a inicializarSessaoJogo em cada sessão ocupada, percorrendo a
+ * memória em ordem: uma sessão modelo é copiada em bloco e só o gerador
+ * é semeado por sessão. A semente é derivarSemente(sementeBase, índice com
+ * que a sessão foi alocada), a mesma que alocarSessoesPool daria com essa
+ * semente base. Os dados do chamador após a sessão no slot são preservados.
+ */
+void reinicializarSessoesPool(PoolSessoes* poolPtr, uint64_t sementeBase, ModoGeradorPecas modo) {
+    SessaoJogo modelo;
+    inicializarSessaoJogo(&modelo, 0, modo);
+    
+    for (LajePoolSessoes* lajePtr = poolPtr->lajes; lajePtr != NULL; lajePtr = lajePtr->proxima) {
+        for (uint64_t ocupados = lajePtr->ocupados; ocupados != 0; ocupados &= ocupados - 1) {
+#if defined(__GNUC__)
+            int indice = __builtin_ctzll(ocupados);
+#else
+            int indice = 0;
+            while (!((ocupados >> indice) & 1u)) {
+                indice++;
+            }
+#endif
+            SessaoJogo* sessaoPtr = (SessaoJogo*)slotLajePool(poolPtr, lajePtr, indice);
+            memcpy(sessaoPtr, &modelo, sizeof(SessaoJogo));
+            inicializarGeradorPecas(&sessaoPtr->gerador,
+                                    derivarSemente(sementeBase, lajePtr->indiceSessao[indice]), modo);
+        }
+    }
+}
+
+/**
+ * @brief Exibe a ocupação do pool de sessões
+ * @param poolPtr Pool
+ */
+void exibirOcupacaoPool(const PoolSessoes* poolPtr) {
+    long long capacidade = poolPtr->lajesAlocadas * poolPtr->slotsPorLaje;
+    printf("   * Pool de sessoes: %lld de %lld slots em uso (%.1f%%)  |  Pico: %lld  |  %lld lajes de %d slots x %d bytes\n",
+           poolPtr->emUso, capacidade, capacidade > 0 ? 100.0 * poolPtr->emUso / capacidade : 0.0,
+           poolPtr->maiorEmUso, poolPtr->lajesAlocadas, poolPtr->slotsPorLaje, (int)poolPtr->tamanhoSlot);
+    printf("   * Alocacoes: %lld  |  Liberacoes: %lld\n", poolPtr->alocacoes, poolPtr->liberacoes);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                      ALIMENTADOR DE PEÇAS (ANEL SPSC)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Publica no anel as peças que couberem, em lotes de LOTE_ALIMENTADOR
+ * @param alimentadorPtr Alimentador (chamado apenas pelo lado produtor)
+ * @return Peças publicadas (0 = anel cheio)
+ */
+static int produzirPecasAlimentador(AlimentadorPecas* alimentadorPtr) {
+    unsigned int cauda = alimentadorPtr->cauda;
+    unsigned int livres = CAPACIDADE_ALIMENTADOR - (cauda - alimentadorPtr->cabecaVista);
+    if (livres < LOTE_ALIMENTADOR) {
+        alimentadorPtr->cabecaVista = __atomic_load_n(&alimentadorPtr->cabeca, __ATOMIC_ACQUIRE);
+        livres = CAPACIDADE_ALIMENTADOR - (cauda - alimentadorPtr->cabecaVista);
+        if (livres < LOTE_ALIMENTADOR) {
+            return 0;
+        }
+    }
+    
+    char tipos[LOTE_ALIMENTADOR];
+    preencherTiposPecas(&alimentadorPtr->gerador, tipos, LOTE_ALIMENTADOR);
+    for (int i = 0; i < LOTE_ALIMENTADOR; i++) {
+        alimentadorPtr->pecas[(cauda + i) & (CAPACIDADE_ALIMENTADOR - 1)] =
+            criarPeca(tipos[i], alimentadorPtr->proximoId++);
+    }
+    // As peças ficam visíveis ao consumidor junto com a nova cauda
+    __atomic_store_n(&alimentadorPtr->cauda, cauda + LOTE_ALIMENTADOR, __ATOMIC_RELEASE);
+    alimentadorPtr->produzidas += LOTE_ALIMENTADOR;
+    return LOTE_ALIMENTADOR;
+}
+
+/**
+ * @brief Laço da thread produtora: mantém o anel cheio até o encerramento
+ * @param argumento AlimentadorPecas*
+ */
+static void* executarProdutorAlimentador(void* argumento) {
+    AlimentadorPecas* alimentadorPtr = argumento;
+    
+    while (!__atomic_load_n(&alimentadorPtr->encerrando, __ATOMIC_ACQUIRE)) {
+        if (produzirPecasAlimentador(alimentadorPtr) == 0) {
+            alimentadorPtr->esperasCheio++;
+            struct timespec espera = {0, ESPERA_ALIMENTADOR_NS};
+            nanosleep(&espera, NULL);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prepara o alimentador, enche o anel e inicia a thread produtora
+ * @param alimentadorPtr Alimentador
+ * @param geradorPtr Estado inicial do gerador do produtor (copiado)
+ * @param proximoId ID da primeira peça produzida
+ * @return 1 em caso de sucesso, 0 se a thread não pôde ser criada
+ * 
+ * O anel sai cheio daqui, então as primeiras retiradas nunca faltam.
+ */
+int iniciarAlimentadorPecas(AlimentadorPecas* alimentadorPtr, const GeradorPecas* geradorPtr, int proximoId) {
+    memset(alimentadorPtr, 0, offsetof(AlimentadorPecas, pecas));
+    redefinirAlimentadorPecas(alimentadorPtr, geradorPtr, proximoId);
+    return retomarAlimentadorPecas(alimentadorPtr);
+}
+
+/**
+ * @brief Encerra a thread produtora, preservando o anel e o gerador
+ * @param alimentadorPtr Alimentador
+ * 
+ * Depois dela o estado do produtor (gerador, proximoId) pode ser lido
+ * ou trocado com segurança pela thread do jogo.
+ */
+void pararAlimentadorPecas(AlimentadorPecas* alimentadorPtr) {
+    if (!alimentadorPtr->ativo) {
+        return;
+    }
+    __atomic_store_n(&alimentadorPtr->encerrando, 1, __ATOMIC_RELEASE);
+    pthread_join(alimentadorPtr->thread, NULL);
+    alimentadorPtr->ativo = 0;
+}
+
+/**
+ * @brief Reinicia a thread produtora de onde ela parou
+ * @param alimentadorPtr Alimentador parado
+ * @return 1 em caso de sucesso, 0 se a thread não pôde ser criada
+ */
+int retomarAlimentadorPecas(AlimentadorPecas* alimentadorPtr) {
+    alimentadorPtr->encerrando = 0;
+    if (pthread_create(&alimentadorPtr->thread, NULL, executarProdutorAlimentador, alimentadorPtr) != 0) {
+        return 0;
+    }
+    alimentadorPtr->ativo = 1;
+    return 1;
+}
+
+/**
+ * @brief Descarta as peças do anel e troca o estado do produtor
+ * @param alimentadorPtr Alimentador parado
+ * @param geradorPtr Novo estado do gerador (copiado)
+ * @param proximoId ID da próxima peça produzida
+ * 
+ * Usada ao carregar um snapshot; o anel é reabastecido antes de retornar.
+ */
+void redefinirAlimentadorPecas(AlimentadorPecas* alimentadorPtr, const GeradorPecas* geradorPtr, int proximoId) {
+    alimentadorPtr->gerador = *geradorPtr;
+    alimentadorPtr->proximoId = proximoId;
+    alimentadorPtr->cauda = alimentadorPtr->cabecaVista = 0;
+    alimentadorPtr->cabeca = alimentadorPtr->caudaVista = 0;
+    while (produzirPecasAlimentador(alimentadorPtr) > 0) {
+    }
+}
+
+/**
+ * @brief Retira peças do anel sem esperar pelo produtor
+ * @param alimentadorPtr Alimentador (chamado apenas pela thread do jogo)
+ * @param destino Recebe as peças, na ordem de produção
+ * @param quantidade Peças desejadas
+ * @return Peças retiradas; menos que quantidade conta como falta
+ */
+int retirarPecasAlimentador(AlimentadorPecas* alimentadorPtr, Peca* destino, int quantidade) {
+    unsigned int cabeca = alimentadorPtr->cabeca;
+    unsigned int disponiveis = alimentadorPtr->caudaVista - cabeca;
+    if (disponiveis < (unsigned int)quantidade) {
+        alimentadorPtr->caudaVista = __atomic_load_n(&alimentadorPtr->cauda, __ATOMIC_ACQUIRE);
+        disponiveis = alimentadorPtr->caudaVista - cabeca;
+    }
+    
+    int retiradas = disponiveis < (unsigned int)quantidade ? (int)disponiveis : quantidade;
+    for (int i = 0; i < retiradas; i++) {
+        destino[i] = alimentadorPtr->pecas[(cabeca + i) & (CAPACIDADE_ALIMENTADOR - 1)];
+    }
+    // Devolve as posições ao produtor só depois de copiar as peças
+    __atomic_store_n(&alimentadorPtr->cabeca, cabeca + retiradas, __ATOMIC_RELEASE);
+    
+    alimentadorPtr->consumidas += retiradas;
+    if (retiradas < quantidade) {
+        alimentadorPtr->faltas++;
+        alimentadorPtr->pecasFaltantes += quantidade - retiradas;
+    }
+    return retiradas;
+}
+
+/**
+ * @brief Completa a fila com peças do alimentador
+ * @param alimentadorPtr Alimentador
+ * @param filaPtr Fila a completar
+ * @param logPtr Log de jogadas (NULL = não registrar)
+ * @return Peças inseridas (menos que as posições livres se o anel faltou)
+ * 
+ * Substitui gerarPecasAleatorias quando o alimentador está ativo: o
+ * sorteio já foi feito pela thread produtora.
+ */
+int abastecerFilaAlimentador(AlimentadorPecas* alimentadorPtr, FilaCircular* filaPtr, LogJogadas* logPtr) {
+    Peca novasPecas[CAPACIDADE_FILA];
+    int livres = CAPACIDADE_FILA - filaPtr->quantidadePecas;
+    if (livres == 0) {
+        return 0;
+    }
+    
+    int retiradas = retirarPecasAlimentador(alimentadorPtr, novasPecas, livres);
+    if (retiradas > 0) {
+        inserirPecasNaFila(filaPtr, novasPecas, retiradas);
+        registrarEventoLog(logPtr, EVENTO_REABASTECIMENTO, 0, novasPecas[0], retiradas);
+    }
+    return retiradas;
+}
+
+/**
+ * @brief Exibe os contadores do alimentador de peças
+ * @param alimentadorPtr Alimentador (de preferência parado, para números exatos)
+ */
+void exibirEstatisticasAlimentador(const AlimentadorPecas* alimentadorPtr) {
+    printf("   * Alimentador de pecas: %lld produzidas  |  %lld consumidas  |  %u no anel\n",
+           alimentadorPtr->produzidas, alimentadorPtr->consumidas,
+           alimentadorPtr->cauda - alimentadorPtr->cabeca);
+    printf("   * Contrapressao: %lld esperas com anel cheio  |  Faltas: %lld (%lld pecas)\n",
+           alimentadorPtr->esperasCheio, alimentadorPtr->faltas, alimentadorPtr->pecasFaltantes);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                          TABULEIRO (POÇO EM BITBOARD)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// Linha completa replicada nas quatro faixas de 16 bits de uma palavra
+#define LINHAS_CHEIAS_TABULEIRO ((uint64_t)LINHA_CHEIA_TABULEIRO * 0x0001000100010001ULL)
+
+/**
+ * @brief Lê quatro linhas consecutivas do poço como uma palavra de 64 bits
+ * @param tabuleiroPtr Poço
+ * @param linha Primeira linha (faixa 0)
+ * 
+ * A máscara da peça é montada da mesma forma, então a ordem das faixas
+ * dentro da palavra não depende da arquitetura.
+ */
+static inline uint64_t lerLinhasTabuleiro(const TabuleiroJogo* tabuleiroPtr, int linha) {
+    uint64_t palavra;
+    memcpy(&palavra, &tabuleiroPtr->linhas[linha], sizeof(palavra));
+    return palavra;
+}
+
+/**
+ * @brief Máscara de 64 bits de uma peça encostada na coluna 0
+ */
+static inline uint64_t mascaraPecaTabuleiro(int tipo, int rotacao) {
+    uint64_t mascara;
+    memcpy(&mascara, linhasPecaTabuleiro[tipo][rotacao], sizeof(mascara));
+    return mascara;
+}
+
+/**
+ * @brief Conta os bits de uma linha do poço
+ */
+static inline int contarBitsLinha(unsigned int linha) {
+#if defined(__GNUC__)
+    return __builtin_popcount(linha);
+#else
+    int total = 0;
+    for (; linha != 0; linha &= linha - 1) {
+        total++;
+    }
+    return total;
+#endif
+}
+
+/**
+ * @brief Esvazia o poço e zera seus contadores
+ * @param tabuleiroPtr Poço
+ */
+void inicializarTabuleiro(TabuleiroJogo* tabuleiroPtr) {
+    memset(tabuleiroPtr, 0, sizeof(*tabuleiroPtr));
+}
+
+/**
+ * @brief Testa se uma peça sobrepõe blocos do poço
+ * @param tabuleiroPtr Poço
+ * @param tipo TipoPeca (exceto PECA_DESCONHECIDA)
+ * @param rotacao Rotação, de 0 a ROTACOES_PECA - 1
+ * @param coluna Coluna do bloco mais à esquerda (a peça deve caber na largura)
+ * @param linha Linha da base da peça (de 0 a ALTURA_TABULEIRO - altura da peça)
+ * @return 1 se há colisão, 0 caso contrário
+ * 
+ * Um único AND de 64 bits cobre as quatro linhas da peça: o deslocamento
+ * pela coluna nunca atravessa a faixa de 16 bits de uma linha.
+ */
+int colideTabuleiro(const TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna, int linha) {
+    return (lerLinhasTabuleiro(tabuleiroPtr, linha) & (mascaraPecaTabuleiro(tipo, rotacao) << coluna)) != 0;
+}
+
+/**
+ * @brief Calcula onde uma peça para ao cair em uma coluna
+ * @param tabuleiroPtr Poço
+ * @param tipo TipoPeca
+ * @param rotacao Rotação
+ * @param coluna Coluna do bloco mais à esquerda
+ * @return Linha da base da peça após a queda, ou -1 se ela não cabe no topo
+ * 
+ * Acima de alturaOcupada não há blocos, então a queda só é testada a
+ * partir dali, uma palavra de 64 bits por linha.
+ */
+int soltarPecaTabuleiro(const TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna) {
+    uint64_t mascara = mascaraPecaTabuleiro(tipo, rotacao) << coluna;
+    int linha = ALTURA_TABULEIRO - alturaPecaTabuleiro[tipo][rotacao];
+    
+    if (tabuleiroPtr->alturaOcupada < linha) {
+        linha = tabuleiroPtr->alturaOcupada;
+    } else if (lerLinhasTabuleiro(tabuleiroPtr, linha) & mascara) {
+        return -1;
+    }
+    while (linha > 0 && !(lerLinhasTabuleiro(tabuleiroPtr, linha - 1) & mascara)) {
+        linha--;
+    }
+    return linha;
+}
+
+/**
+ * @brief Fixa uma peça no poço e remove as linhas que ela completou
+ * @param tabuleiroPtr Poço
+ * @param tipo TipoPeca
+ * @param rotacao Rotação
+ * @param coluna Coluna do bloco mais à esquerda
+ * @param linha Linha da base (normalmente o retorno de soltarPecaTabuleiro)
+ * @return Quantidade de linhas removidas (0 a 4)
+ * 
+ * A detecção é feita nas quatro linhas tocadas de uma só vez: após o XOR
+ * com LINHAS_CHEIAS_TABULEIRO, uma linha completa vira uma faixa de 16
+ * bits zerada, e o teste clássico de faixa nula (SWAR) as encontra sem
+ * desvios. Só quando há alguma linha completa o poço é compactado.
+ */
+int fixarPecaTabuleiro(TabuleiroJogo* tabuleiroPtr, int tipo, int rotacao, int coluna, int linha) {
+    uint64_t palavra = lerLinhasTabuleiro(tabuleiroPtr, linha) | (mascaraPecaTabuleiro(tipo, rotacao) << coluna);
+    memcpy(&tabuleiroPtr->linhas[linha], &palavra, sizeof(palavra));
+    
+    int topo = linha + alturaPecaTabuleiro[tipo][rotacao];
+    if (topo > tabuleiroPtr->alturaOcupada) {
+        tabuleiroPtr->alturaOcupada = topo;
+    }
+    tabuleiroPtr->pecasColocadas++;
+    
+    uint64_t diferenca = palavra ^ LINHAS_CHEIAS_TABULEIRO;
+    if (((diferenca - 0x0001000100010001ULL) & ~diferenca & 0x8000800080008000ULL) == 0) {
+        return 0;
+    }
+    
+    // Compactar: as linhas acima das completas descem
+    int destino = linha;
+    for (int origem = linha; origem < tabuleiroPtr->alturaOcupada; origem++) {
+        uint16_t conteudo = tabuleiroPtr->linhas[origem];
+        tabuleiroPtr->linhas[destino] = conteudo;
+        destino += (conteudo != LINHA_CHEIA_TABULEIRO);
+    }
+    int removidas = tabuleiroPtr->alturaOcupada - destino;
+    memset(&tabuleiroPtr->linhas[destino], 0, (size_t)removidas * sizeof(uint16_t));
+    tabuleiroPtr->alturaOcupada = destino;
+    tabuleiroPtr->linhasRemovidas += removidas;
+    return removidas;
+}
+
+/**
+ * @brief Calcula a altura de cada coluna do poço
+ * @param tabuleiroPtr Poço
+ * @param alturas Recebe LARGURA_TABULEIRO alturas (linha do bloco mais alto + 1)
+ * @return Quantidade de blocos no poço
+ * 
+ * Percorre o poço de cima para baixo acumulando em uma máscara as colunas
+ * que já têm bloco acima; cada bit novo na máscara fixa uma altura.
+ */
+static int calcularAlturasTabuleiro(const TabuleiroJogo* tabuleiroPtr, int alturas[LARGURA_TABULEIRO]) {
+    unsigned int acima = 0;
+    int blocos = 0;
+    
+    memset(alturas, 0, LARGURA_TABULEIRO * sizeof(int));
+    for (int linha = tabuleiroPtr->alturaOcupada - 1; linha >= 0; linha--) {
+        unsigned int conteudo = tabuleiroPtr->linhas[linha];
+        unsigned int novas = conteudo & ~acima;
+        for (; novas != 0; novas &= novas - 1) {
+#if defined(__GNUC__)
+            alturas[__builtin_ctz(novas)] = linha + 1;
+#else
+            int coluna = 0;
+            while (!((novas >> coluna) & 1u)) {
+                coluna++;
+            }
+            alturas[coluna] = linha + 1;
+#endif
+        }
+        acima |= conteudo;
+        blocos += contarBitsLinha(conteudo);
+    }
+    return blocos;
+}
+
+/**
+ * @brief Parte da nota do poço que depende só das alturas das colunas
+ * @param alturas Alturas das colunas
+ * @return -87 x altura agregada - 18 x irregularidade
+ */
+static int avaliarAlturasTabuleiro(const int alturas[LARGURA_TABULEIRO]) {
+    int alturaAgregada = alturas[0];
+    int irregularidade = 0;
+    
+    for (int coluna = 1; coluna < LARGURA_TABULEIRO; coluna++) {
+        int degrau = alturas[coluna] - alturas[coluna - 1];
+        alturaAgregada += alturas[coluna];
+        irregularidade += degrau < 0 ? -degrau : degrau;
+    }
+    return -87 * alturaAgregada - 18 * irregularidade;
+}
+
+/**
+ * @brief Avalia a superfície do poço (maior = melhor)
+ * @param tabuleiroPtr Poço
+ * @return Nota heurística: -51 x altura agregada - 36 x buracos - 18 x irregularidade
+ * 
+ * Os pesos seguem a heurística clássica de quatro termos (o quarto, linhas
+ * completadas, é somado por enumerarColocacoes). Toda célula abaixo do
+ * topo de uma coluna é bloco ou buraco, então buracos = altura agregada -
+ * blocos, e a nota se reduz a -87 x altura agregada + 36 x blocos - 18 x
+ * irregularidade: fora os blocos, só depende das alturas.
+ */
+int avaliarTabuleiro(const TabuleiroJogo* tabuleiroPtr) {
+    int alturas[LARGURA_TABULEIRO];
+    int blocos = calcularAlturasTabuleiro(tabuleiroPtr, alturas);
+    return avaliarAlturasTabuleiro(alturas) + 36 * blocos;
+}
+
+/**
+ * @brief Aloca um cache de colocações vazio
+ * @param cachePtr Cache a inicializar
+ * @param bits Log2 da quantidade de entradas (1 a 30)
+ * @return 1 em caso de sucesso, 0 se faltou memória
+ */
+int inicializarCacheColocacoes(CacheColocacoes* cachePtr, int bits) {
+    size_t entradas = (size_t)1 << bits;
+    void* bloco;
+    
+    cachePtr->consultas = 0;
+    cachePtr->acertos = 0;
+    if (posix_memalign(&bloco, 64, entradas * sizeof(EntradaCacheColocacoes)) != 0) {
+        cachePtr->entradas = NULL;
+        return 0;
+    }
+    memset(bloco, 0, entradas * sizeof(EntradaCacheColocacoes));
+    cachePtr->entradas = bloco;
+    cachePtr->deslocamento = 64 - bits;
+    return 1;
+}
+
+/**
+ * @brief Libera a memória de um cache de colocações
+ * @param cachePtr Cache inicializado
+ */
+void liberarCacheColocacoes(CacheColocacoes* cachePtr) {
+    free(cachePtr->entradas);
+    cachePtr->entradas = NULL;
+}
+
+/**
+ * @brief Calcula, só pelas alturas, a queda e a nota parcial de cada colocação
+ * @param entradaPtr Entrada a preencher (a chave não é alterada)
+ * @param tipo TipoPeca
+ * @param relativas Alturas relativas à coluna mais baixa
+ * 
+ * A peça para na maior diferença entre a altura de uma coluna e o fundo
+ * da peça nela (fundoPecaTabuleiro); as colunas cobertas passam a ter o
+ * topo da peça (topoPecaTabuleiro) como altura, se ele for maior. Só as
+ * colunas cobertas e seus dois degraus vizinhos mudam, então a nota de
+ * cada colocação é a do poço atual corrigida em O(largura da peça).
+ */
+static void preencherEntradaColocacoes(EntradaCacheColocacoes* entradaPtr, int tipo, const int relativas[LARGURA_TABULEIRO]) {
+    int parcialAtual = avaliarAlturasTabuleiro(relativas);
+    int indice = 0;
+    
+    for (int rotacao = 0; rotacao < rotacoesDistintasPeca[tipo]; rotacao++) {
+        const unsigned char* fundo = fundoPecaTabuleiro[tipo][rotacao];
+        const unsigned char* topo = topoPecaTabuleiro[tipo][rotacao];
+        int largura = larguraPecaTabuleiro[tipo][rotacao];
+        
+        for (int coluna = 0; coluna <= LARGURA_TABULEIRO - largura; coluna++) {
+            int linha = 0;
+            for (int x = 0; x < largura; x++) {
+                if (relativas[coluna + x] - fundo[x] > linha) {
+                    linha = relativas[coluna + x] - fundo[x];
+                }
+            }
+            
+            // Alturas novas da coluna coluna - 1 até coluna + largura
+            int novas[6];
+            int acrescimo = 0;
+            for (int x = -1; x <= largura; x++) {
+                int c = coluna + x;
+                int altura = (c < 0 || c >= LARGURA_TABULEIRO) ? 0 : relativas[c];
+                if (x >= 0 && x < largura && linha + topo[x] > altura) {
+                    acrescimo += linha + topo[x] - altura;
+                    altura = linha + topo[x];
+                }
+                novas[x + 1] = altura;
+            }
+            int variacaoDegraus = 0;
+            for (int x = -1; x < largura; x++) {
+                int c = coluna + x;
+                if (c < 0 || c + 1 >= LARGURA_TABULEIRO) {
+                    continue;
+                }
+                int antes = relativas[c + 1] - relativas[c];
+                int depois = novas[x + 2] - novas[x + 1];
+                variacaoDegraus += (depois < 0 ? -depois : depois) - (antes < 0 ? -antes : antes);
+            }
+            entradaPtr->linhas[indice] = (uint8_t)linha;
+            entradaPtr->parciais[indice] = parcialAtual - 87 * acrescimo - 18 * variacaoDegraus;
+            indice++;
+        }
+    }
+}
+
+/**
+ * @brief Enumera todas as posições em que uma peça pode parar, com suas notas
+ * @param tabuleiroPtr Poço (não é modificado; seu cache, se houver, é atualizado)
+ * @param tipo TipoPeca
+ * @param colocacoes Recebe as colocações, por rotação e depois por coluna
+ * @return Quantidade de colocações (0 se a peça não cabe no poço)
+ * 
+ * As quedas e as notas de todas as colocações dependem apenas das alturas
+ * das colunas, relativas à mais baixa: essa assinatura indexa o cache do
+ * poço, e só na falta dele elas são recalculadas. Por colocação resta
+ * testar o topo e, com um XOR de 64 bits, se alguma linha se completa;
+ * só nesse caso, ou quando uma coluna passa da linha em que a peça surge,
+ * o poço é copiado, fixado e avaliado por inteiro.
+ * O resultado é o mesmo de soltarPecaTabuleiro seguido de
+ * fixarPecaTabuleiro e avaliarTabuleiro em uma cópia.
+ */
+int enumerarColocacoes(const TabuleiroJogo* tabuleiroPtr, int tipo, ColocacaoPeca colocacoes[COLOCACOES_MAXIMAS_PECA]) {
+    int alturas[LARGURA_TABULEIRO];
+    int blocos = calcularAlturasTabuleiro(tabuleiroPtr, alturas);
+    
+    int base = alturas[0];
+    for (int coluna = 1; coluna < LARGURA_TABULEIRO; coluna++) {
+        if (alturas[coluna] < base) {
+            base = alturas[coluna];
+        }
+    }
+    uint64_t chave = (uint64_t)(tipo + 1);
+    for (int coluna = 0; coluna < LARGURA_TABULEIRO; coluna++) {
+        alturas[coluna] -= base;
+        chave = chave << 5 | (uint64_t)alturas[coluna];
+    }
+    
+    EntradaCacheColocacoes local;
+    EntradaCacheColocacoes* entradaPtr = &local;
+    CacheColocacoes* cachePtr = tabuleiroPtr->cache;
+    if (cachePtr != NULL) {
+        entradaPtr = &cachePtr->entradas[(chave * 0x9E3779B97F4A7C15ULL) >> cachePtr->deslocamento];
+        cachePtr->consultas++;
+        if (entradaPtr->chave == chave) {
+            cachePtr->acertos++;
+        } else {
+            preencherEntradaColocacoes(entradaPtr, tipo, alturas);
+            entradaPtr->chave = chave;
+        }
+    } else {
+        preencherEntradaColocacoes(entradaPtr, tipo, alturas);
+    }
+    
+    // Nota sem linhas removidas: parcial das alturas + base comum + blocos da peça
+    int constante = -87 * LARGURA_TABULEIRO * base + 36 * (blocos + 4);
+    int quantidade = 0;
+    int indice = 0;
+    for (int rotacao = 0; rotacao < rotacoesDistintasPeca[tipo]; rotacao++) {
+        uint64_t mascara = mascaraPecaTabuleiro(tipo, rotacao);
+        int ultimaLinha = ALTURA_TABULEIRO - alturaPecaTabuleiro[tipo][rotacao];
+        int ultimaColuna = LARGURA_TABULEIRO - larguraPecaTabuleiro[tipo][rotacao];
+        
+        for (int coluna = 0; coluna <= ultimaColuna; coluna++, indice++) {
+            int linha = base + entradaPtr->linhas[indice];
+            int pelasAlturas = linha <= ultimaLinha;
+            if (!pelasAlturas) {
+                // Uma coluna passa da linha em que a peça surge: a queda
+                // começa ali, sob esse bloco, e as alturas não bastam
+                linha = soltarPecaTabuleiro(tabuleiroPtr, tipo, rotacao, coluna);
+                if (linha < 0) {
+                    continue;
+                }
+            }
+            
+            ColocacaoPeca* colocacaoPtr = &colocacoes[quantidade++];
+            colocacaoPtr->rotacao = rotacao;
+            colocacaoPtr->coluna = coluna;
+            colocacaoPtr->linha = linha;
+            
+            uint64_t diferenca = (lerLinhasTabuleiro(tabuleiroPtr, linha) | (mascara << coluna)) ^ LINHAS_CHEIAS_TABULEIRO;
+            if (pelasAlturas && ((diferenca - 0x0001000100010001ULL) & ~diferenca & 0x8000800080008000ULL) == 0) {
+                colocacaoPtr->linhasRemovidas = 0;
+                colocacaoPtr->avaliacao = entradaPtr->parciais[indice] + constante;
+            } else {
+                TabuleiroJogo copia = *tabuleiroPtr;
+                int linhas = fixarPecaTabuleiro(&copia, tipo, rotacao, coluna, linha);
+                colocacaoPtr->linhasRemovidas = linhas;
+                colocacaoPtr->avaliacao = 76 * linhas + avaliarTabuleiro(&copia);
+            }
+        }
+    }
+    return quantidade;
+}
+
+/**
+ * @brief Escolhe a melhor posição para uma peça, entre todas as rotações e colunas
+ * @param tabuleiroPtr Poço (não é modificado)
+ * @param tipo TipoPeca
+ * @param melhorPtr Recebe a colocação escolhida
+ * @return 1 se a peça cabe em alguma posição, 0 se o poço está cheio para ela
+ * 
+ * Empates ficam com a primeira candidata (menor rotação, menor coluna),
+ * o que mantém a escolha determinística para o replay.
+ */
+int escolherColocacao(const TabuleiroJogo* tabuleiroPtr, int tipo, ColocacaoPeca* melhorPtr) {
+    ColocacaoPeca colocacoes[COLOCACOES_MAXIMAS_PECA];
+    int quantidade = enumerarColocacoes(tabuleiroPtr, tipo, colocacoes);
+    if (quantidade == 0) {
+        return 0;
+    }
+    
+    int melhor = 0;
+    for (int i = 1; i < quantidade; i++) {
+        if (colocacoes[i].avaliacao > colocacoes[melhor].avaliacao) {
+            melhor = i;
+        }
+    }
+    *melhorPtr = colocacoes[melhor];
+    return 1;
+}
+
+/**
+ * @brief Coloca uma peça no poço na posição escolhida por escolherColocacao
+ * @param tabuleiroPtr Poço
+ * @param tipoPeca Tipo da peça ('X' e tipos desconhecidos são ignorados)
+ * @return Linhas removidas pela peça
+ * 
+ * Se a peça não cabe em nenhuma posição, a derrota é contada e a peça é
+ * colocada em um poço vazio, para que a partida continue.
+ */
+int posicionarPecaTabuleiro(TabuleiroJogo* tabuleiroPtr, char tipoPeca) {
+    int tipo = indiceTipoPeca(tipoPeca);
+    if (tipo == PECA_DESCONHECIDA) {
+        return 0;
+    }
+    
+    ColocacaoPeca colocacao;
+    if (!escolherColocacao(tabuleiroPtr, tipo, &colocacao)) {
+        tabuleiroPtr->derrotas++;
+        memset(tabuleiroPtr->linhas, 0, sizeof(tabuleiroPtr->linhas));
+        tabuleiroPtr->alturaOcupada = 0;
+        escolherColocacao(tabuleiroPtr, tipo, &colocacao);
+    }
+    return fixarPecaTabuleiro(tabuleiroPtr, tipo, colocacao.rotacao, colocacao.coluna, colocacao.linha);
+}
+
+/**
+ * @brief Calcula o bônus por linhas completadas de uma vez
+ * @param linhas Linhas removidas pela jogada (0 a 4)
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @return Pontos do bônus
+ * 
+ * Complementa calcularPontuacao: o bônus base (100, 300, 500 ou 800)
+ * recebe os mesmos multiplicador e fator de dificuldade da peça.
+ */
+int calcularPontuacaoLinhas(int linhas, const SistemaExpert* sistemaPtr) {
+    return (int)(bonusBasePorLinhas[linhas] * sistemaPtr->multiplicadorAtual * sistemaPtr->fatorDificuldade);
+}
+
+/**
+ * @brief Processa uma jogada colocando a peça no poço
+ * @param peca Peça jogada
+ * @param origem Origem da peça (0=fila, 1=pilha)
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ * @param tabuleiroPtr Poço da sessão
+ * @return Linhas removidas pela jogada
+ * 
+ * O bônus das linhas entra na pontuação antes de processarJogadaExpert,
+ * de modo que a progressão de nível e o recorde já o consideram.
+ */
+int processarJogadaTabuleiro(Peca peca, int origem, SistemaExpert* sistemaPtr, TabuleiroJogo* tabuleiroPtr) {
+    int linhas = posicionarPecaTabuleiro(tabuleiroPtr, peca.tipo);
+    int bonus = calcularPontuacaoLinhas(linhas, sistemaPtr);
+    
+    sistemaPtr->pontuacaoTotal += bonus;
+    sistemaPtr->pontuacaoNivel += bonus;
+    processarJogadaExpert(peca, origem, sistemaPtr);
+    sistemaPtr->pontosUltimaJogada += bonus;
+    return linhas;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                        PONTUAÇÃO EM LOTE (ESTRUTURA DE VETORES)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// Alinhamento das colunas do lote (uma linha de cache)
+#define ALINHAMENTO_LOTE 64
+
+/// Quantidade de colunas int32 por sessão no bloco do lote (campos + entradas)
+#define COLUNAS_INTEIRAS_LOTE 26
+
+/**
+ * @brief Reserva uma coluna alinhada dentro do bloco contíguo do lote
+ * @param cursorPtr Cursor de alocação (avança após a reserva)
+ * @param bytes Tamanho da coluna em bytes
+ * @return Início da coluna
+ * 
+ * Cada coluna é seguida de uma linha de cache de folga. Sem ela, lotes
+ * com capacidade potência de dois deixam todas as colunas no mesmo
+ * deslocamento módulo 4 KiB, e os acessos à posição i de cada coluna
+ * disputam o mesmo conjunto da L1 (medido: kernel escalar ~10x mais lento).
+ */
+static void* reservarColunaLote(char** cursorPtr, size_t bytes) {
+    void* coluna = *cursorPtr;
+    *cursorPtr += (bytes + ALINHAMENTO_LOTE - 1) / ALINHAMENTO_LOTE * ALINHAMENTO_LOTE + ALINHAMENTO_LOTE;
+    return coluna;
+}
+
+/**
+ * @brief Aloca um lote capaz de pontuar várias sessões por chamada
+ * @param lotePtr Ponteiro para o lote
+ * @param capacidade Número máximo de sessões
+ * @return 1 em caso de sucesso, 0 se a memória não pôde ser alocada
+ * 
+ * Todas as colunas ficam em um único bloco alinhado a 64 bytes. A
+ * capacidade é arredondada para múltiplo de 8 (largura do kernel AVX2).
+ * As sessões começam no estado de inicializarSistemaExpert.
+ */
+int inicializarLoteSistemasExpert(LoteSistemasExpert* lotePtr, int capacidade) {
+    int arredondada = (capacidade + 7) / 8 * 8;
+    size_t bytesInteiros = (size_t)arredondada * sizeof(int32_t);
+    size_t bytesTabela = bytesInteiros * TOTAL_TIPOS_PECA;
+    size_t bytesDoubles = (size_t)arredondada * sizeof(double);
+    size_t total = (COLUNAS_INTEIRAS_LOTE + 2 * TOTAL_TIPOS_PECA) * (bytesInteiros + 2 * ALINHAMENTO_LOTE)
+                 + 2 * (bytesDoubles + 2 * ALINHAMENTO_LOTE);
+    
+    void* bloco = NULL;
+    if (capacidade <= 0 || posix_memalign(&bloco, ALINHAMENTO_LOTE, total) != 0) {
+        return 0;
+    }
+    
+    char* cursor = bloco;
+    lotePtr->bloco = bloco;
+    lotePtr->capacidade = arredondada;
+    lotePtr->quantidade = capacidade;
+    
+    lotePtr->pontuacaoTotal = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->pontuacaoNivel = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->pontosUltimaJogada = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->comboAtual = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->melhorCombo = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->totalCombos = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->ultimoTipoJogado = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->sequenciaTipoAtual = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->nivelAtual = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->pontosParaProximoNivel = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->limitePontosNivel = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->totalJogadas = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->jogadasDaFila = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->jogadasDaPilha = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->pecasReservadas = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->eficienciaReserva = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->indiceMaisJogado = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->conquistasDesbloqueadas = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->marcosAlcancados = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->recordePessoal = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->pontosPorTipo = reservarColunaLote(&cursor, bytesTabela);
+    lotePtr->contagemPorTipo = reservarColunaLote(&cursor, bytesTabela);
+    lotePtr->multiplicadorAtual = reservarColunaLote(&cursor, bytesDoubles);
+    lotePtr->fatorDificuldade = reservarColunaLote(&cursor, bytesDoubles);
+    lotePtr->entradaTipo = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->entradaIndice = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->entradaOrigem = reservarColunaLote(&cursor, bytesInteiros);
+    lotePtr->progressaoPendente = reservarColunaLote(&cursor, bytesInteiros);
+    
+    SistemaExpert inicial;
+    inicializarSistemaExpert(&inicial);
+    for (int i = 0; i < arredondada; i++) {
+        carregarSistemaNoLote(lotePtr, i, &inicial);
+    }
+    return 1;
+}
+
+/**
+ * @brief Libera a memória de um lote
+ * @param lotePtr Ponteiro para o lote
+ */
+void liberarLoteSistemasExpert(LoteSistemasExpert* lotePtr) {
+    free(lotePtr->bloco);
+    lotePtr->bloco = NULL;
+    lotePtr->capacidade = 0;
+    lotePtr->quantidade = 0;
+}
+
+/**
+ * @brief Copia o estado de um SistemaExpert para uma posição do lote
+ * @param lotePtr Ponteiro para o lote
+ * @param indice Posição da sessão no lote
+ * @param sistemaPtr Estado de origem
+ */
+void carregarSistemaNoLote(LoteSistemasExpert* lotePtr, int indice, const SistemaExpert* sistemaPtr) {
+    lotePtr->pontuacaoTotal[indice] = sistemaPtr->pontuacaoTotal;
+    lotePtr->pontuacaoNivel[indice] = sistemaPtr->pontuacaoNivel;
+    lotePtr->pontosUltimaJogada[indice] = sistemaPtr->pontosUltimaJogada;
+    lotePtr->comboAtual[indice] = sistemaPtr->comboAtual;
+    lotePtr->melhorCombo[indice] = sistemaPtr->melhorCombo;
+    lotePtr->totalCombos[indice] = sistemaPtr->totalCombos;
+    lotePtr->ultimoTipoJogado[indice] = (unsigned char)sistemaPtr->ultimoTipoJogado;
+    lotePtr->sequenciaTipoAtual[indice] = sistemaPtr->sequenciaTipoAtual;
+    lotePtr->nivelAtual[indice] = sistemaPtr->nivelAtual;
+    lotePtr->pontosParaProximoNivel[indice] = sistemaPtr->pontosParaProximoNivel;
+    lotePtr->limitePontosNivel[indice] = sistemaPtr->limitePontosNivel;
+    lotePtr->totalJogadas[indice] = sistemaPtr->totalJogadas;
+    lotePtr->jogadasDaFila[indice] = sistemaPtr->jogadasDaFila;
+    lotePtr->jogadasDaPilha[indice] = sistemaPtr->jogadasDaPilha;
+    lotePtr->pecasReservadas[indice] = sistemaPtr->pecasReservadas;
+    lotePtr->eficienciaReserva[indice] = sistemaPtr->eficienciaReserva;
+    lotePtr->indiceMaisJogado[indice] = indiceTipoPeca(sistemaPtr->tipoMaisJogado);
+    lotePtr->conquistasDesbloqueadas[indice] = sistemaPtr->conquistasDesbloqueadas;
+    lotePtr->marcosAlcancados[indice] = sistemaPtr->marcosAlcancados;
+    lotePtr->recordePessoal[indice] = sistemaPtr->recordePessoal;
+    lotePtr->multiplicadorAtual[indice] = sistemaPtr->multiplicadorAtual;
+    lotePtr->fatorDificuldade[indice] = sistemaPtr->fatorDificuldade;
+    
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+        lotePtr->pontosPorTipo[t * lotePtr->capacidade + indice] = sistemaPtr->pontosPorTipo[t];
+        lotePtr->contagemPorTipo[t * lotePtr->capacidade + indice] = sistemaPtr->contagemPorTipo[t];
+    }
+}
+
+/**
+ * @brief Reconstrói um SistemaExpert a partir de uma posição do lote
+ * @param lotePtr Ponteiro para o lote
+ * @param indice Posição da sessão no lote
+ * @param sistemaPtr Estado de destino
+ */
+void extrairSistemaDoLote(const LoteSistemasExpert* lotePtr, int indice, SistemaExpert* sistemaPtr) {
+    sistemaPtr->pontuacaoTotal = lotePtr->pontuacaoTotal[indice];
+    sistemaPtr->pontuacaoNivel = lotePtr->pontuacaoNivel[indice];
+    sistemaPtr->pontosUltimaJogada = lotePtr->pontosUltimaJogada[indice];
+    sistemaPtr->comboAtual = lotePtr->comboAtual[indice];
+    sistemaPtr->melhorCombo = lotePtr->melhorCombo[indice];
+    sistemaPtr->totalCombos = lotePtr->totalCombos[indice];
+    sistemaPtr->ultimoTipoJogado = (char)lotePtr->ultimoTipoJogado[indice];
+    sistemaPtr->sequenciaTipoAtual = lotePtr->sequenciaTipoAtual[indice];
+    sistemaPtr->nivelAtual = lotePtr->nivelAtual[indice];
+    sistemaPtr->pontosParaProximoNivel = lotePtr->pontosParaProximoNivel[indice];
+    sistemaPtr->limitePontosNivel = lotePtr->limitePontosNivel[indice];
+    sistemaPtr->totalJogadas = lotePtr->totalJogadas[indice];
+    sistemaPtr->jogadasDaFila = lotePtr->jogadasDaFila[indice];
+    sistemaPtr->jogadasDaPilha = lotePtr->jogadasDaPilha[indice];
+    sistemaPtr->pecasReservadas = lotePtr->pecasReservadas[indice];
+    sistemaPtr->eficienciaReserva = lotePtr->eficienciaReserva[indice];
+    sistemaPtr->tipoMaisJogado = caracterePorTipo[lotePtr->indiceMaisJogado[indice]];
+    sistemaPtr->conquistasDesbloqueadas = lotePtr->conquistasDesbloqueadas[indice];
+    sistemaPtr->marcosAlcancados = lotePtr->marcosAlcancados[indice];
+    sistemaPtr->recordePessoal = lotePtr->recordePessoal[indice];
+    sistemaPtr->multiplicadorAtual = lotePtr->multiplicadorAtual[indice];
+    sistemaPtr->fatorDificuldade = lotePtr->fatorDificuldade[indice];
+    
+    for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+        sistemaPtr->pontosPorTipo[t] = lotePtr->pontosPorTipo[t * lotePtr->capacidade + indice];
+        sistemaPtr->contagemPorTipo[t] = lotePtr->contagemPorTipo[t * lotePtr->capacidade + indice];
+    }
+}
+
+/**
+ * @brief Kernel escalar: aplica uma jogada às sessões [inicio, fim) do lote
+ * @param lotePtr Ponteiro para o lote (entradas já preenchidas)
+ * @param inicio Primeira sessão
+ * @param fim Uma posição após a última sessão
+ * @return Diferente de zero se alguma sessão ficou com progressão pendente
+ * 
+ * Referência para os kernels vetoriais: mesmas operações inteiras e mesma
+ * sequência de operações em double de processarJogadaExpert/detectarCombo,
+ * incluindo a contagem por tipo e a regra de superaTipoMaisJogado.
+ */
+static int kernelLoteEscalar(LoteSistemasExpert* lotePtr, int inicio, int fim) {
+    int capacidade = lotePtr->capacidade;
+    int pendentes = 0;
+    
+    for (int i = inicio; i < fim; i++) {
+        int tipo = lotePtr->entradaTipo[i];
+        int indice = lotePtr->entradaIndice[i];
+        int base = lotePtr->pontosPorTipo[indice * capacidade + i];
+        
+        int mesmoTipo = (lotePtr->ultimoTipoJogado[i] == tipo);
+        int sequencia = lotePtr->sequenciaTipoAtual[i] * mesmoTipo + 1;
+        int combo = sequencia - 2;
+        combo &= -(combo > 0);
+        lotePtr->sequenciaTipoAtual[i] = sequencia;
+        lotePtr->comboAtual[i] = combo;
+        lotePtr->melhorCombo[i] = combo > lotePtr->melhorCombo[i] ? combo : lotePtr->melhorCombo[i];
+        lotePtr->ultimoTipoJogado[i] = tipo;
+        
+        int pontos = (int)(base * (1.0 + (combo * 0.2)));
+        int total = lotePtr->pontuacaoTotal[i] + pontos;
+        lotePtr->pontosUltimaJogada[i] = pontos;
+        lotePtr->pontuacaoTotal[i] = total;
+        lotePtr->pontuacaoNivel[i] += pontos;
+        lotePtr->recordePessoal[i] = total > lotePtr->recordePessoal[i] ? total : lotePtr->recordePessoal[i];
+        
+        int origemFila = (lotePtr->entradaOrigem[i] == 0);
+        int jogadas = ++lotePtr->totalJogadas[i];
+        lotePtr->jogadasDaFila[i] += origemFila;
+        lotePtr->jogadasDaPilha[i] += !origemFila;
+        lotePtr->eficienciaReserva[i] = (int)((double)lotePtr->jogadasDaPilha[i] / jogadas * 100.0);
+        
+        int maisJogado = lotePtr->indiceMaisJogado[i];
+        int conhecido = (indice != PECA_DESCONHECIDA);
+        int contagemTipo = (lotePtr->contagemPorTipo[indice * capacidade + i] += conhecido);
+        int contagemMais = lotePtr->contagemPorTipo[maisJogado * capacidade + i];
+        if (conhecido & ((contagemTipo > contagemMais) | ((contagemTipo == contagemMais) & (indice < maisJogado)))) {
+            lotePtr->indiceMaisJogado[i] = indice;
+        }
+        
+        int nivel = lotePtr->nivelAtual[i];
+        int conquistas = lotePtr->conquistasDesbloqueadas[i];
+        int pendente = (total >= lotePtr->limitePontosNivel[i]) |
+                       ((nivel == 5) & !(conquistas & 1)) | ((nivel == 10) & !(conquistas & 2));
+        lotePtr->pontosParaProximoNivel[i] = lotePtr->limitePontosNivel[i] - total;
+        lotePtr->progressaoPendente[i] = pendente;
+        pendentes |= pendente;
+    }
+    return pendentes;
+}
+
+#ifdef LOTE_VETORIAL_X86
+
+/**
+ * @brief Kernel AVX2: processa 8 sessões por iteração
+ * 
+ * As operações em double (fator de combo, pontos e eficiência) são feitas
+ * com multiplicação e soma separadas, sem FMA, para reproduzir bit a bit
+ * o arredondamento do caminho escalar. Pontos base e contagens por tipo
+ * são selecionados por comparação com cada tipo (as tabelas são
+ * [tipo * capacidade + sessão]), sem gather nem acesso escalar.
+ */
+__attribute__((target("avx2")))
+static int kernelLoteAVX2(LoteSistemasExpert* lotePtr, int inicio, int fim) {
+    const __m256i um = _mm256_set1_epi32(1);
+    const __m256i dois = _mm256_set1_epi32(2);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i desconhecida = _mm256_set1_epi32(PECA_DESCONHECIDA);
+    const __m256d passoCombo = _mm256_set1_pd(0.2);
+    const __m256d umDouble = _mm256_set1_pd(1.0);
+    const __m256d cem = _mm256_set1_pd(100.0);
+    int capacidade = lotePtr->capacidade;
+    __m256i pendentes = zero;
+    
+    int i = inicio;
+    for (; i + 8 <= fim; i += 8) {
+        __m256i tipo = _mm256_load_si256((const __m256i*)&lotePtr->entradaTipo[i]);
+        __m256i indice = _mm256_load_si256((const __m256i*)&lotePtr->entradaIndice[i]);
+        __m256i maisJogado = _mm256_load_si256((const __m256i*)&lotePtr->indiceMaisJogado[i]);
+        
+        // Pontos base e contagem por tipo: uma passada pelas colunas de cada tipo
+        __m256i base = zero;
+        __m256i contagemTipo = zero;
+        __m256i contagemMais = zero;
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+            __m256i valorTipo = _mm256_set1_epi32(t);
+            __m256i ehTipo = _mm256_cmpeq_epi32(indice, valorTipo);
+            __m256i* contagemPtr = (__m256i*)&lotePtr->contagemPorTipo[t * capacidade + i];
+            __m256i contagem = _mm256_load_si256(contagemPtr);
+            if (t != PECA_DESCONHECIDA) {
+                contagem = _mm256_sub_epi32(contagem, ehTipo);
+                _mm256_store_si256(contagemPtr, contagem);
+            }
+            base = _mm256_or_si256(base, _mm256_and_si256(ehTipo,
+                       _mm256_load_si256((const __m256i*)&lotePtr->pontosPorTipo[t * capacidade + i])));
+            contagemTipo = _mm256_or_si256(contagemTipo, _mm256_and_si256(ehTipo, contagem));
+            contagemMais = _mm256_or_si256(contagemMais, _mm256_and_si256(_mm256_cmpeq_epi32(maisJogado, valorTipo), contagem));
+        }
+        __m256i supera = _mm256_or_si256(_mm256_cmpgt_epi32(contagemTipo, contagemMais),
+                                         _mm256_and_si256(_mm256_cmpeq_epi32(contagemTipo, contagemMais),
+                                                          _mm256_cmpgt_epi32(maisJogado, indice)));
+        supera = _mm256_and_si256(supera, _mm256_cmpgt_epi32(desconhecida, indice));
+        _mm256_store_si256((__m256i*)&lotePtr->indiceMaisJogado[i], _mm256_blendv_epi8(maisJogado, indice, supera));
+        
+        // Combo: sequência cresce se o tipo se repete, volta a 1 caso contrário
+        __m256i mesmoTipo = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)&lotePtr->ultimoTipoJogado[i]), tipo);
+        __m256i sequencia = _mm256_add_epi32(_mm256_and_si256(_mm256_load_si256((const __m256i*)&lotePtr->sequenciaTipoAtual[i]), mesmoTipo), um);
+        __m256i combo = _mm256_max_epi32(_mm256_sub_epi32(sequencia, dois), zero);
+        __m256i melhor = _mm256_max_epi32(_mm256_load_si256((const __m256i*)&lotePtr->melhorCombo[i]), combo);
+        _mm256_store_si256((__m256i*)&lotePtr->sequenciaTipoAtual[i], sequencia);
+        _mm256_store_si256((__m256i*)&lotePtr->comboAtual[i], combo);
+        _mm256_store_si256((__m256i*)&lotePtr->melhorCombo[i], melhor);
+        _mm256_store_si256((__m256i*)&lotePtr->ultimoTipoJogado[i], tipo);
+        
+        // Pontos = (int)(base * (1.0 + combo * 0.2)), em duas metades de 4 doubles
+        __m256d fatorBaixo = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(combo)), passoCombo), umDouble);
+        __m256d fatorAlto = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(combo, 1)), passoCombo), umDouble);
+        __m128i pontosBaixo = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(base)), fatorBaixo));
+        __m128i pontosAlto = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(base, 1)), fatorAlto));
+        __m256i pontos = _mm256_inserti128_si256(_mm256_castsi128_si256(pontosBaixo), pontosAlto, 1);
+        
+        __m256i total = _mm256_add_epi32(_mm256_load_si256((const __m256i*)&lotePtr->pontuacaoTotal[i]), pontos);
+        __m256i pontuacaoNivel = _mm256_add_epi32(_mm256_load_si256((const __m256i*)&lotePtr->pontuacaoNivel[i]), pontos);
+        __m256i recorde = _mm256_max_epi32(_mm256_load_si256((const __m256i*)&lotePtr->recordePessoal[i]), total);
+        _mm256_store_si256((__m256i*)&lotePtr->pontosUltimaJogada[i], pontos);
+        _mm256_store_si256((__m256i*)&lotePtr->pontuacaoTotal[i], total);
+        _mm256_store_si256((__m256i*)&lotePtr->pontuacaoNivel[i], pontuacaoNivel);
+        _mm256_store_si256((__m256i*)&lotePtr->recordePessoal[i], recorde);
+        
+        // Origem das jogadas e eficiência da reserva
+        __m256i origemFila = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)&lotePtr->entradaOrigem[i]), zero);
+        __m256i jogadas = _mm256_add_epi32(_mm256_load_si256((const __m256i*)&lotePtr->totalJogadas[i]), um);
+        __m256i daFila = _mm256_sub_epi32(_mm256_load_si256((const __m256i*)&lotePtr->jogadasDaFila[i]), origemFila);
+        __m256i daPilha = _mm256_add_epi32(_mm256_load_si256((const __m256i*)&lotePtr->jogadasDaPilha[i]), _mm256_andnot_si256(origemFila, um));
+        _mm256_store_si256((__m256i*)&lotePtr->totalJogadas[i], jogadas);
+        _mm256_store_si256((__m256i*)&lotePtr->jogadasDaFila[i], daFila);
+        _mm256_store_si256((__m256i*)&lotePtr->jogadasDaPilha[i], daPilha);
+        
+        __m128i eficienciaBaixa = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_div_pd(
+            _mm256_cvtepi32_pd(_mm256_castsi256_si128(daPilha)), _mm256_cvtepi32_pd(_mm256_castsi256_si128(jogadas))), cem));
+        __m128i eficienciaAlta = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_div_pd(
+            _mm256_cvtepi32_pd(_mm256_extracti128_si256(daPilha, 1)), _mm256_cvtepi32_pd(_mm256_extracti128_si256(jogadas, 1))), cem));
+        _mm256_store_si256((__m256i*)&lotePtr->eficienciaReserva[i],
+                           _mm256_inserti128_si256(_mm256_castsi128_si256(eficienciaBaixa), eficienciaAlta, 1));
+        
+        // Progressão: limite do nível atingido ou conquista de nível 5/10 pendente
+        __m256i limite = _mm256_load_si256((const __m256i*)&lotePtr->limitePontosNivel[i]);
+        __m256i nivel = _mm256_load_si256((const __m256i*)&lotePtr->nivelAtual[i]);
+        __m256i conquistas = _mm256_load_si256((const __m256i*)&lotePtr->conquistasDesbloqueadas[i]);
+        __m256i pendente = _mm256_andnot_si256(_mm256_cmpgt_epi32(limite, total), um);
+        pendente = _mm256_or_si256(pendente, _mm256_and_si256(_mm256_cmpeq_epi32(nivel, _mm256_set1_epi32(5)),
+                                                              _mm256_andnot_si256(conquistas, um)));
+        pendente = _mm256_or_si256(pendente, _mm256_and_si256(_mm256_cmpeq_epi32(nivel, _mm256_set1_epi32(10)),
+                                                              _mm256_cmpeq_epi32(_mm256_and_si256(conquistas, dois), zero)));
+        pendente = _mm256_and_si256(pendente, um);
+        _mm256_store_si256((__m256i*)&lotePtr->pontosParaProximoNivel[i], _mm256_sub_epi32(limite, total));
+        _mm256_store_si256((__m256i*)&lotePtr->progressaoPendente[i], pendente);
+        pendentes = _mm256_or_si256(pendentes, pendente);
+    }
+    int pendentesCauda = kernelLoteEscalar(lotePtr, i, fim);
+    return pendentesCauda | !_mm256_testz_si256(pendentes, pendentes);
+}
+
+/**
+ * @brief Kernel SSE4.1: processa 4 sessões por iteração
+ */
+__attribute__((target("sse4.1")))
+static int kernelLoteSSE41(LoteSistemasExpert* lotePtr, int inicio, int fim) {
+    const __m128i um = _mm_set1_epi32(1);
+    const __m128i dois = _mm_set1_epi32(2);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i desconhecida = _mm_set1_epi32(PECA_DESCONHECIDA);
+    const __m128d passoCombo = _mm_set1_pd(0.2);
+    const __m128d umDouble = _mm_set1_pd(1.0);
+    const __m128d cem = _mm_set1_pd(100.0);
+    int capacidade = lotePtr->capacidade;
+    __m128i pendentes = zero;
+    
+    int i = inicio;
+    for (; i + 4 <= fim; i += 4) {
+        __m128i tipo = _mm_load_si128((const __m128i*)&lotePtr->entradaTipo[i]);
+        __m128i indice = _mm_load_si128((const __m128i*)&lotePtr->entradaIndice[i]);
+        __m128i maisJogado = _mm_load_si128((const __m128i*)&lotePtr->indiceMaisJogado[i]);
+        
+        __m128i base = zero;
+        __m128i contagemTipo = zero;
+        __m128i contagemMais = zero;
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+            __m128i valorTipo = _mm_set1_epi32(t);
+            __m128i ehTipo = _mm_cmpeq_epi32(indice, valorTipo);
+            __m128i* contagemPtr = (__m128i*)&lotePtr->contagemPorTipo[t * capacidade + i];
+            __m128i contagem = _mm_load_si128(contagemPtr);
+            if (t != PECA_DESCONHECIDA) {
+                contagem = _mm_sub_epi32(contagem, ehTipo);
+                _mm_store_si128(contagemPtr, contagem);
+            }
+            base = _mm_or_si128(base, _mm_and_si128(ehTipo,
+                       _mm_load_si128((const __m128i*)&lotePtr->pontosPorTipo[t * capacidade + i])));
+            contagemTipo = _mm_or_si128(contagemTipo, _mm_and_si128(ehTipo, contagem));
+            contagemMais = _mm_or_si128(contagemMais, _mm_and_si128(_mm_cmpeq_epi32(maisJogado, valorTipo), contagem));
+        }
+        __m128i supera = _mm_or_si128(_mm_cmpgt_epi32(contagemTipo, contagemMais),
+                                      _mm_and_si128(_mm_cmpeq_epi32(contagemTipo, contagemMais),
+                                                    _mm_cmpgt_epi32(maisJogado, indice)));
+        supera = _mm_and_si128(supera, _mm_cmpgt_epi32(desconhecida, indice));
+        _mm_store_si128((__m128i*)&lotePtr->indiceMaisJogado[i], _mm_blendv_epi8(maisJogado, indice, supera));
+        
+        __m128i mesmoTipo = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)&lotePtr->ultimoTipoJogado[i]), tipo);
+        __m128i sequencia = _mm_add_epi32(_mm_and_si128(_mm_load_si128((const __m128i*)&lotePtr->sequenciaTipoAtual[i]), mesmoTipo), um);
+        __m128i combo = _mm_max_epi32(_mm_sub_epi32(sequencia, dois), zero);
+        __m128i melhor = _mm_max_epi32(_mm_load_si128((const __m128i*)&lotePtr->melhorCombo[i]), combo);
+        _mm_store_si128((__m128i*)&lotePtr->sequenciaTipoAtual[i], sequencia);
+        _mm_store_si128((__m128i*)&lotePtr->comboAtual[i], combo);
+        _mm_store_si128((__m128i*)&lotePtr->melhorCombo[i], melhor);
+        _mm_store_si128((__m128i*)&lotePtr->ultimoTipoJogado[i], tipo);
+        
+        __m128d fatorBaixo = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(combo), passoCombo), umDouble);
+        __m128d fatorAlto = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(combo, 8)), passoCombo), umDouble);
+        __m128i pontosBaixo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(base), fatorBaixo));
+        __m128i pontosAlto = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(base, 8)), fatorAlto));
+        __m128i pontos = _mm_unpacklo_epi64(pontosBaixo, pontosAlto);
+        
+        __m128i total = _mm_add_epi32(_mm_load_si128((const __m128i*)&lotePtr->pontuacaoTotal[i]), pontos);
+        __m128i pontuacaoNivel = _mm_add_epi32(_mm_load_si128((const __m128i*)&lotePtr->pontuacaoNivel[i]), pontos);
+        __m128i recorde = _mm_max_epi32(_mm_load_si128((const __m128i*)&lotePtr->recordePessoal[i]), total);
+        _mm_store_si128((__m128i*)&lotePtr->pontosUltimaJogada[i], pontos);
+        _mm_store_si128((__m128i*)&lotePtr->pontuacaoTotal[i], total);
+        _mm_store_si128((__m128i*)&lotePtr->pontuacaoNivel[i], pontuacaoNivel);
+        _mm_store_si128((__m128i*)&lotePtr->recordePessoal[i], recorde);
+        
+        __m128i origemFila = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)&lotePtr->entradaOrigem[i]), zero);
+        __m128i jogadas = _mm_add_epi32(_mm_load_si128((const __m128i*)&lotePtr->totalJogadas[i]), um);
+        __m128i daFila = _mm_sub_epi32(_mm_load_si128((const __m128i*)&lotePtr->jogadasDaFila[i]), origemFila);
+        __m128i daPilha = _mm_add_epi32(_mm_load_si128((const __m128i*)&lotePtr->jogadasDaPilha[i]), _mm_andnot_si128(origemFila, um));
+        _mm_store_si128((__m128i*)&lotePtr->totalJogadas[i], jogadas);
+        _mm_store_si128((__m128i*)&lotePtr->jogadasDaFila[i], daFila);
+        _mm_store_si128((__m128i*)&lotePtr->jogadasDaPilha[i], daPilha);
+        
+        __m128i eficienciaBaixa = _mm_cvttpd_epi32(_mm_mul_pd(_mm_div_pd(
+            _mm_cvtepi32_pd(daPilha), _mm_cvtepi32_pd(jogadas)), cem));
+        __m128i eficienciaAlta = _mm_cvttpd_epi32(_mm_mul_pd(_mm_div_pd(
+            _mm_cvtepi32_pd(_mm_srli_si128(daPilha, 8)), _mm_cvtepi32_pd(_mm_srli_si128(jogadas, 8))), cem));
+        _mm_store_si128((__m128i*)&lotePtr->eficienciaReserva[i], _mm_unpacklo_epi64(eficienciaBaixa, eficienciaAlta));
+        
+        __m128i limite = _mm_load_si128((const __m128i*)&lotePtr->limitePontosNivel[i]);
+        __m128i nivel = _mm_load_si128((const __m128i*)&lotePtr->nivelAtual[i]);
+        __m128i conquistas = _mm_load_si128((const __m128i*)&lotePtr->conquistasDesbloqueadas[i]);
+        __m128i pendente = _mm_andnot_si128(_mm_cmpgt_epi32(limite, total), um);
+        pendente = _mm_or_si128(pendente, _mm_and_si128(_mm_cmpeq_epi32(nivel, _mm_set1_epi32(5)),
+                                                        _mm_andnot_si128(conquistas, um)));
+        pendente = _mm_or_si128(pendente, _mm_and_si128(_mm_cmpeq_epi32(nivel, _mm_set1_epi32(10)),
+                                                        _mm_cmpeq_epi32(_mm_and_si128(conquistas, dois), zero)));
+        pendente = _mm_and_si128(pendente, um);
+        _mm_store_si128((__m128i*)&lotePtr->pontosParaProximoNivel[i], _mm_sub_epi32(limite, total));
+        _mm_store_si128((__m128i*)&lotePtr->progressaoPendente[i], pendente);
+        pendentes = _mm_or_si128(pendentes, pendente);
+    }
+    int pendentesCauda = kernelLoteEscalar(lotePtr, i, fim);
+    return pendentesCauda | !_mm_testz_si128(pendentes, pendentes);
+}
+#endif
+
+/**
+ * @brief Seleciona, uma única vez, o melhor kernel suportado pela CPU
+ * @param nomePtr Recebe o nome do kernel escolhido (pode ser NULL)
+ * @return Ponteiro para o kernel
+ */
+static KernelLote selecionarKernelLote(const char** nomePtr) {
+    static KernelLote kernel = NULL;
+    static const char* nome = "escalar";
+    
+    if (kernel == NULL) {
+        kernel = kernelLoteEscalar;
+#ifdef LOTE_VETORIAL_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernel = kernelLoteAVX2;
+            nome = "avx2";
+        } else if (__builtin_cpu_supports("sse4.1")) {
+            kernel = kernelLoteSSE41;
+            nome = "sse4.1";
+        }
+#endif
+    }
+    if (nomePtr != NULL) {
+        *nomePtr = nome;
+    }
+    return kernel;
+}
+
+/**
+ * @brief Nome do kernel usado por processarJogadasLote nesta CPU
+ * @return "avx2", "sse4.1" ou "escalar"
+ */
+const char* nomeKernelLote() {
+    const char* nome;
+    selecionarKernelLote(&nome);
+    return nome;
+}
+
+/**
+ * @brief Aplica verificarProgressaoNivel a uma sessão do lote
+ * @param lotePtr Ponteiro para o lote
+ * @param indice Posição da sessão
+ * 
+ * Copia só os campos lidos ou alterados pela progressão (e a coluna de
+ * pontos por tipo, recalculada na subida), em vez de extrair e recarregar
+ * a sessão inteira.
+ */
+static void progredirSessaoLote(LoteSistemasExpert* lotePtr, int indice) {
+    SistemaExpert sistema;
+    sistema.pontuacaoTotal = lotePtr->pontuacaoTotal[indice];
+    sistema.nivelAtual = lotePtr->nivelAtual[indice];
+    sistema.limitePontosNivel = lotePtr->limitePontosNivel[indice];
+    sistema.multiplicadorAtual = lotePtr->multiplicadorAtual[indice];
+    sistema.fatorDificuldade = lotePtr->fatorDificuldade[indice];
+    sistema.marcosAlcancados = lotePtr->marcosAlcancados[indice];
+    sistema.conquistasDesbloqueadas = lotePtr->conquistasDesbloqueadas[indice];
+    
+    int nivelAnterior = sistema.nivelAtual;
+    verificarProgressaoNivel(&sistema);
+    
+    lotePtr->nivelAtual[indice] = sistema.nivelAtual;
+    lotePtr->limitePontosNivel[indice] = sistema.limitePontosNivel;
+    lotePtr->pontosParaProximoNivel[indice] = sistema.pontosParaProximoNivel;
+    lotePtr->multiplicadorAtual[indice] = sistema.multiplicadorAtual;
+    lotePtr->fatorDificuldade[indice] = sistema.fatorDificuldade;
+    lotePtr->marcosAlcancados[indice] = sistema.marcosAlcancados;
+    lotePtr->conquistasDesbloqueadas[indice] = sistema.conquistasDesbloqueadas;
+    if (sistema.nivelAtual != nivelAnterior) {
+        for (int t = 0; t < TOTAL_TIPOS_PECA; t++) {
+            lotePtr->pontosPorTipo[t * lotePtr->capacidade + indice] = sistema.pontosPorTipo[t];
+        }
+    }
+}
+
+/**
+ * @brief Aplica uma jogada a cada sessão do lote (equivalente a processarJogadaExpert)
+ * @param lotePtr Ponteiro para o lote
+ * @param pecas Uma peça por sessão (lotePtr->quantidade elementos)
+ * @param origens Origem de cada peça (0=fila, 1=pilha)
+ * 
+ * Etapas: (1) conversão das entradas para colunas inteiras; (2) kernel
+ * vetorial com pontuação, combos, contagem por tipo, estatísticas de
+ * origem e detecção de progressão pendente; (3) só se o kernel sinalizar
+ * alguma sessão, passagem escalar que reutiliza verificarProgressaoNivel
+ * (via progredirSessaoLote) nas sessões que subiram de nível ou têm
+ * conquista pendente. O resultado é idêntico ao caminho escalar.
+ */
+void processarJogadasLote(LoteSistemasExpert* lotePtr, const Peca* pecas, const int* origens) {
+    INSTRUMENTAR_INICIO(OPERACAO_JOGADAS_LOTE, inicio);
+    int quantidade = lotePtr->quantidade;
+    
+    for (int i = 0; i < quantidade; i++) {
+        lotePtr->entradaTipo[i] = (unsigned char)pecas[i].tipo;
+        lotePtr->entradaIndice[i] = indiceTipoPeca(pecas[i].tipo);
+        lotePtr->entradaOrigem[i] = origens[i];
+    }
+    
+    if (selecionarKernelLote(NULL)(lotePtr, 0, quantidade)) {
+        for (int i = 0; i < quantidade; i++) {
+            if (lotePtr->progressaoPendente[i]) {
+                progredirSessaoLote(lotePtr, i);
+            }
+        }
+    }
+    INSTRUMENTAR_FIM(OPERACAO_JOGADAS_LOTE, inicio);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                          LOG BINÁRIO DE JOGADAS E REPLAY
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Abre (ou cria) um log de jogadas para acréscimo
+ * @param logPtr Gravador a inicializar
+ * @param caminho Caminho do arquivo
+ * @return 1 em caso de sucesso, 0 se o arquivo não pôde ser aberto ou é inválido
+ * 
+ * Um arquivo novo (ou vazio) recebe o cabeçalho; um arquivo existente tem
+ * o cabeçalho conferido e os novos registros são acrescentados ao final.
+ * Um arquivo curto demais para conter o cabeçalho é recusado, e um
+ * registro final incompleto (escrita interrompida) é descartado antes.
+ */
+int abrirLogJogadas(LogJogadas* logPtr, const char* caminho) {
+    CabecalhoLogJogadas cabecalho;
+    
+    FILE* existente = fopen(caminho, "rb");
+    if (existente != NULL) {
+        // Só um arquivo vazio é tratado como novo; qualquer outro precisa do cabeçalho inteiro
+        fseek(existente, 0, SEEK_END);
+        long tamanho = ftell(existente);
+        rewind(existente);
+        size_t lidos = tamanho != 0 ? fread(&cabecalho, sizeof(cabecalho), 1, existente) : 0;
+        fclose(existente);
+        if (tamanho != 0 && (lidos != 1 ||
+                             memcmp(cabecalho.magica, "TLOG", 4) != 0 ||
+                             cabecalho.versao != VERSAO_LOG_JOGADAS ||
+                             cabecalho.tamanhoRegistro != sizeof(RegistroJogada))) {
+            printf("%s nao e um log de jogadas compativel.\n", caminho);
+            return 0;
+        }
+        
+        // Uma escrita interrompida deixa um registro pela metade no fim: sem
+        // descartá-lo, todos os registros acrescentados depois ficariam desalinhados
+        long incompletos = tamanho > 0 ? (long)((tamanho - (long)sizeof(cabecalho)) % (long)sizeof(RegistroJogada)) : 0;
+        if (incompletos != 0) {
+#ifdef _WIN32
+            printf("%s termina com um registro incompleto (%ld bytes).\n", caminho, incompletos);
+            return 0;
+#else
+            if (truncate(caminho, (off_t)(tamanho - incompletos)) != 0) {
+                printf("%s termina com um registro incompleto (%ld bytes) e nao pode ser truncado.\n", caminho, incompletos);
+                return 0;
+            }
+            printf("Aviso: %ld bytes de um registro incompleto descartados do fim de %s\n", incompletos, caminho);
+#endif
+        }
+    }
+    
+    logPtr->arquivo = fopen(caminho, "ab");
+    if (logPtr->arquivo == NULL) {
+        printf("Nao foi possivel abrir %s\n", caminho);
+        return 0;
+    }
+    setvbuf(logPtr->arquivo, NULL, _IONBF, 0);  // O buffer próprio já agrupa as escritas
+    logPtr->quantidade = 0;
+    logPtr->totalRegistros = 0;
+    
+    fseek(logPtr->arquivo, 0, SEEK_END);
+    if (ftell(logPtr->arquivo) == 0) {
+        memcpy(cabecalho.magica, "TLOG", 4);
+        cabecalho.versao = VERSAO_LOG_JOGADAS;
+        cabecalho.tamanhoRegistro = sizeof(RegistroJogada);
+        cabecalho.criadoEm = (int64_t)time(NULL);
+        if (fwrite(&cabecalho, sizeof(cabecalho), 1, logPtr->arquivo) != 1) {
+            printf("Falha ao gravar o cabecalho de %s\n", caminho);
+            fclose(logPtr->arquivo);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Grava no arquivo os registros acumulados no buffer
+ * @param logPtr Gravador
+ * @return 1 em caso de sucesso, 0 em caso de falha de escrita
+ */
+int descarregarLogJogadas(LogJogadas* logPtr) {
+    size_t gravados = fwrite(logPtr->buffer, sizeof(RegistroJogada), (size_t)logPtr->quantidade, logPtr->arquivo);
+    int sucesso = (gravados == (size_t)logPtr->quantidade);
+    logPtr->totalRegistros += (long long)gravados;
+    logPtr->quantidade = 0;
+    return sucesso;
+}
+
+/**
+ * @brief Acrescenta um evento ao log (sem efeito se o log estiver desativado)
+ * @param logPtr Gravador, ou NULL
+ * @param evento Tipo do evento
+ * @param origem Origem da jogada (0=fila, 1=pilha)
+ * @param peca Peça envolvida (para reabastecimento, a primeira gerada)
+ * @param quantidade Peças geradas (apenas EVENTO_REABASTECIMENTO)
+ */
+void registrarEventoLog(LogJogadas* logPtr, TipoEventoLog evento, int origem, Peca peca, int quantidade) {
+    if (logPtr == NULL) {
+        return;
+    }
+    
+    RegistroJogada* registroPtr = &logPtr->buffer[logPtr->quantidade++];
+    registroPtr->evento = (uint8_t)evento;
+    registroPtr->origem = (uint8_t)(origem != 0);
+    registroPtr->tipo = peca.tipo;
+    registroPtr->quantidade = (uint8_t)quantidade;
+    registroPtr->id = (uint32_t)peca.id;
+    
+    if (logPtr->quantidade == REGISTROS_BUFFER_LOG && !descarregarLogJogadas(logPtr)) {
+        printf("Falha ao gravar o log de jogadas.\n");
+    }
+}
+
+/**
+ * @brief Descarrega o buffer e fecha o log
+ * @param logPtr Gravador
+ */
+void fecharLogJogadas(LogJogadas* logPtr) {
+    if (logPtr->quantidade > 0 && !descarregarLogJogadas(logPtr)) {
+        printf("Falha ao gravar o log de jogadas.\n");
+    }
+    fclose(logPtr->arquivo);
+    logPtr->arquivo = NULL;
+}
+
+/**
+ * @brief Mapeia um arquivo inteiro em memória somente para leitura
+ * @param caminho Caminho do arquivo
+ * @param tamanhoPtr Recebe o tamanho em bytes
+ * @return Início do mapeamento, ou NULL em caso de erro
+ * 
+ * Em plataformas sem mmap o arquivo é lido para um bloco alocado.
+ */
+static const unsigned char* mapearArquivoLeitura(const char* caminho, size_t* tamanhoPtr) {
+#ifdef _WIN32
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return NULL;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    unsigned char* dados = malloc(tamanho > 0 ? (size_t)tamanho : 1);
+    if (dados == NULL || fread(dados, 1, (size_t)tamanho, arquivo) != (size_t)tamanho) {
+        free(dados);
+        fclose(arquivo);
+        return NULL;
+    }
+    fclose(arquivo);
+    *tamanhoPtr = (size_t)tamanho;
+    return dados;
+#else
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) {
+        return NULL;
+    }
+    struct stat informacoes;
+    if (fstat(descritor, &informacoes) != 0 || informacoes.st_size == 0) {
+        close(descritor);
+        return NULL;
+    }
+    void* dados = mmap(NULL, (size_t)informacoes.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (dados == MAP_FAILED) {
+        return NULL;
+    }
+    posix_madvise(dados, (size_t)informacoes.st_size, POSIX_MADV_SEQUENTIAL);
+    *tamanhoPtr = (size_t)informacoes.st_size;
+    return dados;
+#endif
+}
+
+/**
+ * @brief Libera um mapeamento criado por mapearArquivoLeitura
+ */
+static void desmapearArquivoLeitura(const unsigned char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    free((void*)dados);
+#else
+    munmap((void*)dados, tamanho);
+#endif
+}
+
+/**
+ * @brief Consolida o resultado de uma sessão reproduzida
+ */
+static void encerrarSessaoReplay(const SistemaExpert* sistemaPtr, ResultadoReplay* resultadoPtr) {
+    if (resultadoPtr->sessoes == 0 || sistemaPtr->pontuacaoTotal > resultadoPtr->melhorPontuacao) {
+        resultadoPtr->melhorPontuacao = sistemaPtr->pontuacaoTotal;
+    }
+    if (resultadoPtr->sessoes == 0 || sistemaPtr->pontuacaoTotal < resultadoPtr->piorPontuacao) {
+        resultadoPtr->piorPontuacao = sistemaPtr->pontuacaoTotal;
+    }
+    resultadoPtr->pontuacaoSomada += sistemaPtr->pontuacaoTotal;
+    resultadoPtr->sessoes++;
+}
+
+/**
+ * @brief Reproduz um log de jogadas pelo motor de pontuação
+ * @param caminho Arquivo de log
+ * @param sessaoDetalhada Índice (ordem no arquivo) da sessão a detalhar, ou -1
+ * @param resultadoPtr Totais da reprodução
+ * @return 1 se o log foi lido (registros inválidos são contados em resultadoPtr), 0 caso contrário
+ * 
+ * O arquivo é mapeado em memória e os registros são lidos diretamente do
+ * mapeamento, sem cópia nem interpretação de texto. Cada EVENTO_JOGADA
+ * passa por processarJogadaExpert com a mesma origem gravada, e cada
+ * EVENTO_OTIMIZACAO reaplica otimizarSistemaExpert, reproduzindo as
+ * pontuações originais. Ao fim da sessão detalhada suas estatísticas são
+ * exibidas.
+ */
+int reproduzirLogJogadas(const char* caminho, long long sessaoDetalhada, ResultadoReplay* resultadoPtr) {
+    ResultadoReplay vazio = {0};
+    *resultadoPtr = vazio;
+    
+    size_t tamanho = 0;
+    const unsigned char* dados = mapearArquivoLeitura(caminho, &tamanho);
+    if (dados == NULL) {
+        printf("Nao foi possivel ler %s\n", caminho);
+        return 0;
+    }
+    
+    const CabecalhoLogJogadas* cabecalhoPtr = (const CabecalhoLogJogadas*)dados;
+    if (tamanho < sizeof(CabecalhoLogJogadas) || memcmp(cabecalhoPtr->magica, "TLOG", 4) != 0 ||
+        cabecalhoPtr->versao != VERSAO_LOG_JOGADAS || cabecalhoPtr->tamanhoRegistro != sizeof(RegistroJogada)) {
+        printf("%s nao e um log de jogadas compativel.\n", caminho);
+        desmapearArquivoLeitura(dados, tamanho);
+        return 0;
+    }
+    
+    const RegistroJogada* registros = (const RegistroJogada*)(dados + sizeof(CabecalhoLogJogadas));
+    long long totalRegistros = (long long)((tamanho - sizeof(CabecalhoLogJogadas)) / sizeof(RegistroJogada));
+    resultadoPtr->bytesIgnorados = (long long)((tamanho - sizeof(CabecalhoLogJogadas)) % sizeof(RegistroJogada));
+    
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;
+    SistemaExpert sistema;
+    inicializarSistemaExpert(&sistema);
+    TabuleiroJogo tabuleiro;
+    int comTabuleiro = 0;
+    int sessaoAberta = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (long long i = 0; i < totalRegistros; i++) {
+        const RegistroJogada* registroPtr = &registros[i];
+        switch (registroPtr->evento) {
+            case EVENTO_INICIO_SESSAO:
+                if (sessaoAberta) {
+                    if (resultadoPtr->sessoes == sessaoDetalhada) {
+                        exibirEstatisticasExpert(&sistema);
+                    }
+                    encerrarSessaoReplay(&sistema, resultadoPtr);
+                }
+                inicializarSistemaExpert(&sistema);
+                comTabuleiro = (registroPtr->quantidade == 1);
+                if (comTabuleiro) {
+                    inicializarTabuleiro(&tabuleiro);
+                }
+                sessaoAberta = 1;
+                break;
+            case EVENTO_JOGADA:
+                // A colocação no poço é determinística: refazê-la reproduz o bônus de linhas
+                if (comTabuleiro) {
+                    processarJogadaTabuleiro(criarPeca(registroPtr->tipo, (int)registroPtr->id), registroPtr->origem,
+                                             &sistema, &tabuleiro);
+                } else {
+                    processarJogadaExpert(criarPeca(registroPtr->tipo, (int)registroPtr->id), registroPtr->origem, &sistema);
+                }
+                resultadoPtr->jogadas++;
+                sessaoAberta = 1;
+                break;
+            case EVENTO_OTIMIZACAO:
+                otimizarSistemaExpert(&sistema);
+                break;
+            case EVENTO_RESERVA:
+            case EVENTO_REABASTECIMENTO:
+                break;
+            default:
+                resultadoPtr->registrosInvalidos++;
+                break;
+        }
+    }
+    if (sessaoAberta) {
+        if (resultadoPtr->sessoes == sessaoDetalhada) {
+            exibirEstatisticasExpert(&sistema);
+        }
+        encerrarSessaoReplay(&sistema, resultadoPtr);
+    }
+    resultadoPtr->segundos = (obterTempoNanossegundos() - inicio) / 1e9;
+    resultadoPtr->registros = totalRegistros;
+    
+    modoSilencioso = silencioAnterior;
+    desmapearArquivoLeitura(dados, tamanho);
+    return 1;
+}
+
+/**
+ * @brief Exibe o resumo de uma reprodução de log
+ * @param caminho Arquivo reproduzido
+ * @param resultadoPtr Totais da reprodução
+ */
+void exibirResumoReplay(const char* caminho, const ResultadoReplay* resultadoPtr) {
+    double segundos = resultadoPtr->segundos > 0 ? resultadoPtr->segundos : 1e-9;
+    double media = resultadoPtr->sessoes > 0 ? (double)resultadoPtr->pontuacaoSomada / resultadoPtr->sessoes : 0.0;
+    
+    printf("*** REPLAY DO LOG %s:\n", caminho);
+    printf("   * Sessoes: %lld  |  Registros: %lld  |  Jogadas: %lld\n",
+           resultadoPtr->sessoes, resultadoPtr->registros, resultadoPtr->jogadas);
+    printf("   * Pontuacao media: %.1f  |  Melhor: %d  |  Pior: %d  |  Soma: %lld\n",
+           media, resultadoPtr->melhorPontuacao, resultadoPtr->piorPontuacao, resultadoPtr->pontuacaoSomada);
+    if (resultadoPtr->registrosInvalidos > 0 || resultadoPtr->bytesIgnorados > 0) {
+        printf("   * Registros invalidos: %lld  |  Bytes finais incompletos: %lld\n",
+               resultadoPtr->registrosInvalidos, resultadoPtr->bytesIgnorados);
+    }
+    printf("   * Tempo: %.3f s  |  Vazao: %.0f registros/s\n",
+           resultadoPtr->segundos, resultadoPtr->registros / segundos);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                          SNAPSHOT DO ESTADO DE JOGO
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Calcula a soma de verificação de um snapshot
+ * @param snapshotPtr Snapshot
+ * @return FNV-1a de 32 bits de todos os bytes anteriores a somaVerificacao
+ */
+static uint32_t calcularSomaSnapshot(const SnapshotJogo* snapshotPtr) {
+    const unsigned char* bytes = (const unsigned char*)snapshotPtr;
+    size_t tamanho = offsetof(SnapshotJogo, somaVerificacao);
+    uint32_t soma = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        soma = (soma ^ bytes[i]) * 16777619u;
+    }
+    return soma;
+}
+
+/**
+ * @brief Monta um snapshot a partir das estruturas de um jogo
+ * @param snapshotPtr Snapshot a preencher
+ * @param filaPtr Fila de peças
+ * @param pilhaPtr Pilha de reserva
+ * @param sistemaPtr Sistema Expert
+ * @param proximoIdAtual Próximo ID de peça
+ * @param geradorPtr Gerador de peças
+ */
+void capturarSnapshotJogo(SnapshotJogo* snapshotPtr, const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr,
+                          const SistemaExpert* sistemaPtr, int proximoIdAtual, const GeradorPecas* geradorPtr) {
+    memset(snapshotPtr, 0, sizeof(*snapshotPtr));
+    memcpy(snapshotPtr->magica, "TSNP", 4);
+    snapshotPtr->versao = VERSAO_SNAPSHOT;
+    snapshotPtr->tamanho = sizeof(SnapshotJogo);
+    snapshotPtr->capacidadeFila = CAPACIDADE_FILA;
+    snapshotPtr->capacidadePilha = CAPACIDADE_PILHA;
+    snapshotPtr->proximoId = proximoIdAtual;
+    memcpy(&snapshotPtr->fila, filaPtr, sizeof(FilaCircular));
+    memcpy(&snapshotPtr->pilha, pilhaPtr, sizeof(PilhaReserva));
+    memcpy(&snapshotPtr->sistema, sistemaPtr, sizeof(SistemaExpert));
+    memcpy(&snapshotPtr->gerador, geradorPtr, sizeof(GeradorPecas));
+}
+
+/**
+ * @brief Monta um snapshot a partir de uma sessão de jogo
+ * @param snapshotPtr Snapshot a preencher
+ * @param sessaoPtr Sessão de origem (o log associado não faz parte do snapshot)
+ */
+void capturarSnapshotSessao(SnapshotJogo* snapshotPtr, const SessaoJogo* sessaoPtr) {
+    capturarSnapshotJogo(snapshotPtr, &sessaoPtr->fila, &sessaoPtr->pilha, &sessaoPtr->sistema,
+                         sessaoPtr->proximoId, &sessaoPtr->gerador);
+}
+
+/**
+ * @brief Restaura uma sessão de jogo a partir de um snapshot validado
+ * @param snapshotPtr Snapshot lido por lerSnapshotJogo
+ * @param sessaoPtr Sessão de destino (o log associado é preservado)
+ */
+void restaurarSnapshotSessao(const SnapshotJogo* snapshotPtr, SessaoJogo* sessaoPtr) {
+    sessaoPtr->fila = snapshotPtr->fila;
+    sessaoPtr->pilha = snapshotPtr->pilha;
+    sessaoPtr->sistema = snapshotPtr->sistema;
+    sessaoPtr->proximoId = snapshotPtr->proximoId;
+    sessaoPtr->gerador = snapshotPtr->gerador;
+}
+
+/**
+ * @brief Grava um snapshot em disco com uma única escrita
+ * @param caminho Arquivo de destino (sobrescrito)
+ * @param snapshotPtr Snapshot montado por capturarSnapshotJogo (recebe a soma)
+ * @return 1 em caso de sucesso, 0 em caso de falha
+ */
+int gravarSnapshotJogo(const char* caminho, SnapshotJogo* snapshotPtr) {
+    snapshotPtr->somaVerificacao = calcularSomaSnapshot(snapshotPtr);
+    
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        printf("Nao foi possivel criar %s\n", caminho);
+        return 0;
+    }
+    size_t gravados = fwrite(snapshotPtr, sizeof(SnapshotJogo), 1, arquivo);
+    int fechado = (fclose(arquivo) == 0);
+    if (gravados != 1 || !fechado) {
+        printf("Falha ao gravar %s\n", caminho);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Lê e valida um snapshot com uma única leitura
+ * @param caminho Arquivo de origem
+ * @param snapshotPtr Snapshot lido (válido apenas se o retorno for 1)
+ * @return 1 se o snapshot é íntegro e compatível, 0 caso contrário
+ * 
+ * Além do formato e da soma de verificação, confere os contadores e
+ * índices da fila e da pilha, de modo que um arquivo adulterado com soma
+ * recalculada não leve a acessos fora dos arrays.
+ */
+int lerSnapshotJogo(const char* caminho, SnapshotJogo* snapshotPtr) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        printf("Nao foi possivel abrir %s\n", caminho);
+        return 0;
+    }
+    size_t lidos = fread(snapshotPtr, sizeof(SnapshotJogo), 1, arquivo);
+    fclose(arquivo);
+    
+    if (lidos != 1 || memcmp(snapshotPtr->magica, "TSNP", 4) != 0 ||
+        snapshotPtr->versao != VERSAO_SNAPSHOT || snapshotPtr->tamanho != sizeof(SnapshotJogo)) {
+        printf("%s nao e um snapshot compativel com esta versao.\n", caminho);
+        return 0;
+    }
+    if (snapshotPtr->capacidadeFila != CAPACIDADE_FILA || snapshotPtr->capacidadePilha != CAPACIDADE_PILHA) {
+        printf("Snapshot gravado com fila %u/pilha %u; esta compilacao usa %d/%d.\n",
+               snapshotPtr->capacidadeFila, snapshotPtr->capacidadePilha, CAPACIDADE_FILA, CAPACIDADE_PILHA);
+        return 0;
+    }
+    if (snapshotPtr->somaVerificacao != calcularSomaSnapshot(snapshotPtr)) {
+        printf("Snapshot %s corrompido (soma de verificacao invalida).\n", caminho);
+        return 0;
+    }
+    
+    const FilaCircular* filaPtr = &snapshotPtr->fila;
+    const PilhaReserva* pilhaPtr = &snapshotPtr->pilha;
+    if (filaPtr->quantidadePecas < 0 || filaPtr->quantidadePecas > CAPACIDADE_FILA ||
+        filaPtr->indiceFrente < 0 || filaPtr->indiceFrente >= CAPACIDADE_FILA ||
+        filaPtr->indiceTras < 0 || filaPtr->indiceTras >= CAPACIDADE_FILA ||
+        pilhaPtr->quantidadeReservada < 0 || pilhaPtr->quantidadeReservada > CAPACIDADE_PILHA ||
+        pilhaPtr->indiceTopo != pilhaPtr->quantidadeReservada - 1 ||
+        snapshotPtr->gerador.posicaoSaco < 0 || snapshotPtr->gerador.posicaoSaco > 7) {
+        printf("Snapshot %s com estado inconsistente.\n", caminho);
+        return 0;
+    }
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                     RANKING PERSISTENTE DE RECORDES (SKIP LIST)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Indica se o recorde a deve ficar à frente do recorde b
+ */
+static inline int recordeAntes(const RegistroRecorde* a, const RegistroRecorde* b) {
+    return a->pontuacao > b->pontuacao || (a->pontuacao == b->pontuacao && a->sequencia < b->sequencia);
+}
+
+/**
+ * @brief Sorteia o nível de um novo nó (probabilidade 1/2 por nível)
+ */
+static int sortearNivelRanking(CabecalhoRanking* cabecalhoPtr) {
+    uint64_t x = cabecalhoPtr->estadoAleatorio;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    cabecalhoPtr->estadoAleatorio = x;
+    
+    int nivel = 1;
+    while (nivel < NIVEIS_RANKING && (x & 1)) {
+        nivel++;
+        x >>= 1;
+    }
+    return nivel;
+}
+
+/**
+ * @brief Toma ou libera a trava de registro sobre o arquivo inteiro do ranking
+ * @param descritor Descritor do arquivo
+ * @param modo Trava desejada (TRAVA_RANKING_LIVRE a libera)
+ * 
+ * Espera a trava de outros processos; chamadas interrompidas por sinais
+ * são repetidas. Sem efeito no Windows, onde o arquivo não é mapeado.
+ */
+static void travarArquivoRanking(int descritor, ModoTravaRanking modo) {
+#ifdef _WIN32
+    (void)descritor;
+    (void)modo;
+#else
+    struct flock regiao;
+    memset(&regiao, 0, sizeof(regiao));
+    regiao.l_type = modo == TRAVA_RANKING_EXCLUSIVA ? F_WRLCK : modo == TRAVA_RANKING_COMPARTILHADA ? F_RDLCK : F_UNLCK;
+    regiao.l_whence = SEEK_SET;
+    while (fcntl(descritor, F_SETLKW, &regiao) != 0 && errno == EINTR) {
+    }
+#endif
+}
+
+/**
+ * @brief Toma a trava do ranking (mutex entre threads, arquivo entre processos)
+ * @param rankingPtr Ranking aberto
+ * @param exclusiva 1 para alterar o ranking, 0 para apenas consultá-lo
+ */
+static void travarRanking(RankingRecordes* rankingPtr, int exclusiva) {
+    pthread_mutex_lock(&rankingPtr->trava);
+    travarArquivoRanking(rankingPtr->descritor, exclusiva ? TRAVA_RANKING_EXCLUSIVA : TRAVA_RANKING_COMPARTILHADA);
+}
+
+/**
+ * @brief Libera a trava tomada por travarRanking
+ * @param rankingPtr Ranking aberto
+ */
+static void destravarRanking(RankingRecordes* rankingPtr) {
+    travarArquivoRanking(rankingPtr->descritor, TRAVA_RANKING_LIVRE);
+    pthread_mutex_unlock(&rankingPtr->trava);
+}
+
+/**
+ * @brief Confere os encadeamentos da skip list de um ranking lido do disco
+ * @param cabecalhoPtr Cabeçalho já conferido (capacidade, quantidade e níveis)
+ * @param nos Nós do arquivo (capacidade + 1)
+ * @return 1 se a estrutura é consistente, 0 caso contrário
+ * 
+ * O nível 0 precisa visitar exatamente quantidade nós distintos, com
+ * índices de 1 a capacidade, e terminar em 0. Nos demais níveis cada nó
+ * precisa estar no nível 0 e cada salto precisa levar exatamente à posição
+ * do próximo nó (ou, no último, ao fim do ranking). Assim nenhum índice
+ * lido do arquivo é seguido sem estar dentro do mapeamento.
+ */
+static int validarEstruturaRanking(const CabecalhoRanking* cabecalhoPtr, const NoRanking* nos) {
+    uint32_t* posicoes = calloc((size_t)cabecalhoPtr->capacidade + 1, sizeof(uint32_t));
+    if (posicoes == NULL) {
+        return 0;
+    }
+    
+    int valido = 1;
+    uint32_t atual = 0;
+    for (uint32_t posicao = 1; valido && posicao <= cabecalhoPtr->quantidade; posicao++) {
+        uint32_t proximo = nos[atual].proximo[0];
+        valido = proximo >= 1 && proximo <= cabecalhoPtr->capacidade && posicoes[proximo] == 0 &&
+                 nos[atual].salto[0] == 1;
+        if (valido) {
+            posicoes[proximo] = posicao;
+            atual = proximo;
+        }
+    }
+    valido = valido && nos[atual].proximo[0] == 0 && nos[atual].salto[0] == 0;
+    
+    for (uint32_t i = 1; valido && i < cabecalhoPtr->niveis; i++) {
+        uint32_t posicao = 0;
+        atual = 0;
+        for (;;) {
+            uint32_t proximo = nos[atual].proximo[i];
+            uint64_t alcance = (uint64_t)posicao + nos[atual].salto[i];
+            if (proximo == 0) {
+                valido = (alcance == cabecalhoPtr->quantidade);
+                break;
+            }
+            // Posições estritamente crescentes: a cadeia termina em no máximo quantidade passos
+            if (proximo > cabecalhoPtr->capacidade || posicoes[proximo] == 0 || posicoes[proximo] != alcance) {
+                valido = 0;
+                break;
+            }
+            posicao = posicoes[proximo];
+            atual = proximo;
+        }
+    }
+    
+    free(posicoes);
+    return valido;
+}
+
+/**
+ * @brief Abre um ranking em disco, criando-o se ainda não existir
+ * @param rankingPtr Ranking a inicializar
+ * @param caminho Arquivo do ranking
+ * @param capacidade Recordes mantidos ao criar um arquivo novo (ignorada se ele existe)
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+int abrirRanking(RankingRecordes* rankingPtr, const char* caminho, uint32_t capacidade) {
+    size_t tamanhoNovo = sizeof(CabecalhoRanking) + ((size_t)capacidade + 1) * sizeof(NoRanking);
+    size_t tamanho;
+    int novo;
+    
+    rankingPtr->caminho = caminho;
+    rankingPtr->descritor = -1;
+#ifdef _WIN32
+    FILE* arquivo = fopen(caminho, "rb");
+    long existente = 0;
+    if (arquivo != NULL) {
+        fseek(arquivo, 0, SEEK_END);
+        existente = ftell(arquivo);
+        fseek(arquivo, 0, SEEK_SET);
+    }
+    novo = (existente == 0);
+    tamanho = novo ? tamanhoNovo : (size_t)existente;
+    void* dados = calloc(1, tamanho);
+    if (dados == NULL || (!novo && fread(dados, 1, tamanho, arquivo) != tamanho)) {
+        free(dados);
+        if (arquivo != NULL) {
+            fclose(arquivo);
+        }
+        printf("Nao foi possivel abrir o ranking %s\n", caminho);
+        return 0;
+    }
+    if (arquivo != NULL) {
+        fclose(arquivo);
+    }
+#else
+    int descritor = open(caminho, O_RDWR | O_CREAT, 0644);
+    struct stat informacoes;
+    if (descritor >= 0) {
+        travarArquivoRanking(descritor, TRAVA_RANKING_EXCLUSIVA);  // Outro processo pode estar criando o mesmo arquivo
+    }
+    if (descritor < 0 || fstat(descritor, &informacoes) != 0) {
+        if (descritor >= 0) {
+            close(descritor);
+        }
+        printf("Nao foi possivel abrir o ranking %s\n", caminho);
+        return 0;
+    }
+    novo = (informacoes.st_size == 0);
+    tamanho = novo ? tamanhoNovo : (size_t)informacoes.st_size;
+    if (novo && ftruncate(descritor, (off_t)tamanho) != 0) {
+        close(descritor);
+        printf("Nao foi possivel criar o ranking %s\n", caminho);
+        return 0;
+    }
+    void* dados = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+    if (dados == MAP_FAILED) {
+        close(descritor);
+        printf("Nao foi possivel mapear o ranking %s\n", caminho);
+        return 0;
+    }
+    rankingPtr->descritor = descritor;
+#endif
+    rankingPtr->cabecalho = dados;
+    rankingPtr->nos = (NoRanking*)((char*)dados + sizeof(CabecalhoRanking));
+    rankingPtr->tamanhoMapeado = tamanho;
+    
+    CabecalhoRanking* cabecalhoPtr = rankingPtr->cabecalho;
+    if (novo) {
+        // Arquivo recém-criado: já vem zerado, basta o cabeçalho
+        memcpy(cabecalhoPtr->magica, "TRNK", 4);
+        cabecalhoPtr->versao = VERSAO_RANKING;
+        cabecalhoPtr->capacidade = capacidade;
+        cabecalhoPtr->niveis = 1;
+        cabecalhoPtr->estadoAleatorio = 0x9E3779B97F4A7C15ull;
+    }
+    // Um arquivo existente é conferido por inteiro (com a trava tomada): os
+    // índices dos nós são seguidos diretamente no mapeamento compartilhado
+    int compativel = novo ||
+                     (tamanho >= sizeof(CabecalhoRanking) && memcmp(cabecalhoPtr->magica, "TRNK", 4) == 0 &&
+                      cabecalhoPtr->versao == VERSAO_RANKING &&
+                      tamanho == sizeof(CabecalhoRanking) + ((size_t)cabecalhoPtr->capacidade + 1) * sizeof(NoRanking) &&
+                      cabecalhoPtr->quantidade <= cabecalhoPtr->capacidade &&
+                      cabecalhoPtr->niveis >= 1 && cabecalhoPtr->niveis <= NIVEIS_RANKING &&
+                      validarEstruturaRanking(cabecalhoPtr, rankingPtr->nos));
+#ifndef _WIN32
+    travarArquivoRanking(descritor, TRAVA_RANKING_LIVRE);
+#endif
+    if (!compativel) {
+        printf("%s nao e um ranking compativel.\n", caminho);
+#ifdef _WIN32
+        free(dados);
+#else
+        munmap(dados, tamanho);
+        close(descritor);
+#endif
+        rankingPtr->cabecalho = NULL;
+        return 0;
+    }
+    
+    pthread_mutex_init(&rankingPtr->trava, NULL);
+    return 1;
+}
+
+/**
+ * @brief Grava as alterações pendentes e fecha o ranking
+ * @param rankingPtr Ranking aberto
+ */
+void fecharRanking(RankingRecordes* rankingPtr) {
+    if (rankingPtr->cabecalho == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    // Sem mmap: o arquivo inteiro é regravado ao fechar
+    FILE* arquivo = fopen(rankingPtr->caminho, "wb");
+    if (arquivo == NULL || fwrite(rankingPtr->cabecalho, 1, rankingPtr->tamanhoMapeado, arquivo) != rankingPtr->tamanhoMapeado) {
+        printf("Falha ao gravar o ranking %s\n", rankingPtr->caminho);
+    }
+    if (arquivo != NULL) {
+        fclose(arquivo);
+    }
+    free(rankingPtr->cabecalho);
+#else
+    msync(rankingPtr->cabecalho, rankingPtr->tamanhoMapeado, MS_ASYNC);
+    munmap(rankingPtr->cabecalho, rankingPtr->tamanhoMapeado);
+    close(rankingPtr->descritor);
+#endif
+    pthread_mutex_destroy(&rankingPtr->trava);
+    rankingPtr->cabecalho = NULL;
+    rankingPtr->nos = NULL;
+}
+
+/**
+ * @brief Remove o último colocado (chamada com a trava tomada)
+ * @param rankingPtr Ranking cheio
+ * @return Índice do nó liberado
+ */
+static uint32_t removerUltimoRanking(RankingRecordes* rankingPtr) {
+    CabecalhoRanking* cabecalhoPtr = rankingPtr->cabecalho;
+    NoRanking* nos = rankingPtr->nos;
+    
+    // O último nó é alcançado descendo pelos níveis até o fim de cada um
+    uint32_t ultimo = 0;
+    for (int i = (int)cabecalhoPtr->niveis - 1; i >= 0; i--) {
+        while (nos[ultimo].proximo[i] != 0) {
+            ultimo = nos[ultimo].proximo[i];
+        }
+    }
+    
+    uint32_t anterior = 0;
+    for (int i = (int)cabecalhoPtr->niveis - 1; i >= 0; i--) {
+        while (nos[anterior].proximo[i] != 0 && nos[anterior].proximo[i] != ultimo) {
+            anterior = nos[anterior].proximo[i];
+        }
+        if (nos[anterior].proximo[i] == ultimo) {
+            nos[anterior].salto[i] += nos[ultimo].salto[i] - 1;
+            nos[anterior].proximo[i] = nos[ultimo].proximo[i];
+        } else {
+            nos[anterior].salto[i]--;
+        }
+    }
+    while (cabecalhoPtr->niveis > 1 && nos[0].proximo[cabecalhoPtr->niveis - 1] == 0) {
+        cabecalhoPtr->niveis--;
+    }
+    __atomic_store_n(&cabecalhoPtr->quantidade, cabecalhoPtr->quantidade - 1, __ATOMIC_RELAXED);
+    return ultimo;
+}
+
+/**
+ * @brief Registra o resultado de uma partida no ranking
+ * @param rankingPtr Ranking aberto
+ * @param sistemaPtr Sistema Expert ao fim da partida
+ * @return Posição obtida (1 = primeiro), ou 0 se a pontuação não entrou
+ * 
+ * Segura para várias threads. Com o ranking cheio, uma pontuação que não
+ * supera o último colocado é recusada sem tomar a trava; caso contrário o
+ * último é descartado e seu nó reaproveitado.
+ */
+int registrarRecorde(RankingRecordes* rankingPtr, const SistemaExpert* sistemaPtr) {
+    CabecalhoRanking* cabecalhoPtr = rankingPtr->cabecalho;
+    NoRanking* nos = rankingPtr->nos;
+    int32_t pontuacao = sistemaPtr->pontuacaoTotal;
+    
+    if (__atomic_load_n(&cabecalhoPtr->quantidade, __ATOMIC_RELAXED) == cabecalhoPtr->capacidade &&
+        pontuacao <= __atomic_load_n(&cabecalhoPtr->menorPontuacao, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+    
+    travarRanking(rankingPtr, 1);
+    
+    uint32_t indiceNovo;
+    if (cabecalhoPtr->quantidade == cabecalhoPtr->capacidade) {
+        if (cabecalhoPtr->capacidade == 0 || pontuacao <= cabecalhoPtr->menorPontuacao) {
+            destravarRanking(rankingPtr);
+            return 0;
+        }
+        indiceNovo = removerUltimoRanking(rankingPtr);
+    } else {
+        indiceNovo = cabecalhoPtr->quantidade + 1;
+    }
+    
+    NoRanking* novoPtr = &nos[indiceNovo];
+    novoPtr->registro.pontuacao = pontuacao;
+    novoPtr->registro.nivel = sistemaPtr->nivelAtual;
+    novoPtr->registro.melhorCombo = sistemaPtr->melhorCombo;
+    novoPtr->registro.totalJogadas = sistemaPtr->totalJogadas;
+    novoPtr->registro.sequencia = cabecalhoPtr->sequencia++;
+    novoPtr->registro.registradoEm = (int64_t)time(NULL);
+    
+    // Busca dos predecessores em cada nível, acumulando a posição
+    uint32_t anteriores[NIVEIS_RANKING];
+    uint32_t posicoes[NIVEIS_RANKING];
+    uint32_t atual = 0;
+    for (int i = (int)cabecalhoPtr->niveis - 1; i >= 0; i--) {
+        posicoes[i] = (i == (int)cabecalhoPtr->niveis - 1) ? 0 : posicoes[i + 1];
+        while (nos[atual].proximo[i] != 0 && recordeAntes(&nos[nos[atual].proximo[i]].registro, &novoPtr->registro)) {
+            posicoes[i] += nos[atual].salto[i];
+            atual = nos[atual].proximo[i];
+        }
+        anteriores[i] = atual;
+    }
+    
+    int nivel = sortearNivelRanking(cabecalhoPtr);
+    if (nivel > (int)cabecalhoPtr->niveis) {
+        for (int i = (int)cabecalhoPtr->niveis; i < nivel; i++) {
+            posicoes[i] = 0;
+            anteriores[i] = 0;
+            nos[0].proximo[i] = 0;
+            nos[0].salto[i] = cabecalhoPtr->quantidade;
+        }
+        cabecalhoPtr->niveis = (uint32_t)nivel;
+    }
+    
+    for (int i = 0; i < NIVEIS_RANKING; i++) {
+        if (i < nivel) {
+            NoRanking* anteriorPtr = &nos[anteriores[i]];
+            novoPtr->proximo[i] = anteriorPtr->proximo[i];
+            anteriorPtr->proximo[i] = indiceNovo;
+            novoPtr->salto[i] = anteriorPtr->salto[i] - (posicoes[0] - posicoes[i]);
+            anteriorPtr->salto[i] = posicoes[0] - posicoes[i] + 1;
+        } else {
+            novoPtr->proximo[i] = 0;
+            novoPtr->salto[i] = 0;
+            if (i < (int)cabecalhoPtr->niveis) {
+                nos[anteriores[i]].salto[i]++;
+            }
+        }
+    }
+    
+    __atomic_store_n(&cabecalhoPtr->quantidade, cabecalhoPtr->quantidade + 1, __ATOMIC_RELAXED);
+    if (cabecalhoPtr->quantidade == cabecalhoPtr->capacidade) {
+        uint32_t ultimo = 0;
+        for (int i = (int)cabecalhoPtr->niveis - 1; i >= 0; i--) {
+            while (nos[ultimo].proximo[i] != 0) {
+                ultimo = nos[ultimo].proximo[i];
+            }
+        }
+        __atomic_store_n(&cabecalhoPtr->menorPontuacao, nos[ultimo].registro.pontuacao, __ATOMIC_RELAXED);
+    }
+    
+    destravarRanking(rankingPtr);
+    return (int)posicoes[0] + 1;
+}
+
+/**
+ * @brief Posição que uma pontuação ocuparia no ranking
+ * @param rankingPtr Ranking aberto
+ * @param pontuacao Pontuação consultada
+ * @return 1 + quantidade de recordes com pontuação maior ou igual (O(log n))
+ */
+int posicaoNoRanking(RankingRecordes* rankingPtr, int pontuacao) {
+    travarRanking(rankingPtr, 0);
+    const NoRanking* nos = rankingPtr->nos;
+    uint32_t posicao = 0;
+    uint32_t atual = 0;
+    for (int i = (int)rankingPtr->cabecalho->niveis - 1; i >= 0; i--) {
+        while (nos[atual].proximo[i] != 0 && nos[nos[atual].proximo[i]].registro.pontuacao >= pontuacao) {
+            posicao += nos[atual].salto[i];
+            atual = nos[atual].proximo[i];
+        }
+    }
+    destravarRanking(rankingPtr);
+    return (int)posicao + 1;
+}
+
+/**
+ * @brief Copia os K melhores recordes, do primeiro para o último
+ * @param rankingPtr Ranking aberto
+ * @param destino Vetor com espaço para quantidade registros
+ * @param quantidade K
+ * @return Registros copiados (limitado ao tamanho do ranking)
+ */
+int consultarMelhoresRecordes(RankingRecordes* rankingPtr, RegistroRecorde* destino, int quantidade) {
+    travarRanking(rankingPtr, 0);
+    const NoRanking* nos = rankingPtr->nos;
+    int copiados = 0;
+    for (uint32_t atual = nos[0].proximo[0]; atual != 0 && copiados < quantidade; atual = nos[atual].proximo[0]) {
+        destino[copiados++] = nos[atual].registro;
+    }
+    destravarRanking(rankingPtr);
+    return copiados;
+}
+
+/**
+ * @brief Exibe os K melhores recordes do ranking
+ * @param rankingPtr Ranking aberto
+ * @param quantidade K
+ */
+void exibirRanking(RankingRecordes* rankingPtr, int quantidade) {
+    RegistroRecorde* melhores = malloc(sizeof(RegistroRecorde) * (quantidade > 0 ? quantidade : 1));
+    if (melhores == NULL) {
+        printf("Memoria insuficiente para o ranking.\n");
+        return;
+    }
+    int total = consultarMelhoresRecordes(rankingPtr, melhores, quantidade);
+    
+    printf("*** RANKING (%u recordes, capacidade %u):\n",
+           rankingPtr->cabecalho->quantidade, rankingPtr->cabecalho->capacidade);
+    printf("   %5s %10s %6s %6s %8s\n", "pos.", "pontuacao", "nivel", "combo", "jogadas");
+    for (int i = 0; i < total; i++) {
+        printf("   %5d %10d %6d %6d %8d\n", i + 1, melhores[i].pontuacao, melhores[i].nivel,
+               melhores[i].melhorCombo, melhores[i].totalJogadas);
+    }
+    free(melhores);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                     HASH ZOBRIST E TABELA DE TRANSPOSIÇÃO
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Hash Zobrist de uma configuração de jogo
+ * @param filaPtr Fila (a prévia das próximas peças)
+ * @param pilhaPtr Pilha de reserva
+ * @param sistemaPtr Sistema Expert (último tipo jogado e sequência atual)
+ * @return Hash da configuração
+ * 
+ * Configurações com as mesmas peças na fila, a mesma ordem na pilha, o
+ * mesmo ultimoTipoJogado e a mesma sequenciaTipoAtual têm o mesmo hash,
+ * quaisquer que sejam os IDs e as posições no array circular. Custa O(1):
+ * fila e pilha mantêm seus hashes a cada operação.
+ */
+uint64_t hashZobristEstado(const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr, const SistemaExpert* sistemaPtr) {
+    uint64_t combo = zobristUltimoTipo[indiceTipoPeca(sistemaPtr->ultimoTipoJogado)] *
+                     (2 * (uint64_t)(uint32_t)sistemaPtr->sequenciaTipoAtual + 1);
+    return filaPtr->hashZobrist ^ pilhaPtr->hashZobrist ^ combo;
+}
+
+/**
+ * @brief Aloca uma tabela de transposição vazia
+ * @param tabelaPtr Tabela a inicializar
+ * @param bits Log2 da quantidade de entradas (ao menos 2)
+ * @return 1 em caso de sucesso, 0 se faltou memória
+ */
+int inicializarTabelaTransposicao(TabelaTransposicao* tabelaPtr, int bits) {
+    size_t baldes = ((size_t)1 << (bits < 2 ? 2 : bits)) / ENTRADAS_BALDE_TRANSPOSICAO;
+    void* bloco;
+    
+    if (posix_memalign(&bloco, sizeof(BaldeTransposicao), baldes * sizeof(BaldeTransposicao)) != 0) {
+        tabelaPtr->baldes = NULL;
+        return 0;
+    }
+    memset(bloco, 0, baldes * sizeof(BaldeTransposicao));
+    tabelaPtr->baldes = bloco;
+    tabelaPtr->mascara = baldes - 1;
+    return 1;
+}
+
+/**
+ * @brief Libera a memória de uma tabela de transposição
+ * @param tabelaPtr Tabela inicializada
+ */
+void liberarTabelaTransposicao(TabelaTransposicao* tabelaPtr) {
+    free(tabelaPtr->baldes);
+    tabelaPtr->baldes = NULL;
+}
+
+/**
+ * @brief Procura o valor de um estado na tabela de transposição
+ * @param tabelaPtr Tabela de transposição
+ * @param chave Chave do estado (não nula)
+ * @param valorPtr Recebe o valor, se encontrado
+ * @return 1 se o estado estava na tabela, 0 caso contrário
+ */
+int consultarTabelaTransposicao(const TabelaTransposicao* tabelaPtr, uint64_t chave, double* valorPtr) {
+    const BaldeTransposicao* baldePtr = &tabelaPtr->baldes[chave & tabelaPtr->mascara];
+    
+    for (int i = 0; i < ENTRADAS_BALDE_TRANSPOSICAO; i++) {
+        uint64_t misturada = __atomic_load_n(&baldePtr->entradas[i].chaveMisturada, __ATOMIC_RELAXED);
+        uint64_t dado = __atomic_load_n(&baldePtr->entradas[i].dado, __ATOMIC_RELAXED);
+        if ((misturada ^ dado) == chave) {
+            memcpy(valorPtr, &dado, sizeof(*valorPtr));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Grava o valor de um estado na tabela de transposição
+ * @param tabelaPtr Tabela de transposição
+ * @param chave Chave do estado (não nula)
+ * @param valor Valor a guardar
+ * 
+ * Reaproveita a entrada do mesmo estado ou uma vazia do balde; com o balde
+ * cheio, substitui a entrada indicada pelos bits altos da chave.
+ */
+void gravarTabelaTransposicao(TabelaTransposicao* tabelaPtr, uint64_t chave, double valor) {
+    BaldeTransposicao* baldePtr = &tabelaPtr->baldes[chave & tabelaPtr->mascara];
+    int alvo = (int)(chave >> 62) & (ENTRADAS_BALDE_TRANSPOSICAO - 1);
+    uint64_t dado;
+    
+    for (int i = 0; i < ENTRADAS_BALDE_TRANSPOSICAO; i++) {
+        uint64_t misturada = __atomic_load_n(&baldePtr->entradas[i].chaveMisturada, __ATOMIC_RELAXED);
+        uint64_t antigo = __atomic_load_n(&baldePtr->entradas[i].dado, __ATOMIC_RELAXED);
+        if ((misturada ^ antigo) == chave || (misturada | antigo) == 0) {
+            alvo = i;
+            break;
+        }
+    }
+    memcpy(&dado, &valor, sizeof(dado));
+    __atomic_store_n(&baldePtr->entradas[alvo].chaveMisturada, chave ^ dado, __ATOMIC_RELAXED);
+    __atomic_store_n(&baldePtr->entradas[alvo].dado, dado, __ATOMIC_RELAXED);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                      CONSELHEIRO DE JOGADAS (EXPECTIMAX)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Mistura um valor no hash de estado do conselheiro
+ * @param hash Hash acumulado
+ * @param valor Valor a incorporar
+ * @return Novo hash
+ */
+static inline uint64_t misturarChaveConselheiro(uint64_t hash, uint64_t valor) {
+    hash ^= valor + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash * 0xBF58476D1CE4E5B9ULL;
+}
+
+/**
+ * @brief Calcula a chave de transposição de um estado da busca
+ * @param estadoPtr Estado examinado
+ * @param jogadas Jogadas pontuadas restantes
+ * @return Chave não nula
+ * 
+ * Parte do hash Zobrist de peças e combo (mantido pela fila e pela pilha)
+ * e acrescenta o que mais influencia os pontos futuros: o nível, a
+ * distância até o próximo nível e os multiplicadores. A pontuação absoluta
+ * não entra na chave, o que aumenta as transposições.
+ */
+static uint64_t chaveEstadoConselheiro(const EstadoConselheiro* estadoPtr, int jogadas) {
+    const SistemaExpert* sistemaPtr = &estadoPtr->sistema;
+    uint64_t hash = hashZobristEstado(&estadoPtr->fila, &estadoPtr->pilha, sistemaPtr);
+    uint64_t bitsMultiplicador, bitsDificuldade;
+    
+    memcpy(&bitsMultiplicador, &sistemaPtr->multiplicadorAtual, sizeof(bitsMultiplicador));
+    memcpy(&bitsDificuldade, &sistemaPtr->fatorDificuldade, sizeof(bitsDificuldade));
+    hash = misturarChaveConselheiro(hash, (uint64_t)jogadas * 2 + estadoPtr->reservouAgora);
+    hash = misturarChaveConselheiro(hash, (uint32_t)sistemaPtr->nivelAtual);
+    hash = misturarChaveConselheiro(hash, (uint32_t)(sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal));
+    hash = misturarChaveConselheiro(hash, bitsMultiplicador);
+    hash = misturarChaveConselheiro(hash, bitsDificuldade);
+    hash ^= hash >> 31;
+    return hash | 1;
+}
+
+/**
+ * @brief Pontua uma jogada simulada com as regras de processarJogadaExpert
+ * @param sistemaPtr Cópia do sistema Expert usada pela busca
+ * @param tipoPeca Tipo da peça jogada
+ * @return Pontos obtidos
+ */
+static int pontuarJogadaConselheiro(SistemaExpert* sistemaPtr, char tipoPeca) {
+    int pontos = calcularPontuacao(tipoPeca, sistemaPtr);
+    double multiplicadorCombo = detectarCombo(sistemaPtr, tipoPeca);
+    pontos = (int)(pontos * multiplicadorCombo);
+    sistemaPtr->pontuacaoTotal += pontos;
+    aplicarProgressaoNivel(sistemaPtr);
+    return pontos;
+}
+
+static double buscarConselheiro(TrabalhadorConselheiro* trabalhadorPtr, const EstadoConselheiro* estadoPtr, int jogadas);
+
+/**
+ * @brief Valor esperado de aplicar uma ação a um estado
+ * @param trabalhadorPtr Thread de busca
+ * @param estadoPtr Estado atual (a fila deve ter ao menos uma peça conhecida
+ *                  para as ações 1 e 3)
+ * @param acao Ação no formato do menu (1=fila, 2=pilha, 3=reservar)
+ * @param jogadas Jogadas pontuadas restantes
+ * @return Pontos esperados, ou -1 se a ação não puder ser aplicada
+ * 
+ * Reservar não consome jogada; como a pilha é limitada, a recursão termina.
+ * Jogar da pilha logo após reservar repetiria a jogada da fila com a mesma
+ * peça e por isso não é examinado.
+ */
+static double valorAcaoConselheiro(TrabalhadorConselheiro* trabalhadorPtr, const EstadoConselheiro* estadoPtr,
+                                   int acao, int jogadas) {
+    EstadoConselheiro proximo;
+    
+    switch (acao) {
+        case 1: {
+            if (estadoPtr->fila.quantidadePecas == 0) {
+                return -1;
+            }
+            proximo = *estadoPtr;
+            Peca peca = jogarPecaDaFila(&proximo.fila);
+            proximo.reservouAgora = 0;
+            int pontos = pontuarJogadaConselheiro(&proximo.sistema, peca.tipo);
+            return pontos + buscarConselheiro(trabalhadorPtr, &proximo, jogadas - 1);
+        }
+        case 2: {
+            if (estadoPtr->pilha.quantidadeReservada == 0 || estadoPtr->reservouAgora) {
+                return -1;
+            }
+            proximo = *estadoPtr;
+            Peca peca = jogarPecaDaPilha(&proximo.pilha);
+            int pontos = pontuarJogadaConselheiro(&proximo.sistema, peca.tipo);
+            return pontos + buscarConselheiro(trabalhadorPtr, &proximo, jogadas - 1);
+        }
+        case 3:
+            if (estadoPtr->fila.quantidadePecas == 0 || estadoPtr->pilha.quantidadeReservada == CAPACIDADE_PILHA) {
+                return -1;
+            }
+            proximo = *estadoPtr;
+            reservarPeca(&proximo.pilha, jogarPecaDaFila(&proximo.fila));
+            proximo.reservouAgora = 1;
+            return buscarConselheiro(trabalhadorPtr, &proximo, jogadas);
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Melhor valor entre as ações de um estado cuja frente é conhecida
+ */
+static double melhorAcaoConselheiro(TrabalhadorConselheiro* trabalhadorPtr, const EstadoConselheiro* estadoPtr, int jogadas) {
+    double melhor = -1;
+    for (int acao = 1; acao <= ACOES_CONSELHEIRO; acao++) {
+        double valor = valorAcaoConselheiro(trabalhadorPtr, estadoPtr, acao, jogadas);
+        if (valor > melhor) {
+            melhor = valor;
+        }
+    }
+    return melhor;
+}
+
+/**
+ * @brief Nó da busca expectimax (com tabela de transposição)
+ * @param trabalhadorPtr Thread de busca
+ * @param estadoPtr Estado examinado
+ * @param jogadas Jogadas pontuadas restantes
+ * @return Pontos esperados nas próximas jogadas com jogo ótimo
+ * 
+ * Quando a fila conhecida acaba, a próxima peça é um nó de acaso: cada um
+ * dos 7 tipos com probabilidade 1/7 (modelo do gerador uniforme), revelado
+ * antes da escolha da ação, como no jogo.
+ */
+static double buscarConselheiro(TrabalhadorConselheiro* trabalhadorPtr, const EstadoConselheiro* estadoPtr, int jogadas) {
+    if (jogadas == 0 || trabalhadorPtr->abortado) {
+        return 0;
+    }
+    
+    // O orçamento de estados é conferido a cada estado; o relógio, a cada 256
+    trabalhadorPtr->nos++;
+    if (trabalhadorPtr->limiteNos > 0 && trabalhadorPtr->nos > trabalhadorPtr->limiteNos) {
+        trabalhadorPtr->abortado = 1;
+        return 0;
+    }
+    if (trabalhadorPtr->prazo > 0 && (trabalhadorPtr->nos & 255) == 0 &&
+        obterTempoNanossegundos() > trabalhadorPtr->prazo) {
+        trabalhadorPtr->abortado = 1;
+        return 0;
+    }
+    
+    uint64_t chave = chaveEstadoConselheiro(estadoPtr, jogadas);
+    double valor;
+    if (consultarTabelaTransposicao(trabalhadorPtr->tabela, chave, &valor)) {
+        trabalhadorPtr->acertosCache++;
+        return valor;
+    }
+    
+    if (estadoPtr->fila.quantidadePecas > 0) {
+        valor = melhorAcaoConselheiro(trabalhadorPtr, estadoPtr, jogadas);
+    } else {
+        double soma = 0;
+        for (int i = 0; i < PECA_DESCONHECIDA; i++) {
+            EstadoConselheiro sorteado = *estadoPtr;
+            inserirPecaNaFila(&sorteado.fila, criarPeca(tiposPecas[i], 0));
+            soma += melhorAcaoConselheiro(trabalhadorPtr, &sorteado, jogadas);
+        }
+        valor = soma / PECA_DESCONHECIDA;
+    }
+    
+    // Valores de uma profundidade interrompida estão incompletos
+    if (!trabalhadorPtr->abortado) {
+        gravarTabelaTransposicao(trabalhadorPtr->tabela, chave, valor);
+    }
+    return valor;
+}
+
+/**
+ * @brief Aprofundamento iterativo das ações da raiz atribuídas a uma thread
+ * @param argumento Ponteiro para o TrabalhadorConselheiro
+ * @return NULL
+ * 
+ * A thread i examina as ações i, i + n, ... da raiz. Cada profundidade só
+ * é registrada se terminar antes do prazo e dentro do orçamento de estados;
+ * a profundidade 1 ignora ambos para que sempre exista uma resposta. O
+ * orçamento conta estados, não tempo: com uma thread, a profundidade
+ * alcançada (e a resposta) é a mesma em qualquer máquina.
+ */
+static void* executarTrabalhadorConselheiro(void* argumento) {
+    TrabalhadorConselheiro* trabalhadorPtr = argumento;
+    ConselheiroJogadas* conselheiroPtr = trabalhadorPtr->conselheiroPtr;
+    double prazo = trabalhadorPtr->prazo;
+    
+    for (int profundidade = 1; profundidade <= conselheiroPtr->config.profundidade; profundidade++) {
+        trabalhadorPtr->prazo = profundidade > 1 ? prazo : 0;
+        trabalhadorPtr->limiteNos = profundidade > 1 ? conselheiroPtr->config.orcamentoNos : 0;
+        for (int i = trabalhadorPtr->indice; i < conselheiroPtr->totalAcoes; i += conselheiroPtr->totalTrabalhadores) {
+            double valor = valorAcaoConselheiro(trabalhadorPtr, &conselheiroPtr->raiz,
+                                                conselheiroPtr->acoes[i], profundidade);
+            if (trabalhadorPtr->abortado) {
+                return NULL;
+            }
+            conselheiroPtr->valores[i][profundidade] = valor;
+            conselheiroPtr->profundidadeConcluida[i] = profundidade;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prepara um conselheiro de jogadas
+ * @param conselheiroPtr Conselheiro a inicializar
+ * @param configPtr Parâmetros da busca
+ * @return 1 em caso de sucesso, 0 se faltou memória
+ * 
+ * Mais de ACOES_CONSELHEIRO threads não teriam ações da raiz para examinar.
+ */
+int inicializarConselheiro(ConselheiroJogadas* conselheiroPtr, const ConfiguracaoConselheiro* configPtr) {
+    conselheiroPtr->config = *configPtr;
+    if (conselheiroPtr->config.profundidade < 1) {
+        conselheiroPtr->config.profundidade = 1;
+    }
+    if (conselheiroPtr->config.profundidade > PROFUNDIDADE_MAXIMA_CONSELHEIRO) {
+        conselheiroPtr->config.profundidade = PROFUNDIDADE_MAXIMA_CONSELHEIRO;
+    }
+    
+    int threads = configPtr->threads < 1 ? 1 : configPtr->threads;
+    conselheiroPtr->totalTrabalhadores = threads > ACOES_CONSELHEIRO ? ACOES_CONSELHEIRO : threads;
+    conselheiroPtr->trabalhadores = calloc(conselheiroPtr->totalTrabalhadores, sizeof(TrabalhadorConselheiro));
+    if (conselheiroPtr->trabalhadores == NULL) {
+        return 0;
+    }
+    if (!inicializarTabelaTransposicao(&conselheiroPtr->tabela, configPtr->bitsCache)) {
+        free(conselheiroPtr->trabalhadores);
+        conselheiroPtr->trabalhadores = NULL;
+        return 0;
+    }
+    
+    for (int t = 0; t < conselheiroPtr->totalTrabalhadores; t++) {
+        TrabalhadorConselheiro* trabalhadorPtr = &conselheiroPtr->trabalhadores[t];
+        trabalhadorPtr->tabela = &conselheiroPtr->tabela;
+        trabalhadorPtr->indice = t;
+        trabalhadorPtr->conselheiroPtr = conselheiroPtr;
+    }
+    return 1;
+}
+
+/**
+ * @brief Libera a tabela de transposição e as threads de um conselheiro
+ * @param conselheiroPtr Conselheiro inicializado
+ */
+void liberarConselheiro(ConselheiroJogadas* conselheiroPtr) {
+    if (conselheiroPtr->trabalhadores == NULL) {
+        return;
+    }
+    liberarTabelaTransposicao(&conselheiroPtr->tabela);
+    free(conselheiroPtr->trabalhadores);
+    conselheiroPtr->trabalhadores = NULL;
+}
+
+/**
+ * @brief Sugere a ação que maximiza a pontuação esperada
+ * @param conselheiroPtr Conselheiro inicializado
+ * @param filaPtr Fila atual (prévia conhecida das próximas peças)
+ * @param pilhaPtr Pilha de reserva atual
+ * @param sistemaPtr Sistema Expert atual
+ * @param sugestaoPtr Resposta (ação, valores e estatísticas da busca)
+ * @return Ação sugerida no formato do menu (1=fila, 2=pilha, 3=reservar, 4=gerar)
+ * 
+ * Compara as ações na maior profundidade concluída por todas elas dentro
+ * do orçamento de tempo; no empate prevalece a ordem 1, 2, 3.
+ */
+int aconselharJogada(ConselheiroJogadas* conselheiroPtr, const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr,
+                     const SistemaExpert* sistemaPtr, SugestaoConselheiro* sugestaoPtr) {
+    EstadoConselheiro* raizPtr = &conselheiroPtr->raiz;
+    double inicio = obterTempoNanossegundos();
+    
+    raizPtr->fila = *filaPtr;
+    raizPtr->pilha = *pilhaPtr;
+    raizPtr->reservouAgora = 0;
+    raizPtr->sistema = *sistemaPtr;
+    
+    conselheiroPtr->totalAcoes = 0;
+    sugestaoPtr->valorPorAcao[0] = -1;
+    for (int acao = 1; acao <= ACOES_CONSELHEIRO; acao++) {
+        int valida = (acao == 1) ? filaPtr->quantidadePecas > 0
+                   : (acao == 2) ? pilhaPtr->quantidadeReservada > 0
+                   : filaPtr->quantidadePecas > 0 && pilhaPtr->quantidadeReservada < CAPACIDADE_PILHA;
+        sugestaoPtr->valorPorAcao[acao] = -1;
+        if (valida) {
+            conselheiroPtr->profundidadeConcluida[conselheiroPtr->totalAcoes] = 0;
+            conselheiroPtr->acoes[conselheiroPtr->totalAcoes++] = acao;
+        }
+    }
+    
+    sugestaoPtr->acao = 4;
+    sugestaoPtr->valorEsperado = 0;
+    sugestaoPtr->profundidade = 0;
+    sugestaoPtr->nos = 0;
+    sugestaoPtr->acertosCache = 0;
+    if (conselheiroPtr->totalAcoes == 0) {
+        // Fila e pilha vazias: só resta gerar peças
+        sugestaoPtr->milissegundos = (obterTempoNanossegundos() - inicio) / 1e6;
+        return sugestaoPtr->acao;
+    }
+    
+    // Busca: a thread 0 é a própria chamadora
+    int threads = conselheiroPtr->totalTrabalhadores < conselheiroPtr->totalAcoes
+                ? conselheiroPtr->totalTrabalhadores : conselheiroPtr->totalAcoes;
+    pthread_t auxiliares[ACOES_CONSELHEIRO];
+    int auxiliarIniciado[ACOES_CONSELHEIRO] = {0};
+    int totalTrabalhadores = conselheiroPtr->totalTrabalhadores;
+    conselheiroPtr->totalTrabalhadores = threads;
+    for (int t = 0; t < threads; t++) {
+        TrabalhadorConselheiro* trabalhadorPtr = &conselheiroPtr->trabalhadores[t];
+        trabalhadorPtr->nos = 0;
+        trabalhadorPtr->acertosCache = 0;
+        trabalhadorPtr->abortado = 0;
+        trabalhadorPtr->prazo = conselheiroPtr->config.orcamentoMs > 0 ? inicio + conselheiroPtr->config.orcamentoMs * 1e6 : 0;
+    }
+    for (int t = 1; t < threads; t++) {
+        auxiliarIniciado[t] = (pthread_create(&auxiliares[t], NULL, executarTrabalhadorConselheiro,
+                                              &conselheiroPtr->trabalhadores[t]) == 0);
+        if (!auxiliarIniciado[t]) {
+            // Sem thread disponível: a parte deste trabalhador roda na chamadora
+            executarTrabalhadorConselheiro(&conselheiroPtr->trabalhadores[t]);
+        }
+    }
+    executarTrabalhadorConselheiro(&conselheiroPtr->trabalhadores[0]);
+    for (int t = 1; t < threads; t++) {
+        if (auxiliarIniciado[t]) {
+            pthread_join(auxiliares[t], NULL);
+        }
+    }
+    conselheiroPtr->totalTrabalhadores = totalTrabalhadores;
+    
+    // Profundidade comum a todas as ações e escolha da melhor
+    int profundidade = conselheiroPtr->config.profundidade;
+    for (int i = 0; i < conselheiroPtr->totalAcoes; i++) {
+        if (conselheiroPtr->profundidadeConcluida[i] < profundidade) {
+            profundidade = conselheiroPtr->profundidadeConcluida[i];
+        }
+    }
+    sugestaoPtr->profundidade = profundidade;
+    sugestaoPtr->valorEsperado = -1;
+    for (int i = 0; i < conselheiroPtr->totalAcoes; i++) {
+        double valor = conselheiroPtr->valores[i][profundidade];
+        sugestaoPtr->valorPorAcao[conselheiroPtr->acoes[i]] = valor;
+        if (valor > sugestaoPtr->valorEsperado) {
+            sugestaoPtr->valorEsperado = valor;
+            sugestaoPtr->acao = conselheiroPtr->acoes[i];
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        sugestaoPtr->nos += conselheiroPtr->trabalhadores[t].nos;
+        sugestaoPtr->acertosCache += conselheiroPtr->trabalhadores[t].acertosCache;
+    }
+    sugestaoPtr->milissegundos = (obterTempoNanossegundos() - inicio) / 1e6;
+    return sugestaoPtr->acao;
+}
+
+/**
+ * @brief Exibe a sugestão do conselheiro no jogo interativo
+ * @param filaPtr Fila atual
+ * @param pilhaPtr Pilha de reserva atual
+ * @param sugestaoPtr Sugestão calculada por aconselharJogada
+ */
+void exibirSugestaoConselheiro(const FilaCircular* filaPtr, const PilhaReserva* pilhaPtr, const SugestaoConselheiro* sugestaoPtr) {
+    static const char* nomesAcoes[] = {"", "Jogar peca da fila", "Jogar peca da pilha de reserva",
+                                       "Transferir peca da fila para reserva", "Gerar novas pecas aleatorias"};
+    
+    printf("\n*** CONSELHEIRO: %d. %s", sugestaoPtr->acao, nomesAcoes[sugestaoPtr->acao]);
+    if (sugestaoPtr->acao == 1 || sugestaoPtr->acao == 3) {
+        printf(" (peca %c)", tipoPecaCompacta(filaPtr->pecas[filaPtr->indiceFrente]));
+    } else if (sugestaoPtr->acao == 2) {
+        printf(" (peca %c)", tipoPecaCompacta(pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo]));
+    }
+    printf("\n");
+    if (sugestaoPtr->acao == 4) {
+        return;
+    }
+    printf("   * Pontos esperados nas proximas %d jogadas:", sugestaoPtr->profundidade);
+    for (int acao = 1; acao <= ACOES_CONSELHEIRO; acao++) {
+        if (sugestaoPtr->valorPorAcao[acao] >= 0) {
+            printf("  [%d] %.1f", acao, sugestaoPtr->valorPorAcao[acao]);
+        }
+    }
+    printf("\n   * Busca: %lld estados (%lld da cache) em %.1f ms\n",
+           sugestaoPtr->nos, sugestaoPtr->acertosCache, sugestaoPtr->milissegundos);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              SIMULAÇÃO HEADLESS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Executa uma ação do menu sem qualquer interação com o terminal
+ * @param acao Ação no formato do menu (1=fila, 2=pilha, 3=reservar, 4=gerar)
+ * @param sessaoPtr Ponteiro para a sessão de jogo
+ * @return 1 se a ação foi aplicada, 0 se foi ignorada (estrutura vazia/cheia)
+ * 
+ * Reutiliza exatamente as mesmas funções do menu interativo, de modo que
+ * as regras de pontuação exercitadas aqui são as mesmas do jogo real.
+ */
+int executarAcaoHeadless(int acao, SessaoJogo* sessaoPtr) {
+    FilaCircular* filaPtr = &sessaoPtr->fila;
+    PilhaReserva* pilhaPtr = &sessaoPtr->pilha;
+    
+    switch (acao) {
+        case 1: {
+            if (filaVazia(filaPtr)) {
+                return 0;
+            }
+            Peca peca = jogarPecaDaFila(filaPtr);
+            registrarEventoLog(sessaoPtr->log, EVENTO_JOGADA, 0, peca, 0);
+            if (sessaoPtr->tabuleiro != NULL) {
+                processarJogadaTabuleiro(peca, 0, &sessaoPtr->sistema, sessaoPtr->tabuleiro);
+            } else {
+                processarJogadaExpert(peca, 0, &sessaoPtr->sistema);
+            }
+            return 1;
+        }
+        case 2: {
+            if (pilhaVazia(pilhaPtr)) {
+                return 0;
+            }
+            Peca peca = jogarPecaDaPilha(pilhaPtr);
+            registrarEventoLog(sessaoPtr->log, EVENTO_JOGADA, 1, peca, 0);
+            if (sessaoPtr->tabuleiro != NULL) {
+                processarJogadaTabuleiro(peca, 1, &sessaoPtr->sistema, sessaoPtr->tabuleiro);
+            } else {
+                processarJogadaExpert(peca, 1, &sessaoPtr->sistema);
+            }
+            return 1;
+        }
+        case 3:
+            if (filaVazia(filaPtr) || pilhaCheia(pilhaPtr)) {
+                return 0;
+            }
+            if (sessaoPtr->log != NULL) {
+                Peca frente;
+                espiarPecasDaFila(filaPtr, &frente, 1);
+                registrarEventoLog(sessaoPtr->log, EVENTO_RESERVA, 0, frente, 0);
+            }
+            transferirPecaFilaParaPilha(filaPtr, pilhaPtr);
+            return 1;
+        case 4:
+            gerarPecasAleatoriasSessao(sessaoPtr);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Escolhe a próxima ação segundo a política configurada
+ * @param configPtr Configuração da simulação
+ * @param sessaoPtr Ponteiro para a sessão de jogo
+ * @param passo Índice do passo atual (usado para percorrer o roteiro)
+ * @return Ação no formato do menu (1 a 4)
+ */
+int escolherAcaoPolitica(const ConfiguracaoSimulacao* configPtr, SessaoJogo* sessaoPtr, long long passo) {
+    FilaCircular* filaPtr = &sessaoPtr->fila;
+    PilhaReserva* pilhaPtr = &sessaoPtr->pilha;
+    
+    switch (configPtr->politica) {
+        case POLITICA_ROTEIRO: {
+            // O roteiro é validado na leitura dos argumentos: só contém '1' a '4'
+            const char* roteiro = configPtr->roteiro;
+            long long tamanho = (long long)strlen(roteiro);
+            return roteiro[passo % tamanho] - '0';
+        }
+        case POLITICA_ALEATORIA: {
+            // 60% fila, 20% pilha, 20% reserva
+            uint32_t sorteio = sortearLimitado(&sessaoPtr->gerador, 10);
+            if (sorteio < 6) return 1;
+            if (sorteio < 8) return 2;
+            return 3;
+        }
+        case POLITICA_CONSELHEIRO: {
+            SugestaoConselheiro sugestao;
+            return aconselharJogada(sessaoPtr->conselheiro, filaPtr, pilhaPtr, &sessaoPtr->sistema, &sugestao);
+        }
+        case POLITICA_GULOSA:
+        default: {
+            char ultimo = sessaoPtr->sistema.ultimoTipoJogado;
+            
+            // Continuar a sequência com a peça do topo da reserva
+            if (!pilhaVazia(pilhaPtr) &&
+                tipoPecaCompacta(pilhaPtr->pecasReservadas[pilhaPtr->indiceTopo]) == ultimo) {
+                return 2;
+            }
+            // Continuar a sequência com a peça da frente da fila
+            if (!filaVazia(filaPtr) && tipoPecaCompacta(filaPtr->pecas[filaPtr->indiceFrente]) == ultimo) {
+                return 1;
+            }
+            // Guardar a peça da frente para uma sequência futura
+            if (!filaVazia(filaPtr) && !pilhaCheia(pilhaPtr)) {
+                return 3;
+            }
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief Simula uma partida completa sem menu, pausas ou saída no terminal
+ * @param configPtr Configuração da simulação
+ * @param indicePartida Índice da partida (define a semente da sessão)
+ * @param resultadoPtr Resultado agregado a ser atualizado
+ * 
+ * A fila é reabastecida automaticamente sempre que esvazia. Ações que não
+ * podem ser aplicadas (por exemplo, jogar de uma pilha vazia) são contadas
+ * como inválidas e convertidas em uma jogada da fila, garantindo progresso.
+ */
+void simularPartidaHeadless(const ConfiguracaoSimulacao* configPtr, long long indicePartida, ResultadoSimulacao* resultadoPtr) {
+    SessaoJogo sessao;
+    inicializarSessaoJogo(&sessao, derivarSemente(configPtr->semente, indicePartida), configPtr->modoGerador);
+    sessao.log = configPtr->log;
+    registrarEventoLog(sessao.log, EVENTO_INICIO_SESSAO, 0, criarPeca('X', (int)indicePartida), configPtr->usarTabuleiro);
+    
+    TabuleiroJogo tabuleiro;
+    if (configPtr->usarTabuleiro) {
+        inicializarTabuleiro(&tabuleiro);
+        sessao.tabuleiro = &tabuleiro;
+    }
+    
+    // Conselheiro sem prazo, limitado por estados e com uma thread: a partida continua determinística
+    ConselheiroJogadas conselheiro;
+    if (configPtr->politica == POLITICA_CONSELHEIRO) {
+        ConfiguracaoConselheiro configConselheiro = {configPtr->profundidadeConselheiro, 1, 0, BITS_CACHE_CONSELHEIRO_SIMULACAO,
+                                                     configPtr->orcamentoNosConselheiro};
+        if (!inicializarConselheiro(&conselheiro, &configConselheiro)) {
+            printf("Memoria insuficiente para o conselheiro de jogadas.\n");
+            exit(1);
+        }
+        sessao.conselheiro = &conselheiro;
+    }
+    gerarPecasAleatoriasSessao(&sessao);
+    
+    // Regras em avaliação: pontuam as mesmas peças, sem influir nas decisões
+    EstadoBalanceamento balanceamento;
+    if (configPtr->regras != NULL) {
+        inicializarEstadoBalanceamento(configPtr->regras, &balanceamento);
+    }
+    
+    SistemaExpert* sistemaPtr = &sessao.sistema;
+    long long passo = 0;
+    while (sistemaPtr->totalJogadas < configPtr->jogadasPorPartida) {
+        if (filaVazia(&sessao.fila)) {
+            gerarPecasAleatoriasSessao(&sessao);
+            resultadoPtr->reabastecimentos++;
+        }
+        
+        int jogadasAntes = sistemaPtr->totalJogadas;
+        int acao = escolherAcaoPolitica(configPtr, &sessao, passo++);
+        if (!executarAcaoHeadless(acao, &sessao)) {
+            resultadoPtr->acoesInvalidas++;
+            executarAcaoHeadless(1, &sessao);
+        } else if (acao == 3) {
+            resultadoPtr->reservas++;
+        } else if (acao == 4) {
+            resultadoPtr->reabastecimentos++;
+        }
+        
+        if (configPtr->regras != NULL && sistemaPtr->totalJogadas != jogadasAntes) {
+            int combo = aplicarJogadaBalanceamento(configPtr->regras, &balanceamento, sistemaPtr->ultimoTipoJogado);
+            resultadoPtr->jogadasPorCombo[combo < FAIXAS_COMBO_BALANCEAMENTO ? combo : FAIXAS_COMBO_BALANCEAMENTO - 1]++;
+        }
+    }
+    
+    // Consolidação dos resultados da partida
+    resultadoPtr->partidas++;
+    resultadoPtr->totalJogadas += sistemaPtr->totalJogadas;
+    resultadoPtr->jogadasDaFila += sistemaPtr->jogadasDaFila;
+    resultadoPtr->jogadasDaPilha += sistemaPtr->jogadasDaPilha;
+    resultadoPtr->pontuacaoSomada += sistemaPtr->pontuacaoTotal;
+    resultadoPtr->pontuacaoSomaQuadrados += (double)sistemaPtr->pontuacaoTotal * sistemaPtr->pontuacaoTotal;
+    if (resultadoPtr->partidas == 1 || sistemaPtr->pontuacaoTotal > resultadoPtr->melhorPontuacao) {
+        resultadoPtr->melhorPontuacao = sistemaPtr->pontuacaoTotal;
+    }
+    if (resultadoPtr->partidas == 1 || sistemaPtr->pontuacaoTotal < resultadoPtr->piorPontuacao) {
+        resultadoPtr->piorPontuacao = sistemaPtr->pontuacaoTotal;
+    }
+    if (sistemaPtr->nivelAtual > resultadoPtr->maiorNivel) {
+        resultadoPtr->maiorNivel = sistemaPtr->nivelAtual;
+    }
+    if (sistemaPtr->melhorCombo > resultadoPtr->melhorCombo) {
+        resultadoPtr->melhorCombo = sistemaPtr->melhorCombo;
+    }
+    if (sessao.tabuleiro != NULL) {
+        resultadoPtr->linhasRemovidas += tabuleiro.linhasRemovidas;
+        resultadoPtr->derrotas += tabuleiro.derrotas;
+    }
+    if (configPtr->ranking != NULL) {
+        registrarRecorde(configPtr->ranking, sistemaPtr);
+    }
+    if (configPtr->regras != NULL) {
+        registrarPartidaBalanceamento(configPtr, indicePartida, &balanceamento, sistemaPtr, resultadoPtr);
+    }
+    if (sessao.conselheiro != NULL) {
+        liberarConselheiro(sessao.conselheiro);
+    }
+}
+
+/**
+ * @brief Acumula um resultado parcial em um resultado agregado
+ * @param destinoPtr Resultado agregado
+ * @param origemPtr Resultado parcial (por exemplo, de uma thread)
+ */
+void combinarResultadosSimulacao(ResultadoSimulacao* destinoPtr, const ResultadoSimulacao* origemPtr) {
+    if (origemPtr->partidas == 0) {
+        return;
+    }
+    if (destinoPtr->partidas == 0 || origemPtr->melhorPontuacao > destinoPtr->melhorPontuacao) {
+        destinoPtr->melhorPontuacao = origemPtr->melhorPontuacao;
+    }
+    if (destinoPtr->partidas == 0 || origemPtr->piorPontuacao < destinoPtr->piorPontuacao) {
+        destinoPtr->piorPontuacao = origemPtr->piorPontuacao;
+    }
+    if (origemPtr->maiorNivel > destinoPtr->maiorNivel) {
+        destinoPtr->maiorNivel = origemPtr->maiorNivel;
+    }
+    if (origemPtr->melhorCombo > destinoPtr->melhorCombo) {
+        destinoPtr->melhorCombo = origemPtr->melhorCombo;
+    }
+    destinoPtr->partidas += origemPtr->partidas;
+    destinoPtr->totalJogadas += origemPtr->totalJogadas;
+    destinoPtr->jogadasDaFila += origemPtr->jogadasDaFila;
+    destinoPtr->jogadasDaPilha += origemPtr->jogadasDaPilha;
+    destinoPtr->reservas += origemPtr->reservas;
+    destinoPtr->reabastecimentos += origemPtr->reabastecimentos;
+    destinoPtr->acoesInvalidas += origemPtr->acoesInvalidas;
+    destinoPtr->pontuacaoSomada += origemPtr->pontuacaoSomada;
+    destinoPtr->pontuacaoSomaQuadrados += origemPtr->pontuacaoSomaQuadrados;
+    destinoPtr->linhasRemovidas += origemPtr->linhasRemovidas;
+    destinoPtr->derrotas += origemPtr->derrotas;
+    for (int i = 0; i <= NIVEIS_BALANCEAMENTO; i++) {
+        destinoPtr->partidasPorNivel[i] += origemPtr->partidasPorNivel[i];
+    }
+    for (int i = 0; i < FAIXAS_COMBO_BALANCEAMENTO; i++) {
+        destinoPtr->jogadasPorCombo[i] += origemPtr->jogadasPorCombo[i];
+        destinoPtr->partidasPorMelhorCombo[i] += origemPtr->partidasPorMelhorCombo[i];
+    }
+    destinoPtr->divergencias += origemPtr->divergencias;
+}
+
+/**
+ * @brief Executa todas as partidas configuradas e mede o tempo gasto
+ * @param configPtr Configuração da simulação
+ * @param resultadoPtr Resultado agregado (inicializado por esta função)
+ * 
+ * Com mais de uma thread configurada, delega para executarSimulacaoParalela.
+ */
+void executarSimulacaoHeadless(const ConfiguracaoSimulacao* configPtr, ResultadoSimulacao* resultadoPtr) {
+    if (configPtr->threads > 1) {
+        executarSimulacaoParalela(configPtr, resultadoPtr);
+        return;
+    }
+    
+    ResultadoSimulacao vazio = {0};
+    *resultadoPtr = vazio;
+    
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;
+    
+    double inicio = obterTempoNanossegundos();
+    for (long long i = 0; i < configPtr->totalPartidas; i++) {
+        simularPartidaHeadless(configPtr, i, resultadoPtr);
+    }
+    resultadoPtr->segundos = (obterTempoNanossegundos() - inicio) / 1e9;
+    
+    modoSilencioso = silencioAnterior;
+}
+
+/// Quantidade de partidas agrupadas em cada tarefa do pool paralelo
+#define PARTIDAS_POR_BLOCO 64
+
+/**
+ * @brief Laço de uma thread do pool de simulação com roubo de trabalho
+ * @param argumento Ponteiro para TrabalhadorSimulacao
+ * @return Sempre NULL
+ * 
+ * A thread consome blocos do seu próprio deque; quando ele esvazia, percorre
+ * os deques das demais threads e rouba metade dos blocos restantes da
+ * primeira que ainda tiver trabalho. Termina quando nenhum deque tem blocos.
+ */
+void* executarTrabalhadorSimulacao(void* argumento) {
+    TrabalhadorSimulacao* trabalhadorPtr = (TrabalhadorSimulacao*)argumento;
+    PoolSimulacao* poolPtr = trabalhadorPtr->poolPtr;
+    const ConfiguracaoSimulacao* configPtr = poolPtr->configPtr;
+    FilaTarefas* propria = &poolPtr->tarefas[trabalhadorPtr->indice];
+    ResultadoSimulacao* resultadoPtr = &poolPtr->parciais[trabalhadorPtr->indice];
+    
+    for (;;) {
+        // Consumir um bloco do próprio deque (pelo fim)
+        long long bloco = -1;
+        pthread_mutex_lock(&propria->trava);
+        if (propria->inicio < propria->fim) {
+            bloco = --propria->fim;
+        }
+        pthread_mutex_unlock(&propria->trava);
+        
+        if (bloco < 0) {
+            // Deque vazio: roubar metade do trabalho de outra thread (pelo início)
+            int roubou = 0;
+            for (int deslocamento = 1; deslocamento < poolPtr->totalThreads && !roubou; deslocamento++) {
+                FilaTarefas* vitima = &poolPtr->tarefas[(trabalhadorPtr->indice + deslocamento) % poolPtr->totalThreads];
+                pthread_mutex_lock(&vitima->trava);
+                long long restantes = vitima->fim - vitima->inicio;
+                if (restantes > 0) {
+                    long long metade = (restantes + 1) / 2;
+                    long long inicioRoubado = vitima->inicio;
+                    vitima->inicio += metade;
+                    pthread_mutex_unlock(&vitima->trava);
+                    
+                    pthread_mutex_lock(&propria->trava);
+                    propria->inicio = inicioRoubado;
+                    propria->fim = inicioRoubado + metade;
+                    pthread_mutex_unlock(&propria->trava);
+                    roubou = 1;
+                } else {
+                    pthread_mutex_unlock(&vitima->trava);
+                }
+            }
+            if (!roubou) {
+                return NULL;
+            }
+            continue;
+        }
+        
+        long long primeira = bloco * PARTIDAS_POR_BLOCO;
+        long long ultima = primeira + PARTIDAS_POR_BLOCO;
+        if (ultima > configPtr->totalPartidas) {
+            ultima = configPtr->totalPartidas;
+        }
+        for (long long i = primeira; i < ultima; i++) {
+            simularPartidaHeadless(configPtr, i, resultadoPtr);
+        }
+    }
+}
+
+/**
+ * @brief Executa as partidas em paralelo com um pool de threads
+ * @param configPtr Configuração da simulação (threads > 1)
+ * @param resultadoPtr Resultado agregado (inicializado por esta função)
+ * 
+ * Cada partida é uma SessaoJogo própria, com IDs e gerador locais, e sua
+ * semente depende apenas do índice da partida: o resultado agregado é o
+ * mesmo da execução serial, independentemente do número de threads.
+ */
+void executarSimulacaoParalela(const ConfiguracaoSimulacao* configPtr, ResultadoSimulacao* resultadoPtr) {
+    int totalThreads = configPtr->threads;
+    long long totalBlocos = (configPtr->totalPartidas + PARTIDAS_POR_BLOCO - 1) / PARTIDAS_POR_BLOCO;
+    
+    PoolSimulacao pool;
+    pool.configPtr = configPtr;
+    pool.totalThreads = totalThreads;
+    pool.totalBlocos = totalBlocos;
+    pool.tarefas = calloc(totalThreads, sizeof(FilaTarefas));
+    pool.parciais = calloc(totalThreads, sizeof(ResultadoSimulacao));
+    pthread_t* threads = calloc(totalThreads, sizeof(pthread_t));
+    int* threadIniciada = calloc(totalThreads, sizeof(int));
+    TrabalhadorSimulacao* trabalhadores = calloc(totalThreads, sizeof(TrabalhadorSimulacao));
+    
+    if (pool.tarefas == NULL || pool.parciais == NULL || threads == NULL || threadIniciada == NULL ||
+        trabalhadores == NULL) {
+        printf("Memoria insuficiente para a simulacao paralela.\n");
+        exit(1);
+    }
+    
+    // Distribuição inicial: faixas contíguas de blocos por thread
+    for (int t = 0; t < totalThreads; t++) {
+        pthread_mutex_init(&pool.tarefas[t].trava, NULL);
+        pool.tarefas[t].inicio = totalBlocos * t / totalThreads;
+        pool.tarefas[t].fim = totalBlocos * (t + 1) / totalThreads;
+        trabalhadores[t].poolPtr = &pool;
+        trabalhadores[t].indice = t;
+    }
+    
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int t = 0; t < totalThreads; t++) {
+        threadIniciada[t] = (pthread_create(&threads[t], NULL, executarTrabalhadorSimulacao, &trabalhadores[t]) == 0);
+        if (!threadIniciada[t]) {
+            // Sem thread disponível: a chamadora executa a faixa (e rouba das demais)
+            executarTrabalhadorSimulacao(&trabalhadores[t]);
+        }
+    }
+    for (int t = 0; t < totalThreads; t++) {
+        if (threadIniciada[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    
+    // Consolidação dos resultados parciais de cada thread
+    ResultadoSimulacao vazio = {0};
+    *resultadoPtr = vazio;
+    for (int t = 0; t < totalThreads; t++) {
+        combinarResultadosSimulacao(resultadoPtr, &pool.parciais[t]);
+        pthread_mutex_destroy(&pool.tarefas[t].trava);
+    }
+    resultadoPtr->segundos = (obterTempoNanossegundos() - inicio) / 1e9;
+    
+    modoSilencioso = silencioAnterior;
+    free(trabalhadores);
+    free(threadIniciada);
+    free(threads);
+    free(pool.parciais);
+    free(pool.tarefas);
+}
+
+/**
+ * @brief Exibe o resumo final de uma simulação headless
+ * @param configPtr Configuração usada na simulação
+ * @param resultadoPtr Resultado agregado
+ */
+void exibirResumoSimulacao(const ConfiguracaoSimulacao* configPtr, const ResultadoSimulacao* resultadoPtr) {
+    static const char* nomesPoliticas[] = {"roteiro", "aleatoria", "gulosa", "conselheiro"};
+    double segundos = resultadoPtr->segundos > 0 ? resultadoPtr->segundos : 1e-9;
+    
+    printf("*** RESUMO DA SIMULACAO HEADLESS:\n");
+    printf("   * Politica: %s", nomesPoliticas[configPtr->politica]);
+    if (configPtr->politica == POLITICA_ROTEIRO) {
+        printf(" (\"%s\")", configPtr->roteiro);
+    } else if (configPtr->politica == POLITICA_CONSELHEIRO) {
+        printf(" (profundidade %d)", configPtr->profundidadeConselheiro);
+    }
+    printf("  |  Gerador: %s  |  Semente: %u  |  Threads: %d\n",
+           configPtr->modoGerador == GERADOR_SACO7 ? "saco7" : "uniforme", configPtr->semente, configPtr->threads);
+    printf("   * Partidas: %lld  |  Jogadas por partida: %d\n",
+           resultadoPtr->partidas, configPtr->jogadasPorPartida);
+    printf("   * Jogadas totais: %lld (fila: %lld, pilha: %lld)\n",
+           resultadoPtr->totalJogadas, resultadoPtr->jogadasDaFila, resultadoPtr->jogadasDaPilha);
+    printf("   * Reservas: %lld  |  Reabastecimentos: %lld  |  Acoes invalidas: %lld\n",
+           resultadoPtr->reservas, resultadoPtr->reabastecimentos, resultadoPtr->acoesInvalidas);
+    double media = resultadoPtr->partidas > 0 ? (double)resultadoPtr->pontuacaoSomada / resultadoPtr->partidas : 0.0;
+    double variancia = resultadoPtr->partidas > 0 ? resultadoPtr->pontuacaoSomaQuadrados / resultadoPtr->partidas - media * media : 0.0;
+    printf("   * Pontuacao media: %.1f (desvio %.1f)  |  Melhor: %d  |  Pior: %d\n",
+           media, variancia > 0 ? sqrt(variancia) : 0.0,
+           resultadoPtr->melhorPontuacao, resultadoPtr->piorPontuacao);
+    printf("   * Maior nivel: %d  |  Melhor combo: %d\n",
+           resultadoPtr->maiorNivel, resultadoPtr->melhorCombo);
+    if (configPtr->usarTabuleiro) {
+        printf("   * Linhas completadas: %lld (%.3f por peca)  |  Pocos esvaziados: %lld\n",
+               resultadoPtr->linhasRemovidas,
+               resultadoPtr->totalJogadas > 0 ? (double)resultadoPtr->linhasRemovidas / resultadoPtr->totalJogadas : 0.0,
+               resultadoPtr->derrotas);
+    }
+    printf("   * Tempo: %.3f s  |  Vazao: %.0f jogadas/s\n",
+           resultadoPtr->segundos, resultadoPtr->totalJogadas / segundos);
+}
+
+/**
+ * @brief Lê o valor inteiro de uma opção da linha de comando
+ * @param opcao Nome da opção (usado na mensagem de erro)
+ * @param valor Texto do valor
+ * @param minimo Menor valor aceito
+ * @param maximo Maior valor aceito
+ * @param destinoPtr Recebe o valor lido
+ * @return 1 se o texto inteiro é um número de minimo a maximo, 0 caso contrário
+ * 
+ * Ao contrário de atoi, recusa sobras ("80x"), texto sem dígitos ("abc",
+ * que atoi leria como 0) e valores fora do intervalo.
+ */
+static int lerInteiroLongoOpcao(const char* opcao, const char* valor, long long minimo, long long maximo, long long* destinoPtr) {
+    char* fim;
+    errno = 0;
+    long long numero = strtoll(valor, &fim, 10);
+    if (fim == valor || *fim != '\0' || errno == ERANGE || numero < minimo || numero > maximo) {
+        printf("Valor invalido para %s: %s (use um inteiro de %lld a %lld).\n", opcao, valor, minimo, maximo);
+        return 0;
+    }
+    *destinoPtr = numero;
+    return 1;
+}
+
+/**
+ * @brief Lê o valor de uma opção inteira com destino int (ver lerInteiroLongoOpcao)
+ */
+static int lerInteiroOpcao(const char* opcao, const char* valor, int minimo, int maximo, int* destinoPtr) {
+    long long numero;
+    if (!lerInteiroLongoOpcao(opcao, valor, minimo, maximo, &numero)) {
+        return 0;
+    }
+    *destinoPtr = (int)numero;
+    return 1;
+}
+
+/**
+ * @brief Lê o valor real de uma opção da linha de comando
+ * @param opcao Nome da opção (usado na mensagem de erro)
+ * @param valor Texto do valor
+ * @param minimo Menor valor aceito
+ * @param maximo Maior valor aceito
+ * @param destinoPtr Recebe o valor lido
+ * @return 1 se o texto inteiro é um número de minimo a maximo, 0 caso contrário
+ * 
+ * O texto inteiro precisa ser consumido: "0,25" não pode virar 0.
+ */
+static int lerRealOpcao(const char* opcao, const char* valor, double minimo, double maximo, double* destinoPtr) {
+    char* fim;
+    double numero = strtod(valor, &fim);
+    if (fim == valor || *fim != '\0' || !(numero >= minimo && numero <= maximo)) {
+        printf("Valor invalido para %s: %s (use um numero de %g a %g, com ponto decimal).\n", opcao, valor, minimo, maximo);
+        return 0;
+    }
+    *destinoPtr = numero;
+    return 1;
+}
+
+/**
+ * @brief Interpreta os argumentos de linha de comando do modo --simular
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos
+ * @param configPtr Configuração a ser preenchida
+ * @return 1 se os argumentos são válidos, 0 caso contrário
+ * 
+ * Opções aceitas (após --simular):
+ * - --partidas N       Quantidade de partidas (padrão 10000)
+ * - --jogadas N        Jogadas por partida (padrão 500)
+ * - --politica NOME    roteiro, aleatoria, gulosa ou conselheiro (padrão gulosa)
+ * - --profundidade N   Jogadas examinadas pela política conselheiro (padrão 3)
+ * - --orcamento-nos N  Estados por decisão do conselheiro; a busca fica na última
+ *                      profundidade concluída dentro dele (padrão 2000, 0 = sem limite)
+ * - --roteiro ACOES    Ações do menu, ex.: "1131", com ao menos uma ação além de 4; "-" lê da entrada padrão
+ * - --semente N        Semente do gerador (padrão 1)
+ * - --gerador NOME     uniforme ou saco7 (padrão uniforme)
+ * - --threads N        Threads de trabalho; 0 usa todos os núcleos (padrão 1)
+ * - --gravar ARQ       Acrescenta todas as ações ao log binário ARQ (exige 1 thread)
+ * - --ranking ARQ      Registra o resultado de cada partida no ranking ARQ
+ * - --tabuleiro sim    Coloca as peças em um poço 10x22, com bônus por linha completada (padrão nao)
+ * - --metricas ARQ     Exibe a instrumentação do motor e a grava em ARQ (formato Prometheus)
+ */
+int interpretarArgumentosSimulacao(int argc, char* argv[], ConfiguracaoSimulacao* configPtr) {
+    static char roteiroEntrada[4096];
+    
+    configPtr->totalPartidas = 10000;
+    configPtr->jogadasPorPartida = 500;
+    configPtr->politica = POLITICA_GULOSA;
+    configPtr->roteiro = "1";
+    configPtr->semente = 1;
+    configPtr->modoGerador = GERADOR_UNIFORME;
+    configPtr->threads = 1;
+    configPtr->arquivoLog = NULL;
+    configPtr->log = NULL;
+    configPtr->arquivoRanking = NULL;
+    configPtr->ranking = NULL;
+    configPtr->profundidadeConselheiro = 3;
+    configPtr->orcamentoNosConselheiro = ORCAMENTO_NOS_CONSELHEIRO_SIMULACAO;
+    configPtr->usarTabuleiro = 0;
+    configPtr->arquivoMetricas = NULL;
+    configPtr->regras = NULL;
+    configPtr->pontuacoesBalanceamento = NULL;
+    
+    for (int i = 2; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (valor == NULL) {
+            printf("Opcao %s sem valor.\n", opcao);
+            return 0;
+        }
+        
+        if (strcmp(opcao, "--threads") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 0, INT_MAX, &configPtr->threads)) {
+                return 0;
+            }
+            if (configPtr->threads == 0) {
+                configPtr->threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+            }
+        } else if (strcmp(opcao, "--gerador") == 0) {
+            if (strcmp(valor, "uniforme") == 0) {
+                configPtr->modoGerador = GERADOR_UNIFORME;
+            } else if (strcmp(valor, "saco7") == 0) {
+                configPtr->modoGerador = GERADOR_SACO7;
+            } else {
+                printf("Gerador desconhecido: %s\n", valor);
+                return 0;
+            }
+        } else if (strcmp(opcao, "--gravar") == 0) {
+            configPtr->arquivoLog = valor;
+        } else if (strcmp(opcao, "--ranking") == 0) {
+            configPtr->arquivoRanking = valor;
+        } else if (strcmp(opcao, "--metricas") == 0) {
+            configPtr->arquivoMetricas = valor;
+        } else if (strcmp(opcao, "--partidas") == 0) {
+            if (!lerInteiroLongoOpcao(opcao, valor, 1, LLONG_MAX, &configPtr->totalPartidas)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--jogadas") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->jogadasPorPartida)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--semente") == 0) {
+            long long semente;
+            if (!lerInteiroLongoOpcao(opcao, valor, 0, UINT_MAX, &semente)) {
+                return 0;
+            }
+            configPtr->semente = (unsigned int)semente;
+        } else if (strcmp(opcao, "--politica") == 0) {
+            if (strcmp(valor, "roteiro") == 0) {
+                configPtr->politica = POLITICA_ROTEIRO;
+            } else if (strcmp(valor, "aleatoria") == 0) {
+                configPtr->politica = POLITICA_ALEATORIA;
+            } else if (strcmp(valor, "gulosa") == 0) {
+                configPtr->politica = POLITICA_GULOSA;
+            } else if (strcmp(valor, "conselheiro") == 0) {
+                configPtr->politica = POLITICA_CONSELHEIRO;
+            } else {
+                printf("Politica desconhecida: %s\n", valor);
+                return 0;
+            }
+        } else if (strcmp(opcao, "--profundidade") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, PROFUNDIDADE_MAXIMA_CONSELHEIRO, &configPtr->profundidadeConselheiro)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--orcamento-nos") == 0) {
+            if (!lerInteiroLongoOpcao(opcao, valor, 0, LLONG_MAX, &configPtr->orcamentoNosConselheiro)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--tabuleiro") == 0) {
+            if (strcmp(valor, "sim") == 0) {
+                configPtr->usarTabuleiro = 1;
+            } else if (strcmp(valor, "nao") == 0) {
+                configPtr->usarTabuleiro = 0;
+            } else {
+                printf("Valor invalido para --tabuleiro: use sim ou nao.\n");
+                return 0;
+            }
+        } else if (strcmp(opcao, "--roteiro") == 0) {
+            if (strcmp(valor, "-") == 0) {
+                // Lê o roteiro da entrada padrão, descartando quebras de linha e espaços
+                int tamanho = 0;
+                int caractere;
+                while ((caractere = getchar()) != EOF && tamanho < (int)sizeof(roteiroEntrada) - 1) {
+                    if (caractere >= '0' && caractere <= '9') {
+                        roteiroEntrada[tamanho++] = (char)caractere;
+                    }
+                }
+                roteiroEntrada[tamanho] = '\0';
+                configPtr->roteiro = roteiroEntrada;
+            } else {
+                configPtr->roteiro = valor;
+            }
+            configPtr->politica = POLITICA_ROTEIRO;
+        } else {
+            printf("Opcao desconhecida: %s\n", opcao);
+            return 0;
+        }
+        i++;
+    }
+    
+    if (configPtr->threads < 1) {
+        printf("Quantidade de threads invalida.\n");
+        return 0;
+    }
+    
+    if (configPtr->arquivoLog != NULL && configPtr->threads != 1) {
+        printf("--gravar exige --threads 1 (o log preserva a ordem das partidas).\n");
+        return 0;
+    }
+    
+    if (configPtr->roteiro[0] == '\0') {
+        printf("Roteiro vazio.\n");
+        return 0;
+    }
+    int acoesQueAvancam = 0;
+    for (const char* c = configPtr->roteiro; *c; c++) {
+        if (*c < '1' || *c > '4') {
+            printf("Roteiro invalido: use apenas as acoes 1, 2, 3 e 4.\n");
+            return 0;
+        }
+        acoesQueAvancam += (*c != '4');
+    }
+    
+    // Gerar peças (4) sempre é aplicado e nunca joga; 2 ou 3 impossíveis caem
+    // em jogar da fila, então só um roteiro feito apenas de 4 não termina
+    if (acoesQueAvancam == 0) {
+        printf("Roteiro sem jogadas: inclua ao menos uma acao 1, 2 ou 3.\n");
+        return 0;
+    }
+    
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                         ANALISADOR DE BALANCEAMENTO
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Recalcula os pontos por tipo após mudança de nível
+ * @param regrasPtr Regras em avaliação
+ * @param estadoPtr Estado da partida
+ * 
+ * Mesma expressão de atualizarTabelaPontuacao, com a base das regras.
+ */
+static void atualizarPontosBalanceamento(const RegrasPontuacao* regrasPtr, EstadoBalanceamento* estadoPtr) {
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        estadoPtr->pontosPorTipo[i] = (int)(regrasPtr->pontosBase[i] * estadoPtr->multiplicador * estadoPtr->dificuldade);
+    }
+}
+
+/**
+ * @brief Completa as regras: tabela de limites de nível e indicação de padrão
+ * @param regrasPtr Regras com pontosBase, passoCombo, crescimentoNivel e limiteInicial definidos
+ * 
+ * Com as constantes do motor, copia limitesPontosNivel (os níveis seguintes
+ * ficam em INT_MAX, como em limitePontosDoNivel); caso contrário, calcula
+ * limiteInicial * crescimentoNivel^(nível - 1), saturado em INT_MAX.
+ */
+void prepararRegrasPontuacao(RegrasPontuacao* regrasPtr) {
+    regrasPtr->padrao = (regrasPtr->passoCombo == 0.2) && (regrasPtr->crescimentoNivel == 1.5) &&
+                        (regrasPtr->limiteInicial == limitesPontosNivel[0]);
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        regrasPtr->padrao &= (regrasPtr->pontosBase[i] == pontuacaoBasePorTipo[i]);
+    }
+    
+    for (int k = 0; k < NIVEIS_BALANCEAMENTO; k++) {
+        if (regrasPtr->padrao) {
+            regrasPtr->limites[k] = limitePontosDoNivel(k + 1);
+        } else {
+            double limite = regrasPtr->limiteInicial * pow(regrasPtr->crescimentoNivel, k);
+            regrasPtr->limites[k] = limite >= (double)INT_MAX ? INT_MAX : (int)limite;
+        }
+    }
+}
+
+/**
+ * @brief Prepara o estado de uma partida no início (nível 1, multiplicadores 1.0)
+ * @param regrasPtr Regras em avaliação
+ * @param estadoPtr Estado a ser inicializado
+ */
+void inicializarEstadoBalanceamento(const RegrasPontuacao* regrasPtr, EstadoBalanceamento* estadoPtr) {
+    estadoPtr->pontuacao = 0;
+    estadoPtr->nivel = 1;
+    estadoPtr->limite = regrasPtr->limites[0];
+    estadoPtr->multiplicador = 1.0;
+    estadoPtr->dificuldade = 1.0;
+    estadoPtr->ultimoTipo = 'X';
+    estadoPtr->sequencia = 0;
+    estadoPtr->melhorCombo = 0;
+    atualizarPontosBalanceamento(regrasPtr, estadoPtr);
+}
+
+/**
+ * @brief Pontua uma peça jogada segundo as regras em avaliação
+ * @param regrasPtr Regras em avaliação
+ * @param estadoPtr Estado da partida
+ * @param tipoPeca Tipo da peça jogada
+ * @return Combo vigente na jogada (0 nas duas primeiras peças de uma sequência)
+ * 
+ * Reproduz a ordem de processarJogadaExpert: pontos do tipo, multiplicador
+ * de combo, acumulação e, no máximo, uma subida de nível por jogada.
+ */
+int aplicarJogadaBalanceamento(const RegrasPontuacao* regrasPtr, EstadoBalanceamento* estadoPtr, char tipoPeca) {
+    int pontos = estadoPtr->pontosPorTipo[indiceTipoPeca(tipoPeca)];
+    
+    estadoPtr->sequencia = (estadoPtr->ultimoTipo == tipoPeca) ? estadoPtr->sequencia + 1 : 1;
+    estadoPtr->ultimoTipo = tipoPeca;
+    int combo = estadoPtr->sequencia > 2 ? estadoPtr->sequencia - 2 : 0;
+    if (combo > estadoPtr->melhorCombo) {
+        estadoPtr->melhorCombo = combo;
+    }
+    
+    // Com passo de combo e pontos altos em partidas longas o total passa de
+    // INT_MAX; a conversão é feita em double e a soma satura em vez de estourar
+    double ganho = pontos * (1.0 + combo * regrasPtr->passoCombo);
+    double restante = (double)(LLONG_MAX - estadoPtr->pontuacao);
+    estadoPtr->pontuacao = ganho >= restante ? LLONG_MAX : estadoPtr->pontuacao + (long long)ganho;
+    
+    if (estadoPtr->pontuacao >= estadoPtr->limite) {
+        estadoPtr->nivel++;
+        estadoPtr->limite = estadoPtr->nivel <= NIVEIS_BALANCEAMENTO ? regrasPtr->limites[estadoPtr->nivel - 1] : INT_MAX;
+        if (estadoPtr->dificuldade < 3.0) {
+            estadoPtr->dificuldade += 0.2;
+        }
+        if (estadoPtr->multiplicador < 10.0) {
+            estadoPtr->multiplicador += 0.5;
+        }
+        atualizarPontosBalanceamento(regrasPtr, estadoPtr);
+    }
+    return combo;
+}
+
+/**
+ * @brief Consolida o fim de uma partida nos histogramas do analisador
+ * @param configPtr Configuração da simulação (com regras)
+ * @param indicePartida Índice da partida
+ * @param estadoPtr Estado final segundo as regras em avaliação
+ * @param sistemaPtr Estado final do motor na mesma partida
+ * @param resultadoPtr Resultado parcial da thread
+ * 
+ * Com as regras padrão, confere pontuação, nível e melhor combo com os do
+ * motor: qualquer diferença é contada como divergência.
+ */
+void registrarPartidaBalanceamento(const ConfiguracaoSimulacao* configPtr, long long indicePartida,
+                                   const EstadoBalanceamento* estadoPtr, const SistemaExpert* sistemaPtr,
+                                   ResultadoSimulacao* resultadoPtr) {
+    int nivel = estadoPtr->nivel < NIVEIS_BALANCEAMENTO ? estadoPtr->nivel : NIVEIS_BALANCEAMENTO;
+    int combo = estadoPtr->melhorCombo < FAIXAS_COMBO_BALANCEAMENTO ? estadoPtr->melhorCombo : FAIXAS_COMBO_BALANCEAMENTO - 1;
+    
+    resultadoPtr->partidasPorNivel[nivel]++;
+    resultadoPtr->partidasPorMelhorCombo[combo]++;
+    if (configPtr->pontuacoesBalanceamento != NULL) {
+        configPtr->pontuacoesBalanceamento[indicePartida] = estadoPtr->pontuacao;
+    }
+    if (configPtr->regras->padrao &&
+        (estadoPtr->pontuacao != sistemaPtr->pontuacaoTotal || estadoPtr->nivel != sistemaPtr->nivelAtual ||
+         estadoPtr->melhorCombo != sistemaPtr->melhorCombo)) {
+        resultadoPtr->divergencias++;
+    }
+}
+
+/**
+ * @brief Intervalo de confiança de 95% de Wilson para uma proporção
+ * @param sucessos Partidas em que o evento ocorreu
+ * @param total Partidas observadas
+ * @param inferiorPtr Limite inferior (0 a 1)
+ * @param superiorPtr Limite superior (0 a 1)
+ * 
+ * Ao contrário do intervalo normal, continua informativo para proporções
+ * próximas de 0 ou de 1, comuns nos níveis mais altos.
+ */
+void intervaloWilson(long long sucessos, long long total, double* inferiorPtr, double* superiorPtr) {
+    const double z = 1.96;
+    
+    if (total <= 0) {
+        *inferiorPtr = 0.0;
+        *superiorPtr = 1.0;
+        return;
+    }
+    double n = (double)total;
+    double p = sucessos / n;
+    double denominador = 1.0 + z * z / n;
+    double centro = (p + z * z / (2.0 * n)) / denominador;
+    double margem = z * sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominador;
+    *inferiorPtr = centro - margem > 0.0 ? centro - margem : 0.0;
+    *superiorPtr = centro + margem < 1.0 ? centro + margem : 1.0;
+}
+
+/**
+ * @brief Compara duas pontuações para ordenação com qsort
+ */
+static int compararPontuacoes(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Exibe as distribuições produzidas pelo analisador de balanceamento
+ * @param configPtr Configuração usada (as pontuações por partida são ordenadas aqui)
+ * @param regrasPtr Regras avaliadas
+ * @param resultadoPtr Resultado agregado da simulação
+ * 
+ * Mostra a pontuação final (média e mediana com IC de 95%, percentis e
+ * histograma), a probabilidade de alcançar cada nível e a frequência de
+ * cada combo, por jogada e como melhor combo da partida.
+ */
+void exibirAnaliseBalanceamento(const ConfiguracaoSimulacao* configPtr, const RegrasPontuacao* regrasPtr,
+                                const ResultadoSimulacao* resultadoPtr) {
+    static const char* nomesPoliticas[] = {"roteiro", "aleatoria", "gulosa", "conselheiro"};
+    static const double percentis[] = {0.01, 0.05, 0.25, 0.75, 0.95, 0.99};
+    long long partidas = resultadoPtr->partidas;
+    long long* pontuacoes = configPtr->pontuacoesBalanceamento;
+    double segundos = resultadoPtr->segundos > 0 ? resultadoPtr->segundos : 1e-9;
+    
+    printf("*** ANALISE DE BALANCEAMENTO (Monte Carlo):\n");
+    printf("   * Regras:");
+    for (int i = 0; i < PECA_DESCONHECIDA; i++) {
+        printf(" %c=%d", tiposPecas[i], regrasPtr->pontosBase[i]);
+    }
+    printf("  |  Combo: +%.2fx por repeticao  |  Niveis: %d x %.2f^(n-1)%s\n",
+           regrasPtr->passoCombo, regrasPtr->limiteInicial, regrasPtr->crescimentoNivel,
+           regrasPtr->padrao ? "  (regras do motor)" : "");
+    printf("   * Politica: %s", nomesPoliticas[configPtr->politica]);
+    if (configPtr->politica == POLITICA_ROTEIRO) {
+        printf(" (\"%s\")", configPtr->roteiro);
+    } else if (configPtr->politica == POLITICA_CONSELHEIRO) {
+        printf(" (profundidade %d)", configPtr->profundidadeConselheiro);
+    }
+    printf("  |  Gerador: %s  |  Semente: %u  |  Threads: %d\n",
+           configPtr->modoGerador == GERADOR_SACO7 ? "saco7" : "uniforme", configPtr->semente, configPtr->threads);
+    printf("   * Partidas: %lld x %d jogadas  |  Tempo: %.3f s  |  Vazao: %.0f jogadas/s\n",
+           partidas, configPtr->jogadasPorPartida, resultadoPtr->segundos, resultadoPtr->totalJogadas / segundos);
+    if (regrasPtr->padrao) {
+        printf("   * Conferencia com o motor: %lld divergencias em %lld partidas\n", resultadoPtr->divergencias, partidas);
+    }
+    if (partidas == 0) {
+        return;
+    }
+    
+    // Pontuação final: média (IC normal), mediana (IC por estatística de ordem) e percentis
+    qsort(pontuacoes, (size_t)partidas, sizeof(long long), compararPontuacoes);
+    double soma = 0.0;
+    for (long long i = 0; i < partidas; i++) {
+        soma += (double)pontuacoes[i];
+    }
+    double media = soma / partidas;
+    double somaDesvios = 0.0;
+    for (long long i = 0; i < partidas; i++) {
+        somaDesvios += ((double)pontuacoes[i] - media) * ((double)pontuacoes[i] - media);
+    }
+    double desvio = partidas > 1 ? sqrt(somaDesvios / (partidas - 1)) : 0.0;
+    double margemMedia = 1.96 * desvio / sqrt((double)partidas);
+    double raio = 1.96 * sqrt((double)partidas) / 2.0;
+    long long ordemInferior = (long long)floor(partidas / 2.0 - raio);
+    long long ordemSuperior = (long long)ceil(partidas / 2.0 + raio);
+    ordemInferior = ordemInferior < 0 ? 0 : ordemInferior;
+    ordemSuperior = ordemSuperior > partidas - 1 ? partidas - 1 : ordemSuperior;
+    
+    printf("\n   Pontuacao final (IC de 95%%):\n");
+    printf("   * Media: %.1f [%.1f, %.1f]  |  Desvio: %.1f\n", media, media - margemMedia, media + margemMedia, desvio);
+    printf("   * Mediana: %lld [%lld, %lld]  |  Minima: %lld  |  Maxima: %lld\n",
+           pontuacoes[partidas / 2], pontuacoes[ordemInferior], pontuacoes[ordemSuperior],
+           pontuacoes[0], pontuacoes[partidas - 1]);
+    printf("   * Percentis:");
+    for (int i = 0; i < (int)(sizeof(percentis) / sizeof(percentis[0])); i++) {
+        printf("  p%.0f %lld", percentis[i] * 100, pontuacoes[(long long)(percentis[i] * (partidas - 1))]);
+    }
+    printf("\n");
+    
+    // Histograma em faixas de mesma largura entre a menor e a maior pontuação
+    long long largura = (pontuacoes[partidas - 1] - pontuacoes[0]) / FAIXAS_PONTUACAO_BALANCEAMENTO + 1;
+    long long contagens[FAIXAS_PONTUACAO_BALANCEAMENTO] = {0};
+    long long maiorContagem = 0;
+    for (long long i = 0; i < partidas; i++) {
+        contagens[(pontuacoes[i] - pontuacoes[0]) / largura]++;
+    }
+    for (int f = 0; f < FAIXAS_PONTUACAO_BALANCEAMENTO; f++) {
+        maiorContagem = contagens[f] > maiorContagem ? contagens[f] : maiorContagem;
+    }
+    for (int f = 0; f < FAIXAS_PONTUACAO_BALANCEAMENTO; f++) {
+        long long inicioFaixa = pontuacoes[0] + f * largura;
+        int barra = (int)(40 * contagens[f] / maiorContagem);
+        printf("     [%9lld, %9lld) %9lld %6.2f%% ", inicioFaixa, inicioFaixa + largura,
+               contagens[f], 100.0 * contagens[f] / partidas);
+        for (int b = 0; b < barra; b++) {
+            putchar('#');
+        }
+        printf("\n");
+    }
+    
+    // Probabilidade de terminar a partida no nível n ou acima (os níveis que
+    // todas as partidas alcançaram são resumidos em uma linha)
+    int menorNivel = 0;
+    int maiorNivel = 1;
+    for (int n = 1; n <= NIVEIS_BALANCEAMENTO; n++) {
+        if (resultadoPtr->partidasPorNivel[n] > 0) {
+            menorNivel = menorNivel == 0 ? n : menorNivel;
+            maiorNivel = n;
+        }
+    }
+    printf("\n   Probabilidade de alcancar o nivel (IC de 95%% de Wilson):\n");
+    if (menorNivel > 2) {
+        printf("     Niveis 1 a %d: alcancados em todas as partidas\n", menorNivel - 1);
+    }
+    long long alcancaram = partidas;
+    for (int n = menorNivel > 2 ? menorNivel : 1; n <= maiorNivel; n++) {
+        double inferior, superior;
+        intervaloWilson(alcancaram, partidas, &inferior, &superior);
+        printf("     Nivel %2d%s %7.3f%% [%7.3f%%, %7.3f%%]  (%lld terminaram no nivel)\n",
+               n, n == NIVEIS_BALANCEAMENTO ? "+:" : ": ", 100.0 * alcancaram / partidas,
+               100.0 * inferior, 100.0 * superior, resultadoPtr->partidasPorNivel[n]);
+        alcancaram -= resultadoPtr->partidasPorNivel[n];
+    }
+    
+    // Combos: frequência por jogada e probabilidade de a partida alcançar cada combo
+    int maiorCombo = 0;
+    for (int c = 0; c < FAIXAS_COMBO_BALANCEAMENTO; c++) {
+        if (resultadoPtr->jogadasPorCombo[c] > 0) {
+            maiorCombo = c;
+        }
+    }
+    printf("\n   Combos (jogadas com o combo; partidas que alcancaram o combo, IC de 95%% de Wilson):\n");
+    long long partidasComCombo = partidas;
+    for (int c = 0; c <= maiorCombo; c++) {
+        double inferior, superior;
+        intervaloWilson(partidasComCombo, partidas, &inferior, &superior);
+        printf("     Combo %2d%s %12lld jogadas (%7.3f%%)  |  %7.3f%% das partidas [%7.3f%%, %7.3f%%]\n",
+               c, c == FAIXAS_COMBO_BALANCEAMENTO - 1 ? "+:" : ": ", resultadoPtr->jogadasPorCombo[c],
+               resultadoPtr->totalJogadas > 0 ? 100.0 * resultadoPtr->jogadasPorCombo[c] / resultadoPtr->totalJogadas : 0.0,
+               100.0 * partidasComCombo / partidas, 100.0 * inferior, 100.0 * superior);
+        partidasComCombo -= resultadoPtr->partidasPorMelhorCombo[c];
+    }
+}
+
+/**
+ * @brief Lê uma lista de pontuações base no formato "I=120,T=95"
+ * @param lista Lista de pares tipo=pontos separados por vírgula
+ * @param regrasPtr Regras a atualizar (tipos ausentes mantêm o valor atual)
+ * @return 1 se a lista é válida, 0 caso contrário
+ */
+int interpretarListaPontos(const char* lista, RegrasPontuacao* regrasPtr) {
+    const char* cursor = lista;
+    
+    while (*cursor != '\0') {
+        TipoPeca tipo = indiceTipoPeca(cursor[0]);
+        char* fim = NULL;
+        long pontos = (tipo != PECA_DESCONHECIDA && cursor[1] == '=') ? strtol(cursor + 2, &fim, 10) : -1;
+        
+        if (fim == NULL || fim == cursor + 2 || pontos < 0 || pontos > 10000 || (*fim != ',' && *fim != '\0')) {
+            printf("Lista de pontos invalida: %s (use, por exemplo, I=120,T=95, de 0 a 10000).\n", lista);
+            return 0;
+        }
+        regrasPtr->pontosBase[tipo] = (int)pontos;
+        cursor = (*fim == ',') ? fim + 1 : fim;
+    }
+    return 1;
+}
+
+/**
+ * @brief Interpreta os argumentos de linha de comando do modo --balanceamento
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos
+ * @param configPtr Configuração da simulação a ser preenchida (com regras)
+ * @param regrasPtr Regras a serem preenchidas
+ * @return 1 se os argumentos são válidos, 0 caso contrário
+ * 
+ * Aceita todas as opções de --simular (com padrão de 100000 partidas em
+ * todos os núcleos), exceto --tabuleiro, e as constantes em avaliação:
+ * - --pontos LISTA       Pontuação base por tipo, ex.: "I=120,T=95" (padrão 100/80/90/85/85/75/75)
+ * - --passo-combo X      Acréscimo ao combo por repetição (padrão 0.2)
+ * - --crescimento X      Razão entre limites de níveis consecutivos (padrão 1.5)
+ * - --limite-inicial N   Pontos para concluir o nível 1 (padrão 1000)
+ * 
+ * As políticas decidem como no jogo: só a gulosa, a aleatória e o roteiro
+ * são indiferentes às constantes; o conselheiro avalia as jogadas com as
+ * regras do motor, mesmo quando outras estão em avaliação.
+ */
+int interpretarArgumentosBalanceamento(int argc, char* argv[], ConfiguracaoSimulacao* configPtr, RegrasPontuacao* regrasPtr) {
+    static char partidasPadrao[24];
+    char* argumentosSimulacao[argc + 4];
+    int totalArgumentos = 0;
+    
+    for (int i = 0; i < TOTAL_TIPOS_PECA; i++) {
+        regrasPtr->pontosBase[i] = pontuacaoBasePorTipo[i];
+    }
+    regrasPtr->passoCombo = 0.2;
+    regrasPtr->crescimentoNivel = 1.5;
+    regrasPtr->limiteInicial = limitesPontosNivel[0];
+    
+    // Padrões próprios do analisador, sobrepostos pelas opções da linha de comando
+    snprintf(partidasPadrao, sizeof(partidasPadrao), "%d", PARTIDAS_BALANCEAMENTO_PADRAO);
+    argumentosSimulacao[totalArgumentos++] = argv[0];
+    argumentosSimulacao[totalArgumentos++] = argv[1];
+    argumentosSimulacao[totalArgumentos++] = "--partidas";
+    argumentosSimulacao[totalArgumentos++] = partidasPadrao;
+    argumentosSimulacao[totalArgumentos++] = "--threads";
+    argumentosSimulacao[totalArgumentos++] = "0";
+    
+    for (int i = 2; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (valor == NULL) {
+            printf("Opcao %s sem valor.\n", opcao);
+            return 0;
+        }
+        
+        if (strcmp(opcao, "--pontos") == 0) {
+            if (!interpretarListaPontos(valor, regrasPtr)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--passo-combo") == 0) {
+            if (!lerRealOpcao(opcao, valor, 0.0, 10.0, &regrasPtr->passoCombo)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--crescimento") == 0) {
+            if (!lerRealOpcao(opcao, valor, 1.0, 100.0, &regrasPtr->crescimentoNivel)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--limite-inicial") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &regrasPtr->limiteInicial)) {
+                return 0;
+            }
+        } else {
+            // Opções da simulação seguem para interpretarArgumentosSimulacao
+            argumentosSimulacao[totalArgumentos++] = argv[i];
+            argumentosSimulacao[totalArgumentos++] = argv[i + 1];
+        }
+        i++;
+    }
+    
+    if (!interpretarArgumentosSimulacao(totalArgumentos, argumentosSimulacao, configPtr)) {
+        return 0;
+    }
+    
+    if (configPtr->usarTabuleiro) {
+        printf("--tabuleiro nao e aceito no balanceamento (as linhas pontuam fora das regras avaliadas).\n");
+        return 0;
+    }
+    
+    if (!(regrasPtr->crescimentoNivel > 1.0 && regrasPtr->crescimentoNivel <= 100.0)) {
+        printf("Crescimento de nivel invalido: use um valor maior que 1 e ate 100.\n");
+        return 0;
+    }
+    
+    prepararRegrasPontuacao(regrasPtr);
+    configPtr->regras = regrasPtr;
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                              MICROBENCHMARKS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// Acumulador volátil que impede o compilador de descartar o trabalho medido
+volatile long long sumidouroBenchmark = 0;
+
+/**
+ * @brief Lê um relógio monotônico de alta resolução
+ * @return Instante atual em nanossegundos
+ */
+double obterTempoNanossegundos() {
+#ifdef _WIN32
+    return (double)clock() * (1e9 / CLOCKS_PER_SEC);
+#else
+    struct timespec instante;
+    clock_gettime(CLOCK_MONOTONIC, &instante);
+    return instante.tv_sec * 1e9 + instante.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Preenche uma sequência de tipos de peça segundo uma distribuição
+ * @param geradorPtr Gerador usado nos sorteios
+ * @param distribuicao Distribuição desejada
+ * @param tipos Vetor de saída
+ * @param quantidade Tamanho do vetor
+ */
+void gerarDistribuicaoPecas(GeradorPecas* geradorPtr, DistribuicaoPecas distribuicao, char* tipos, int quantidade) {
+    for (int i = 0; i < quantidade; i++) {
+        switch (distribuicao) {
+            case DISTRIBUICAO_UNICA:
+                tipos[i] = 'I';
+                break;
+            case DISTRIBUICAO_ALTERNADA:
+                tipos[i] = (i % 2 == 0) ? 'I' : 'O';
+                break;
+            case DISTRIBUICAO_ENVIESADA:
+                tipos[i] = sortearLimitado(geradorPtr, 2) == 0 ? 'I' : tiposPecas[1 + sortearLimitado(geradorPtr, 6)];
+                break;
+            case DISTRIBUICAO_UNIFORME:
+            default:
+                tipos[i] = tiposPecas[sortearLimitado(geradorPtr, 7)];
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Mede pares inserirPecaNaFila + jogarPecaDaFila
+ */
+double medirFilaCircular(const char* tipos, int quantidade) {
+    FilaCircular fila;
+    inicializarFila(&fila);
+    inserirPecaNaFila(&fila, criarPeca('I', 0));
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        inserirPecaNaFila(&fila, criarPeca(tipos[i], i));
+        soma += jogarPecaDaFila(&fila).id;
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede inserirPecasNaFila + jogarPecasDaFila com lotes de fila cheia
+ */
+double medirFilaCircularLote(const char* tipos, int quantidade) {
+    FilaCircular fila;
+    Peca lote[CAPACIDADE_FILA];
+    Peca saida[CAPACIDADE_FILA];
+    inicializarFila(&fila);
+    long long soma = 0;
+    
+    // Desloca a frente em uma posição para que os lotes cruzem o fim do array
+    inserirPecaNaFila(&fila, criarPeca('I', 0));
+    jogarPecaDaFila(&fila);
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i + CAPACIDADE_FILA <= quantidade; i += CAPACIDADE_FILA) {
+        for (int j = 0; j < CAPACIDADE_FILA; j++) {
+            lote[j] = criarPeca(tipos[i + j], i + j);
+        }
+        inserirPecasNaFila(&fila, lote, CAPACIDADE_FILA);
+        jogarPecasDaFila(&fila, saida, CAPACIDADE_FILA);
+        soma += saida[0].id;
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede pares reservarPeca + jogarPecaDaPilha
+ */
+double medirPilhaReserva(const char* tipos, int quantidade) {
+    PilhaReserva pilha;
+    inicializarPilha(&pilha);
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        reservarPeca(&pilha, criarPeca(tipos[i], i));
+        soma += jogarPecaDaPilha(&pilha).id;
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede chamadas isoladas de calcularPontuacao
+ */
+double medirCalculoPontuacao(const char* tipos, int quantidade) {
+    SistemaExpert sistema;
+    inicializarSistemaExpert(&sistema);
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        soma += calcularPontuacao(tipos[i], &sistema);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede chamadas isoladas de nivelParaPontuacao
+ * 
+ * As pontuações cobrem todas as faixas de nível: um valor pseudoaleatório
+ * deslocado por uma quantidade que depende do tipo sorteado.
+ */
+double medirNivelParaPontuacao(const char* tipos, int quantidade) {
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        uint32_t bruto = (uint32_t)(i + 1) * 2654435761u;
+        soma += nivelParaPontuacao((int)(bruto >> (1 + ((unsigned char)tipos[i] & 15))));
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede quedas e fixações diretas no poço (colunas e rotações cíclicas)
+ */
+double medirTabuleiroSoltarFixar(const char* tipos, int quantidade) {
+    TabuleiroJogo tabuleiro;
+    inicializarTabuleiro(&tabuleiro);
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        int tipo = indiceTipoPeca(tipos[i]);
+        int rotacao = i % rotacoesDistintasPeca[tipo];
+        int coluna = (i * 7) % (LARGURA_TABULEIRO - larguraPecaTabuleiro[tipo][rotacao] + 1);
+        int linha = soltarPecaTabuleiro(&tabuleiro, tipo, rotacao, coluna);
+        if (linha < 0) {
+            inicializarTabuleiro(&tabuleiro);
+            linha = 0;
+        }
+        soma += fixarPecaTabuleiro(&tabuleiro, tipo, rotacao, coluna, linha);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede posicionarPecaTabuleiro (busca da melhor colocação + fixação)
+ */
+double medirTabuleiroColocacao(const char* tipos, int quantidade) {
+    TabuleiroJogo tabuleiro;
+    inicializarTabuleiro(&tabuleiro);
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        soma += posicionarPecaTabuleiro(&tabuleiro, tipos[i]);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma + tabuleiro.derrotas;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede posicionarPecaTabuleiro com o cache de colocações ligado
+ * 
+ * A alocação e a limpeza do cache ficam fora do tempo medido.
+ */
+double medirTabuleiroColocacaoCache(const char* tipos, int quantidade) {
+    CacheColocacoes cache;
+    if (!inicializarCacheColocacoes(&cache, BITS_CACHE_COLOCACOES)) {
+        return 0.0;
+    }
+    TabuleiroJogo tabuleiro;
+    inicializarTabuleiro(&tabuleiro);
+    tabuleiro.cache = &cache;
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        soma += posicionarPecaTabuleiro(&tabuleiro, tipos[i]);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma + cache.acertos;
+    liberarCacheColocacoes(&cache);
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede chamadas isoladas de detectarCombo
+ */
+double medirDeteccaoCombo(const char* tipos, int quantidade) {
+    SistemaExpert sistema;
+    inicializarSistemaExpert(&sistema);
+    double soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        soma += detectarCombo(&sistema, tipos[i]);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += (long long)soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede o caminho completo de processarJogadaExpert
+ * 
+ * O sistema é restaurado a cada 256 jogadas para que a pontuação não
+ * transborde em distribuições de combo infinito (como a "unica").
+ */
+double medirJogadaExpert(const char* tipos, int quantidade) {
+    SistemaExpert inicial;
+    SistemaExpert sistema;
+    inicializarSistemaExpert(&inicial);
+    sistema = inicial;
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        processarJogadaExpert(criarPeca(tipos[i], i), i & 1, &sistema);
+        if ((i & 255) == 255) {
+            soma += sistema.pontuacaoTotal;
+            sistema = inicial;
+        }
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma + sistema.pontuacaoTotal;
+    return fim - inicio;
+}
+
+/// Sessões pontuadas por chamada nas medições do lote
+#define SESSOES_BENCHMARK_LOTE 64
+
+/**
+ * @brief Mede processarJogadasLote com SESSOES_BENCHMARK_LOTE sessões por chamada
+ * 
+ * Cada chamada consome SESSOES_BENCHMARK_LOTE peças consecutivas da
+ * distribuição (uma por sessão). O tempo é por jogada, comparável a
+ * processar_jogada_expert. As sessões são restauradas a cada 256 jogadas,
+ * como em medirJogadaExpert.
+ */
+double medirJogadaExpertLote(const char* tipos, int quantidade) {
+    LoteSistemasExpert lote;
+    SistemaExpert inicial;
+    Peca pecas[SESSOES_BENCHMARK_LOTE];
+    int origens[SESSOES_BENCHMARK_LOTE];
+    
+    if (!inicializarLoteSistemasExpert(&lote, SESSOES_BENCHMARK_LOTE)) {
+        printf("Memoria insuficiente para o benchmark.\n");
+        exit(1);
+    }
+    inicializarSistemaExpert(&inicial);
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int passo = 0; (passo + 1) * SESSOES_BENCHMARK_LOTE <= quantidade; passo++) {
+        for (int s = 0; s < SESSOES_BENCHMARK_LOTE; s++) {
+            pecas[s] = criarPeca(tipos[passo * SESSOES_BENCHMARK_LOTE + s], s);
+            origens[s] = (passo + s) & 1;
+        }
+        processarJogadasLote(&lote, pecas, origens);
+        if ((passo & 255) == 255) {
+            for (int s = 0; s < SESSOES_BENCHMARK_LOTE; s++) {
+                soma += lote.pontuacaoTotal[s];
+                carregarSistemaNoLote(&lote, s, &inicial);
+            }
+        }
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma + lote.pontuacaoTotal[0];
+    liberarLoteSistemasExpert(&lote);
+    return fim - inicio;
+}
+
+/**
+ * @brief Compara dois sistemas Expert campo a campo
+ * @return 1 se todos os campos são iguais, 0 caso contrário
+ */
+static int sistemasExpertIguais(const SistemaExpert* a, const SistemaExpert* b) {
+    if (memcmp(a->pontosPorTipo, b->pontosPorTipo, sizeof(a->pontosPorTipo)) != 0 ||
+        memcmp(a->contagemPorTipo, b->contagemPorTipo, sizeof(a->contagemPorTipo)) != 0) {
+        return 0;
+    }
+    return a->pontuacaoTotal == b->pontuacaoTotal && a->pontuacaoNivel == b->pontuacaoNivel &&
+           a->multiplicadorAtual == b->multiplicadorAtual && a->pontosUltimaJogada == b->pontosUltimaJogada &&
+           a->comboAtual == b->comboAtual && a->melhorCombo == b->melhorCombo &&
+           a->totalCombos == b->totalCombos && a->ultimoTipoJogado == b->ultimoTipoJogado &&
+           a->sequenciaTipoAtual == b->sequenciaTipoAtual && a->nivelAtual == b->nivelAtual &&
+           a->pontosParaProximoNivel == b->pontosParaProximoNivel && a->limitePontosNivel == b->limitePontosNivel &&
+           a->fatorDificuldade == b->fatorDificuldade && a->totalJogadas == b->totalJogadas &&
+           a->jogadasDaFila == b->jogadasDaFila && a->jogadasDaPilha == b->jogadasDaPilha &&
+           a->pecasReservadas == b->pecasReservadas && a->eficienciaReserva == b->eficienciaReserva &&
+           a->tipoMaisJogado == b->tipoMaisJogado && a->conquistasDesbloqueadas == b->conquistasDesbloqueadas &&
+           a->marcosAlcancados == b->marcosAlcancados && a->recordePessoal == b->recordePessoal;
+}
+
+/**
+ * @brief Confere que o caminho em lote reproduz exatamente o caminho escalar
+ * @param tipos Sequência de tipos da distribuição
+ * @param quantidade Tamanho da sequência
+ * @return Número de sessões divergentes (0 = equivalentes)
+ * 
+ * Usa uma quantidade de sessões que não é múltipla da largura SIMD, para
+ * exercitar também a cauda escalar dos kernels vetoriais. Sem reinício,
+ * as sessões avançam por vários níveis e conquistas.
+ */
+int verificarPontuacaoLote(const char* tipos, int quantidade) {
+    enum { SESSOES_VERIFICACAO = 37 };
+    LoteSistemasExpert lote;
+    SistemaExpert sistemas[SESSOES_VERIFICACAO];
+    Peca pecas[SESSOES_VERIFICACAO];
+    int origens[SESSOES_VERIFICACAO];
+    
+    if (!inicializarLoteSistemasExpert(&lote, SESSOES_VERIFICACAO)) {
+        return SESSOES_VERIFICACAO;
+    }
+    for (int s = 0; s < SESSOES_VERIFICACAO; s++) {
+        inicializarSistemaExpert(&sistemas[s]);
+    }
+    
+    int passos = quantidade / SESSOES_VERIFICACAO;
+    if (passos > 2000) {
+        passos = 2000;  // Limita a pontuação para não transbordar int
+    }
+    for (int passo = 0; passo < passos; passo++) {
+        for (int s = 0; s < SESSOES_VERIFICACAO; s++) {
+            pecas[s] = criarPeca(tipos[passo * SESSOES_VERIFICACAO + s], s);
+            origens[s] = (passo * 7 + s) % 3 == 0;
+            processarJogadaExpert(pecas[s], origens[s], &sistemas[s]);
+        }
+        processarJogadasLote(&lote, pecas, origens);
+    }
+    
+    int divergentes = 0;
+    for (int s = 0; s < SESSOES_VERIFICACAO; s++) {
+        SistemaExpert extraido;
+        extrairSistemaDoLote(&lote, s, &extraido);
+        divergentes += !sistemasExpertIguais(&extraido, &sistemas[s]);
+    }
+    liberarLoteSistemasExpert(&lote);
+    return divergentes;
+}
+
+/**
+ * @brief Mede a geração de tipos em lote com preencherTiposPecas
+ * 
+ * A distribuição recebida não se aplica; o gerador é sempre uniforme e
+ * preenche lotes de CAPACIDADE_FILA tipos, como em gerarPecasAleatorias.
+ */
+double medirGeradorPecas(const char* tipos, int quantidade) {
+    GeradorPecas gerador;
+    inicializarGeradorPecas(&gerador, (uint64_t)tipos[0], GERADOR_UNIFORME);
+    char lote[CAPACIDADE_FILA];
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i += CAPACIDADE_FILA) {
+        preencherTiposPecas(&gerador, lote, CAPACIDADE_FILA);
+        soma += lote[0] + lote[CAPACIDADE_FILA - 1];
+    }
+    double fim = obterTempoNanossegundos();
+    
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/// Sessões vivas ao mesmo tempo nas medições de alocação de sessões
+#define SESSOES_BENCHMARK_ALOCACAO 256
+
+/**
+ * @brief Mede a rotatividade de sessões com malloc/free
+ * 
+ * Mantém SESSOES_BENCHMARK_ALOCACAO sessões vivas: a cada operação a
+ * sessão mais antiga é liberada, uma nova é alocada e inicializada e
+ * joga uma peça da distribuição, como um servidor sob entrada e saída
+ * constante de jogadores.
+ */
+double medirSessoesMalloc(const char* tipos, int quantidade) {
+    SessaoJogo* sessoes[SESSOES_BENCHMARK_ALOCACAO] = { NULL };
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        SessaoJogo** sessaoPtr = &sessoes[i & (SESSOES_BENCHMARK_ALOCACAO - 1)];
+        if (*sessaoPtr != NULL) {
+            soma += (*sessaoPtr)->sistema.pontuacaoTotal;
+            free(*sessaoPtr);
+        }
+        *sessaoPtr = malloc(sizeof(SessaoJogo));
+        if (*sessaoPtr == NULL) {
+            printf("Memoria insuficiente para o benchmark.\n");
+            exit(1);
+        }
+        inicializarSessaoJogo(*sessaoPtr, (uint64_t)i, GERADOR_UNIFORME);
+        processarJogadaExpert(criarPeca(tipos[i], i), i & 1, &(*sessaoPtr)->sistema);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    for (int s = 0; s < SESSOES_BENCHMARK_ALOCACAO; s++) {
+        free(sessoes[s]);
+    }
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede a mesma rotatividade de medirSessoesMalloc com o pool de sessões
+ */
+double medirSessoesPool(const char* tipos, int quantidade) {
+    SessaoJogo* sessoes[SESSOES_BENCHMARK_ALOCACAO] = { NULL };
+    PoolSessoes pool;
+    inicializarPoolSessoes(&pool, sizeof(SessaoJogo));
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        SessaoJogo** sessaoPtr = &sessoes[i & (SESSOES_BENCHMARK_ALOCACAO - 1)];
+        if (*sessaoPtr != NULL) {
+            soma += (*sessaoPtr)->sistema.pontuacaoTotal;
+            liberarSessaoPool(&pool, *sessaoPtr);
+        }
+        if (alocarSessoesPool(&pool, sessaoPtr, 1, 0, i, GERADOR_UNIFORME) != 1) {
+            printf("Memoria insuficiente para o benchmark.\n");
+            exit(1);
+        }
+        processarJogadaExpert(criarPeca(tipos[i], i), i & 1, &(*sessaoPtr)->sistema);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    liberarPoolSessoes(&pool);
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/// Sessões por chamada de alocarSessoesPool em medirSessoesPoolLote
+#define LOTE_SESSOES_BENCHMARK 64
+
+/**
+ * @brief Mede a rotatividade de medirSessoesPool com alocação em lote
+ * 
+ * A cada LOTE_SESSOES_BENCHMARK operações, as sessões mais antigas são
+ * devolvidas e o mesmo número é alocado por uma única chamada de
+ * alocarSessoesPool (cópia em bloco da primeira sessão). As sementes são
+ * as mesmas de medirSessoesPool.
+ */
+double medirSessoesPoolLote(const char* tipos, int quantidade) {
+    SessaoJogo* sessoes[SESSOES_BENCHMARK_ALOCACAO] = { NULL };
+    PoolSessoes pool;
+    inicializarPoolSessoes(&pool, sizeof(SessaoJogo));
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        int posicao = i & (SESSOES_BENCHMARK_ALOCACAO - 1);
+        if ((i & (LOTE_SESSOES_BENCHMARK - 1)) == 0) {
+            for (int s = posicao; s < posicao + LOTE_SESSOES_BENCHMARK; s++) {
+                if (sessoes[s] != NULL) {
+                    soma += sessoes[s]->sistema.pontuacaoTotal;
+                    liberarSessaoPool(&pool, sessoes[s]);
+                }
+            }
+            if (alocarSessoesPool(&pool, &sessoes[posicao], LOTE_SESSOES_BENCHMARK, 0, i, GERADOR_UNIFORME) !=
+                LOTE_SESSOES_BENCHMARK) {
+                printf("Memoria insuficiente para o benchmark.\n");
+                exit(1);
+            }
+        }
+        processarJogadaExpert(criarPeca(tipos[i], i), i & 1, &sessoes[posicao]->sistema);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    liberarPoolSessoes(&pool);
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Mede partidas repetidas com reinicializarSessoesPool
+ * 
+ * SESSOES_BENCHMARK_ALOCACAO sessões ficam alocadas (fora do tempo
+ * medido); a cada SESSOES_BENCHMARK_ALOCACAO operações todas recomeçam
+ * de uma vez, como uma nova rodada em que os jogadores permanecem.
+ */
+double medirSessoesPoolReinicio(const char* tipos, int quantidade) {
+    SessaoJogo* sessoes[SESSOES_BENCHMARK_ALOCACAO];
+    PoolSessoes pool;
+    inicializarPoolSessoes(&pool, sizeof(SessaoJogo));
+    if (alocarSessoesPool(&pool, sessoes, SESSOES_BENCHMARK_ALOCACAO, 0, 0, GERADOR_UNIFORME) !=
+        SESSOES_BENCHMARK_ALOCACAO) {
+        printf("Memoria insuficiente para o benchmark.\n");
+        exit(1);
+    }
+    long long soma = 0;
+    
+    double inicio = obterTempoNanossegundos();
+    for (int i = 0; i < quantidade; i++) {
+        int posicao = i & (SESSOES_BENCHMARK_ALOCACAO - 1);
+        if (posicao == 0 && i > 0) {
+            soma += sessoes[0]->sistema.pontuacaoTotal;
+            reinicializarSessoesPool(&pool, (uint64_t)i, GERADOR_UNIFORME);
+        }
+        processarJogadaExpert(criarPeca(tipos[i], i), i & 1, &sessoes[posicao]->sistema);
+    }
+    double fim = obterTempoNanossegundos();
+    
+    liberarPoolSessoes(&pool);
+    sumidouroBenchmark += soma;
+    return fim - inicio;
+}
+
+/**
+ * @brief Compara duas sessões recém-criadas (filas, pilhas, sistema e gerador)
+ * @return 1 se são equivalentes, 0 caso contrário
+ */
+static int sessoesJogoIguais(const SessaoJogo* a, const SessaoJogo* b) {
+    return a->fila.indiceFrente == b->fila.indiceFrente && a->fila.indiceTras == b->fila.indiceTras &&
+           a->fila.quantidadePecas == b->fila.quantidadePecas && a->fila.hashZobrist == b->fila.hashZobrist &&
+           a->fila.potenciaZobrist == b->fila.potenciaZobrist &&
+           a->pilha.indiceTopo == b->pilha.indiceTopo && a->pilha.quantidadeReservada == b->pilha.quantidadeReservada &&
+           a->pilha.hashZobrist == b->pilha.hashZobrist && a->pilha.potenciaZobrist == b->pilha.potenciaZobrist &&
+           sistemasExpertIguais(&a->sistema, &b->sistema) && a->proximoId == b->proximoId &&
+           memcmp(a->gerador.estado, b->gerador.estado, sizeof(a->gerador.estado)) == 0 &&
+           a->gerador.modo == b->gerador.modo && a->gerador.posicaoSaco == b->gerador.posicaoSaco &&
+           a->log == b->log && a->conselheiro == b->conselheiro && a->tabuleiro == b->tabuleiro;
+}
+
+/**
+ * @brief Confere a inicialização em lote do pool contra inicializarSessaoJogo
+ * @return Número de sessões divergentes (0 = equivalentes)
+ * 
+ * Aloca sessões em lote (mais de uma laje, começando de um índice não
+ * nulo), compara cada uma com inicializarSessaoJogo e a semente
+ * derivarSemente(base, primeiroIndice + i); depois joga algumas peças,
+ * reinicia o pool com outra semente base e compara de novo.
+ */
+int verificarSessoesPool() {
+    enum { SESSOES_VERIFICACAO = 150, PRIMEIRO_INDICE = 1000 };
+    const uint64_t sementes[2] = {0x5EED, 0xBEEF};
+    SessaoJogo* sessoes[SESSOES_VERIFICACAO];
+    PoolSessoes pool;
+    inicializarPoolSessoes(&pool, sizeof(SessaoJogo));
+    
+    int divergentes = 0;
+    int alocadas = alocarSessoesPool(&pool, sessoes, SESSOES_VERIFICACAO, sementes[0], PRIMEIRO_INDICE, GERADOR_SACO7);
+    for (int rodada = 0; rodada < 2 && alocadas == SESSOES_VERIFICACAO; rodada++) {
+        for (int i = 0; i < SESSOES_VERIFICACAO; i++) {
+            SessaoJogo referencia;
+            inicializarSessaoJogo(&referencia, derivarSemente(sementes[rodada], PRIMEIRO_INDICE + i), GERADOR_SACO7);
+            divergentes += !sessoesJogoIguais(sessoes[i], &referencia);
+            
+            gerarPecasAleatoriasSessao(sessoes[i]);
+            processarJogadaExpert(criarPeca(sortearTipoPeca(&sessoes[i]->gerador), i), 0, &sessoes[i]->sistema);
+        }
+        reinicializarSessoesPool(&pool, sementes[1], GERADOR_SACO7);
+    }
+    liberarPoolSessoes(&pool);
+    return alocadas == SESSOES_VERIFICACAO ? divergentes : SESSOES_VERIFICACAO;
+}
+
+/**
+ * @brief Compara dois doubles para ordenação com qsort
+ */
+static int compararDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Executa todas as amostras de uma medição e calcula os percentis
+ * @param configPtr Configuração do benchmark
+ * @param funcao Função cronometrada
+ * @param tipos Sequência de tipos da distribuição
+ * @param resultadoPtr Estatísticas calculadas (operacao/distribuicao preenchidos pelo chamador)
+ */
+void medirOperacao(const ConfiguracaoBenchmark* configPtr, FuncaoBenchmark funcao, const char* tipos, ResultadoBenchmark* resultadoPtr) {
+    double* amostras = malloc(sizeof(double) * configPtr->amostras);
+    if (amostras == NULL) {
+        printf("Memoria insuficiente para o benchmark.\n");
+        exit(1);
+    }
+    
+    // Aquecimento: estabiliza caches e preditores antes das amostras
+    funcao(tipos, configPtr->operacoesPorAmostra);
+    
+    double soma = 0;
+    for (int i = 0; i < configPtr->amostras; i++) {
+        amostras[i] = funcao(tipos, configPtr->operacoesPorAmostra) / configPtr->operacoesPorAmostra;
+        soma += amostras[i];
+    }
+    qsort(amostras, configPtr->amostras, sizeof(double), compararDoubles);
+    
+    int ultima = configPtr->amostras - 1;
+    resultadoPtr->media = soma / configPtr->amostras;
+    resultadoPtr->minimo = amostras[0];
+    resultadoPtr->p50 = amostras[ultima * 50 / 100];
+    resultadoPtr->p90 = amostras[ultima * 90 / 100];
+    resultadoPtr->p99 = amostras[ultima * 99 / 100];
+    resultadoPtr->maximo = amostras[ultima];
+    resultadoPtr->operacoesPorSegundo = resultadoPtr->media > 0 ? 1e9 / resultadoPtr->media : 0;
+    
+    free(amostras);
+}
+
+/**
+ * @brief Executa a suíte de microbenchmarks e grava o resultado em JSON
+ * @param configPtr Configuração do benchmark
+ * @return 0 em caso de sucesso, 1 se o arquivo de saída não pôde ser gravado
+ * 
+ * Cada operação é medida sob todas as distribuições de peças. A tabela é
+ * exibida no terminal e o arquivo JSON pode ser comparado entre revisões
+ * para detectar regressões de desempenho.
+ */
+int executarBenchmark(const ConfiguracaoBenchmark* configPtr) {
+    static const char* nomesDistribuicoes[TOTAL_DISTRIBUICOES] = {
+        "uniforme", "unica", "alternada", "enviesada"
+    };
+    static const char* nomesOperacoes[] = {
+        "fila_inserir_jogar", "fila_lote_inserir_jogar", "pilha_reservar_jogar", "calcular_pontuacao",
+        "detectar_combo", "nivel_para_pontuacao", "processar_jogada_expert", "processar_jogadas_lote",
+        "gerar_pecas_lote", "tabuleiro_soltar_fixar", "tabuleiro_posicionar",
+        "tabuleiro_com_cache", "sessoes_malloc", "sessoes_pool", "sessoes_pool_lote", "sessoes_pool_reinicio"
+    };
+    static const FuncaoBenchmark funcoes[] = {
+        medirFilaCircular, medirFilaCircularLote, medirPilhaReserva, medirCalculoPontuacao,
+        medirDeteccaoCombo, medirNivelParaPontuacao, medirJogadaExpert, medirJogadaExpertLote,
+        medirGeradorPecas, medirTabuleiroSoltarFixar, medirTabuleiroColocacao,
+        medirTabuleiroColocacaoCache, medirSessoesMalloc, medirSessoesPool, medirSessoesPoolLote,
+        medirSessoesPoolReinicio
+    };
+    const int totalOperacoes = (int)(sizeof(funcoes) / sizeof(funcoes[0]));
+    
+    FILE* saida = fopen(configPtr->arquivoSaida, "w");
+    if (saida == NULL) {
+        printf("Nao foi possivel criar %s\n", configPtr->arquivoSaida);
+        return 1;
+    }
+    
+    char* tipos = malloc(configPtr->operacoesPorAmostra);
+    if (tipos == NULL) {
+        fclose(saida);
+        printf("Memoria insuficiente para o benchmark.\n");
+        return 1;
+    }
+    
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;
+    GeradorPecas gerador;
+    inicializarGeradorPecas(&gerador, configPtr->semente, GERADOR_UNIFORME);
+    
+    fprintf(saida, "{\n  \"rotulo\": \"%s\",\n  \"compilador\": \"%s\",\n", configPtr->rotulo, __VERSION__);
+    fprintf(saida, "  \"kernel_lote\": \"%s\",\n", nomeKernelLote());
+    fprintf(saida, "  \"data\": %lld,\n  \"amostras\": %d,\n  \"operacoes_por_amostra\": %d,\n",
+            (long long)time(NULL), configPtr->amostras, configPtr->operacoesPorAmostra);
+    fprintf(saida, "  \"resultados\": [\n");
+    
+    int sessoesDivergentes = verificarSessoesPool();
+    if (sessoesDivergentes != 0) {
+        printf("ERRO: sessoes do pool divergem de inicializarSessaoJogo em %d sessoes\n", sessoesDivergentes);
+        modoSilencioso = silencioAnterior;
+        free(tipos);
+        fclose(saida);
+        return 1;
+    }
+    
+    printf("%-24s %-10s %9s %9s %9s %9s %14s\n", "operacao", "distrib.", "media", "p50", "p90", "p99", "ops/s");
+    int primeiro = 1;
+    for (int d = 0; d < TOTAL_DISTRIBUICOES; d++) {
+        gerarDistribuicaoPecas(&gerador, (DistribuicaoPecas)d, tipos, configPtr->operacoesPorAmostra);
+        
+        int divergentes = verificarPontuacaoLote(tipos, configPtr->operacoesPorAmostra);
+        if (divergentes != 0) {
+            printf("ERRO: pontuacao em lote (%s) diverge do caminho escalar em %d sessoes (%s)\n",
+                   nomeKernelLote(), divergentes, nomesDistribuicoes[d]);
+            modoSilencioso = silencioAnterior;
+            free(tipos);
+            fclose(saida);
+            return 1;
+        }
+        
+        for (int o = 0; o < totalOperacoes; o++) {
+            ResultadoBenchmark resultado;
+            resultado.operacao = nomesOperacoes[o];
+            resultado.distribuicao = nomesDistribuicoes[d];
+            medirOperacao(configPtr, funcoes[o], tipos, &resultado);
+            
+            printf("%-24s %-10s %9.2f %9.2f %9.2f %9.2f %14.0f\n", resultado.operacao, resultado.distribuicao,
+                   resultado.media, resultado.p50, resultado.p90, resultado.p99, resultado.operacoesPorSegundo);
+            fprintf(saida, "%s    {\"operacao\": \"%s\", \"distribuicao\": \"%s\", \"ns_media\": %.3f, "
+                    "\"ns_min\": %.3f, \"ns_p50\": %.3f, \"ns_p90\": %.3f, \"ns_p99\": %.3f, "
+                    "\"ns_max\": %.3f, \"ops_por_segundo\": %.0f}",
+                    primeiro ? "" : ",\n", resultado.operacao, resultado.distribuicao, resultado.media,
+                    resultado.minimo, resultado.p50, resultado.p90, resultado.p99, resultado.maximo,
+                    resultado.operacoesPorSegundo);
+            primeiro = 0;
+        }
+    }
+    fprintf(saida, "\n  ]\n}\n");
+    
+    modoSilencioso = silencioAnterior;
+    free(tipos);
+    fclose(saida);
+    printf("(tempos em ns/op) Resultados gravados em %s\n", configPtr->arquivoSaida);
+    return 0;
+}
+
+/**
+ * @brief Interpreta os argumentos de linha de comando do modo --benchmark
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos
+ * @param configPtr Configuração a ser preenchida
+ * @return 1 se os argumentos são válidos, 0 caso contrário
+ * 
+ * Opções aceitas (após --benchmark):
+ * - --amostras N    Amostras por medição (padrão 200)
+ * - --operacoes N   Operações por amostra (padrão 10000)
+ * - --saida ARQ     Arquivo JSON de resultados (padrão bench_results.json)
+ * - --rotulo TEXTO  Identificação da revisão (padrão "local"); apenas [A-Za-z0-9_.-],
+ *                   já que é gravado sem escape no JSON
+ * - --semente N     Semente das distribuições (padrão 1)
+ */
+int interpretarArgumentosBenchmark(int argc, char* argv[], ConfiguracaoBenchmark* configPtr) {
+    configPtr->amostras = 200;
+    configPtr->operacoesPorAmostra = 10000;
+    configPtr->arquivoSaida = "bench_results.json";
+    configPtr->rotulo = "local";
+    configPtr->semente = 1;
+    
+    for (int i = 2; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (valor == NULL) {
+            printf("Opcao %s sem valor.\n", opcao);
+            return 0;
+        }
+        
+        if (strcmp(opcao, "--amostras") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->amostras)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--operacoes") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->operacoesPorAmostra)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--saida") == 0) {
+            configPtr->arquivoSaida = valor;
+        } else if (strcmp(opcao, "--rotulo") == 0) {
+            configPtr->rotulo = valor;
+        } else if (strcmp(opcao, "--semente") == 0) {
+            long long semente;
+            if (!lerInteiroLongoOpcao(opcao, valor, 0, UINT_MAX, &semente)) {
+                return 0;
+            }
+            configPtr->semente = (unsigned int)semente;
+        } else {
+            printf("Opcao desconhecida: %s\n", opcao);
+            return 0;
+        }
+        i++;
+    }
+    
+    if (configPtr->rotulo[0] == '\0' || configPtr->rotulo[strspn(configPtr->rotulo,
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_.-")] != '\0') {
+        printf("Rotulo invalido: %s (use apenas letras, digitos, '_', '.' e '-').\n", configPtr->rotulo);
+        return 0;
+    }
+    
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                     RENDERIZADOR DE TERMINAL (QUADRO DIFERENCIAL)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Prepara um quadro vazio, sem quadro anterior
+ * @param quadroPtr Ponteiro para o quadro
+ */
+void inicializarQuadroTerminal(QuadroTerminal* quadroPtr) {
+    memset(quadroPtr, 0, sizeof(*quadroPtr));
+    limparQuadroTerminal(quadroPtr);
+}
+
+/**
+ * @brief Inicia a composição de um novo quadro
+ * @param quadroPtr Ponteiro para o quadro
+ * 
+ * O quadro anterior é preservado para a comparação; o tempo de quadro
+ * é contado a partir daqui.
+ */
+void limparQuadroTerminal(QuadroTerminal* quadroPtr) {
+    quadroPtr->inicioNs = obterTempoNanossegundos();
+    memset(quadroPtr->celulas, ' ', sizeof(quadroPtr->celulas));
+    memset(quadroPtr->comprimentos, 0, sizeof(quadroPtr->comprimentos));
+    quadroPtr->linhaAtual = 0;
+}
+
+/**
+ * @brief Escreve a próxima linha do quadro (formato de printf, sem '\n')
+ * @param quadroPtr Ponteiro para o quadro
+ * @param formato Formato de printf
+ * 
+ * Linhas além de LINHAS_QUADRO são descartadas e o texto é truncado em
+ * COLUNAS_QUADRO.
+ */
+void escreverLinhaQuadro(QuadroTerminal* quadroPtr, const char* formato, ...) {
+    if (quadroPtr->linhaAtual >= LINHAS_QUADRO) {
+        return;
+    }
+    
+    char linha[COLUNAS_QUADRO + 1];
+    va_list argumentos;
+    va_start(argumentos, formato);
+    int comprimento = vsnprintf(linha, sizeof(linha), formato, argumentos);
+    va_end(argumentos);
+    if (comprimento < 0) {
+        comprimento = 0;
+    } else if (comprimento > COLUNAS_QUADRO) {
+        comprimento = COLUNAS_QUADRO;
+    }
+    
+    memcpy(quadroPtr->celulas[quadroPtr->linhaAtual], linha, (size_t)comprimento);
+    quadroPtr->comprimentos[quadroPtr->linhaAtual] = comprimento;
+    quadroPtr->linhaAtual++;
+}
+
+/**
+ * @brief Compõe a linha com as peças da fila
+ * @param quadroPtr Ponteiro para o quadro
+ * @param filaPtr Ponteiro para a fila
+ */
+void comporFila(QuadroTerminal* quadroPtr, const FilaCircular* filaPtr) {
+    char pecas[2 * CAPACIDADE_FILA + 1];
+    int comprimento = 0;
+    for (int i = 0; i < filaPtr->quantidadePecas; i++) {
+        int indice = INDICE_CIRCULAR(filaPtr->indiceFrente + i);
+        pecas[comprimento++] = tipoPecaCompacta(filaPtr->pecas[indice]);
+        pecas[comprimento++] = ' ';
+    }
+    pecas[comprimento] = '\0';
+    escreverLinhaQuadro(quadroPtr, "Fila: %s", pecas);
+}
+
+/**
+ * @brief Compõe a linha com as peças da pilha (do topo para a base)
+ * @param quadroPtr Ponteiro para o quadro
+ * @param pilhaPtr Ponteiro para a pilha
+ */
+void comporPilha(QuadroTerminal* quadroPtr, const PilhaReserva* pilhaPtr) {
+    char pecas[2 * CAPACIDADE_PILHA + 1];
+    int comprimento = 0;
+    for (int i = pilhaPtr->indiceTopo; i >= 0; i--) {
+        pecas[comprimento++] = tipoPecaCompacta(pilhaPtr->pecasReservadas[i]);
+        pecas[comprimento++] = ' ';
+    }
+    pecas[comprimento] = '\0';
+    escreverLinhaQuadro(quadroPtr, "Pilha: %s", pecas);
+}
+
+/**
+ * @brief Preenche uma barra de progresso de 20 posições
+ * @param barra Destino com pelo menos 21 bytes
+ * @param preenchidas Posições marcadas com '#' (limitadas a 0..20)
+ */
+static void preencherBarraProgresso(char* barra, int preenchidas) {
+    if (preenchidas < 0) {
+        preenchidas = 0;
+    } else if (preenchidas > 20) {
+        preenchidas = 20;
+    }
+    memset(barra, '#', (size_t)preenchidas);
+    memset(barra + preenchidas, '-', (size_t)(20 - preenchidas));
+    barra[20] = '\0';
+}
+
+/**
+ * @brief Compõe o painel de estatísticas do sistema Expert (17 linhas)
+ * @param quadroPtr Ponteiro para o quadro
+ * @param sistemaPtr Ponteiro para o sistema Expert
+ */
+void comporEstatisticasExpert(QuadroTerminal* quadroPtr, const SistemaExpert* sistemaPtr) {
+    char barra[21];
+    
+    escreverLinhaQuadro(quadroPtr, "+==============================================================+");
+    escreverLinhaQuadro(quadroPtr, "|                    ESTATISTICAS EXPERT                      |");
+    escreverLinhaQuadro(quadroPtr, "+==============================================================+");
+    
+    // Pontuacao e Progressao
+    escreverLinhaQuadro(quadroPtr, "| Pontuacao Total: %8d  |  Nivel Atual: %3d            |",
+                        sistemaPtr->pontuacaoTotal, sistemaPtr->nivelAtual);
+    escreverLinhaQuadro(quadroPtr, "| Recorde Pessoal: %8d  |  Multiplicador: %.1fx         |",
+                        sistemaPtr->recordePessoal, sistemaPtr->multiplicadorAtual);
+    
+    // Progresso do nivel com barra visual
+    preencherBarraProgresso(barra, (int)((double)sistemaPtr->pontuacaoTotal / sistemaPtr->limitePontosNivel * 20));
+    escreverLinhaQuadro(quadroPtr, "| Progresso: [%s] %3d%%    |", barra,
+                        (int)((double)sistemaPtr->pontuacaoTotal / sistemaPtr->limitePontosNivel * 100));
+    
+    // Combos e Sequencias
+    escreverLinhaQuadro(quadroPtr, "| Combo Atual: %3d      |  Melhor Combo: %3d           |",
+                        sistemaPtr->comboAtual, sistemaPtr->melhorCombo);
+    escreverLinhaQuadro(quadroPtr, "| Sequencia: %3d        |  Ultima Peca: %c              |",
+                        sistemaPtr->sequenciaTipoAtual, sistemaPtr->ultimoTipoJogado);
+    
+    // Estatisticas de Tipos de Pecas
+    escreverLinhaQuadro(quadroPtr, "+==============================================================+");
+    escreverLinhaQuadro(quadroPtr, "| Tipo Mais Jogado: %c  |  Total de Jogadas: %4d        |",
+                        sistemaPtr->tipoMaisJogado, sistemaPtr->totalJogadas);
+    
+    int contagens[7];
+    consultarDistribuicaoTipos(sistemaPtr, contagens);
+    escreverLinhaQuadro(quadroPtr, "| Tipos de Pecas:                                      |");
+    escreverLinhaQuadro(quadroPtr, "|   I:%2d  O:%2d  T:%2d  S:%2d  Z:%2d  J:%2d  L:%2d           |",
+                        contagens[PECA_I], contagens[PECA_O], contagens[PECA_T], contagens[PECA_S],
+                        contagens[PECA_Z], contagens[PECA_J], contagens[PECA_L]);
+    
+    // Eficiencia do Jogo
+    escreverLinhaQuadro(quadroPtr, "+==============================================================+");
+    escreverLinhaQuadro(quadroPtr, "| Jogadas da Fila: %4d   |  Jogadas da Pilha: %4d      |",
+                        sistemaPtr->jogadasDaFila, sistemaPtr->jogadasDaPilha);
+    
+    // Eficiencia da reserva com barra visual (escala para 20 caracteres)
+    preencherBarraProgresso(barra, (int)(sistemaPtr->eficienciaReserva / 5));
+    escreverLinhaQuadro(quadroPtr, "| Eficiencia Reserva: [%s] %5.1f%% |", barra, (double)sistemaPtr->eficienciaReserva);
+    
+    // Conquistas e Marcos
+    escreverLinhaQuadro(quadroPtr, "| Marcos Alcancados: %2d  |  Fator Dificuldade: %.1fx      |",
+                        sistemaPtr->marcosAlcancados, sistemaPtr->fatorDificuldade);
+    escreverLinhaQuadro(quadroPtr, "+==============================================================+");
+}
+
+/**
+ * @brief Escreve um texto em uma posição do quadro, sem mudar a linha atual
+ * @param quadroPtr Ponteiro para o quadro
+ * @param linha Linha de destino
+ * @param coluna Coluna inicial
+ * @param texto Texto (truncado na borda do quadro)
+ */
+void escreverQuadroEm(QuadroTerminal* quadroPtr, int linha, int coluna, const char* texto) {
+    if (linha < 0 || linha >= LINHAS_QUADRO || coluna < 0 || coluna >= COLUNAS_QUADRO) {
+        return;
+    }
+    
+    int comprimento = (int)strlen(texto);
+    if (comprimento > COLUNAS_QUADRO - coluna) {
+        comprimento = COLUNAS_QUADRO - coluna;
+    }
+    memcpy(&quadroPtr->celulas[linha][coluna], texto, (size_t)comprimento);
+    if (coluna + comprimento > quadroPtr->comprimentos[linha]) {
+        quadroPtr->comprimentos[linha] = coluna + comprimento;
+    }
+}
+
+/**
+ * @brief Compõe o poço (topo na linha 0 do quadro) a partir de uma coluna
+ * @param quadroPtr Ponteiro para o quadro
+ * @param tabuleiroPtr Poço
+ * @param coluna Coluna do quadro onde começa a borda esquerda
+ */
+void comporTabuleiro(QuadroTerminal* quadroPtr, const TabuleiroJogo* tabuleiroPtr, int coluna) {
+    char linhaTexto[LARGURA_TABULEIRO + 3];
+    linhaTexto[0] = '|';
+    linhaTexto[LARGURA_TABULEIRO + 1] = '|';
+    linhaTexto[LARGURA_TABULEIRO + 2] = '\0';
+    
+    for (int linha = ALTURA_TABULEIRO - 1; linha >= 0; linha--) {
+        unsigned int conteudo = tabuleiroPtr->linhas[linha];
+        for (int c = 0; c < LARGURA_TABULEIRO; c++) {
+            linhaTexto[c + 1] = ((conteudo >> c) & 1u) ? '#' : '.';
+        }
+        escreverQuadroEm(quadroPtr, ALTURA_TABULEIRO - 1 - linha, coluna, linhaTexto);
+    }
+    memset(linhaTexto + 1, '-', LARGURA_TABULEIRO);
+    linhaTexto[0] = linhaTexto[LARGURA_TABULEIRO + 1] = '+';
+    escreverQuadroEm(quadroPtr, ALTURA_TABULEIRO, coluna, linhaTexto);
+}
+
+/**
+ * @brief Entrega um bloco ao terminal com uma única chamada a write
+ * @param dados Bytes a emitir
+ * @param tamanho Quantidade de bytes
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ * 
+ * A saída pendente de printf é descarregada antes, preservando a ordem.
+ * Só há novas chamadas se o terminal aceitar o bloco parcialmente.
+ */
+static int escreverSaidaTerminal(const char* dados, size_t tamanho) {
+    fflush(stdout);
+#ifdef _WIN32
+    size_t escritos = fwrite(dados, 1, tamanho, stdout);
+    fflush(stdout);
+    return escritos == tamanho;
+#else
+    while (tamanho > 0) {
+        ssize_t escritos = write(STDOUT_FILENO, dados, tamanho);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        dados += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 1;
+#endif
+}
+
+/**
+ * @brief Contabiliza o tempo e o tamanho do quadro que acabou de ser emitido
+ */
+static void registrarQuadroTerminal(QuadroTerminal* quadroPtr, int bytes) {
+    quadroPtr->ultimoNs = obterTempoNanossegundos() - quadroPtr->inicioNs;
+    quadroPtr->ultimosBytes = bytes;
+    quadroPtr->quadros++;
+    quadroPtr->bytes += bytes;
+    quadroPtr->somaNs += quadroPtr->ultimoNs;
+    if (quadroPtr->ultimoNs > quadroPtr->maiorNs) {
+        quadroPtr->maiorNs = quadroPtr->ultimoNs;
+    }
+}
+
+/**
+ * @brief Apresenta o quadro composto emitindo apenas as células alteradas
+ * @param quadroPtr Ponteiro para o quadro
+ * @return Bytes emitidos, ou -1 em caso de erro de escrita
+ * 
+ * Cada trecho alterado de uma linha vira um posicionamento de cursor
+ * seguido do texto; trechos separados por até INTERVALO_FUSAO_QUADRO
+ * células iguais são fundidos, pois reenviar essas células custa menos
+ * que um novo posicionamento. O primeiro quadro limpa a tela e oculta o
+ * cursor. Tudo é emitido com um único write.
+ */
+int apresentarQuadroTerminal(QuadroTerminal* quadroPtr) {
+    static const char abertura[] = "\033[?25l\033[H\033[2J";
+    int tamanho = 0;
+    
+    if (!quadroPtr->anteriorValido) {
+        memcpy(quadroPtr->saida, abertura, sizeof(abertura) - 1);
+        tamanho = (int)sizeof(abertura) - 1;
+        memset(quadroPtr->anteriores, ' ', sizeof(quadroPtr->anteriores));
+        quadroPtr->anteriorValido = 1;
+    }
+    
+    for (int linha = 0; linha < LINHAS_QUADRO; linha++) {
+        const char* atual = quadroPtr->celulas[linha];
+        const char* anterior = quadroPtr->anteriores[linha];
+        
+        for (int coluna = 0; coluna < COLUNAS_QUADRO; coluna++) {
+            if (atual[coluna] == anterior[coluna]) {
+                continue;
+            }
+            
+            // Estender o trecho enquanto a próxima diferença estiver próxima
+            int inicio = coluna;
+            int fim = coluna + 1;
+            quadroPtr->celulasAlteradas++;
+            for (int j = fim; j < COLUNAS_QUADRO && j - fim <= INTERVALO_FUSAO_QUADRO; j++) {
+                if (atual[j] != anterior[j]) {
+                    fim = j + 1;
+                    quadroPtr->celulasAlteradas++;
+                }
+            }
+            
+            tamanho += snprintf(quadroPtr->saida + tamanho, CAPACIDADE_SAIDA_QUADRO - (size_t)tamanho,
+                                "\033[%d;%dH", linha + 1, inicio + 1);
+            memcpy(quadroPtr->saida + tamanho, atual + inicio, (size_t)(fim - inicio));
+            tamanho += fim - inicio;
+            coluna = fim - 1;
+        }
+    }
+    memcpy(quadroPtr->anteriores, quadroPtr->celulas, sizeof(quadroPtr->anteriores));
+    
+    if (tamanho > 0 && !escreverSaidaTerminal(quadroPtr->saida, (size_t)tamanho)) {
+        return -1;
+    }
+    registrarQuadroTerminal(quadroPtr, tamanho);
+    return tamanho;
+}
+
+/**
+ * @brief Emite as linhas compostas em sequência, sem posicionar o cursor
+ * @param quadroPtr Ponteiro para o quadro
+ * @return Bytes emitidos, ou -1 em caso de erro de escrita
+ * 
+ * Usada pelas telas do menu, que rolam com o restante da saída: uma única
+ * escrita por tela, sem comparação com o quadro anterior.
+ */
+int emitirQuadroTerminal(QuadroTerminal* quadroPtr) {
+    int tamanho = 0;
+    for (int linha = 0; linha < quadroPtr->linhaAtual; linha++) {
+        int comprimento = quadroPtr->comprimentos[linha];
+        memcpy(quadroPtr->saida + tamanho, quadroPtr->celulas[linha], (size_t)comprimento);
+        tamanho += comprimento;
+        quadroPtr->saida[tamanho++] = '\n';
+    }
+    
+    if (tamanho > 0 && !escreverSaidaTerminal(quadroPtr->saida, (size_t)tamanho)) {
+        return -1;
+    }
+    registrarQuadroTerminal(quadroPtr, tamanho);
+    return tamanho;
+}
+
+/**
+ * @brief Devolve o terminal ao uso normal após quadros diferenciais
+ * @param quadroPtr Ponteiro para o quadro
+ * 
+ * Posiciona o cursor abaixo do quadro e volta a exibi-lo.
+ */
+void encerrarQuadroTerminal(QuadroTerminal* quadroPtr) {
+    if (quadroPtr->anteriorValido) {
+        char sequencia[32];
+        int tamanho = snprintf(sequencia, sizeof(sequencia), "\033[%d;1H\033[?25h\n", LINHAS_QUADRO);
+        escreverSaidaTerminal(sequencia, (size_t)tamanho);
+        quadroPtr->anteriorValido = 0;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+//                        JOGO EM TEMPO REAL (LAÇO DE EVENTOS)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Intervalo da queda automática para um nível
+ * @param nivel Nível atual do sistema Expert
+ * @return Passos fixos entre duas quedas automáticas
  */
-int calcularPontuacao(char tipoPeca, SistemaExpert* sistemaPtr) {
-    int pontuacaoBase = 0;
+int passosEntreQuedas(int nivel) {
+    int passos = PASSOS_QUEDA_INICIAL - (nivel - 1) * 8;
+    return passos < PASSOS_QUEDA_MINIMO ? PASSOS_QUEDA_MINIMO : passos;
+}
+
+/**
+ * @brief Prepara uma partida em tempo real com a fila cheia
+ * @param jogoPtr Ponteiro para o estado do jogo
+ * @param semente Semente do gerador de peças
+ * @param logPtr Log binário das ações (NULL = desativado)
+ * @param usarCacheColocacoes 1 para ligar o cache de colocações do poço
+ * 
+ * O cache fica desligado por padrão: com o gerador uniforme as superfícies
+ * quase não se repetem e a consulta extra deixa cada colocação mais lenta
+ * (medido: 986 ns com cache contra 926 ns sem). Só compensa com fluxos de
+ * peças repetitivos.
+ */
+void inicializarJogoTempoReal(JogoTempoReal* jogoPtr, uint64_t semente, LogJogadas* logPtr, int usarCacheColocacoes) {
+    memset(jogoPtr, 0, sizeof(*jogoPtr));
+    inicializarQuadroTerminal(&jogoPtr->quadro);
+    inicializarSessaoJogo(&jogoPtr->sessao, semente, GERADOR_UNIFORME);
+    inicializarTabuleiro(&jogoPtr->tabuleiro);
+    if (usarCacheColocacoes && inicializarCacheColocacoes(&jogoPtr->cache, BITS_CACHE_COLOCACOES)) {
+        jogoPtr->tabuleiro.cache = &jogoPtr->cache;
+    }
+    jogoPtr->sessao.tabuleiro = &jogoPtr->tabuleiro;
+    jogoPtr->sessao.log = logPtr;
+    registrarEventoLog(logPtr, EVENTO_INICIO_SESSAO, 0, criarPeca('X', 0), 1);
+    gerarPecasAleatoriasSessao(&jogoPtr->sessao);
+    
+    jogoPtr->passosAteQueda = passosEntreQuedas(jogoPtr->sessao.sistema.nivelAtual);
+    jogoPtr->alterado = 1;
+    snprintf(jogoPtr->mensagem, sizeof(jogoPtr->mensagem), "Boa partida!");
+}
+
+/**
+ * @brief Aplica a ação associada a uma tecla
+ * @param jogoPtr Ponteiro para o estado do jogo
+ * @param tecla Byte lido do terminal
+ * 
+ * As ações passam por executarAcaoHeadless, com as mesmas regras (e o
+ * mesmo registro no log) do menu interativo. Jogar a peça da frente
+ * reinicia a contagem da queda automática, como a chegada de uma nova
+ * peça ao topo do tabuleiro.
+ */
+void processarTeclaTempoReal(JogoTempoReal* jogoPtr, unsigned char tecla) {
+    SessaoJogo* sessaoPtr = &jogoPtr->sessao;
+    int acao = 0;
     
-    // Pontuação base por tipo de peça
-    switch (tipoPeca) {
-        case 'I': pontuacaoBase = 100; break; // Linha reta
-        case 'O': pontuacaoBase = 80;  break; // Quadrado
-        case 'T': pontuacaoBase = 90;  break; // T
-        case 'S': pontuacaoBase = 85;  break; // S
-        case 'Z': pontuacaoBase = 85;  break; // Z
-        case 'J': pontuacaoBase = 75;  break; // J
-        case 'L': pontuacaoBase = 75;  break; // L
-        default:  pontuacaoBase = 50;  break; // Peça desconhecida
+    switch (tecla) {
+        case '1': case 'j': acao = 1; break;
+        case '2': case 'k': acao = 2; break;
+        case '3': case 'r': acao = 3; break;
+        case '4': case 'g': acao = 4; break;
+        case 'p':
+            jogoPtr->pausado = !jogoPtr->pausado;
+            jogoPtr->alterado = 1;
+            return;
+        case 'q': case '0': case 0x03: case 0x04:  // Ctrl+C e Ctrl+D também encerram
+            jogoPtr->encerrado = 1;
+            return;
+        default:
+            return;
     }
     
-    // Aplicar multiplicadores
-    return (int)(pontuacaoBase * sistemaPtr->multiplicadorAtual * sistemaPtr->fatorDificuldade);
+    if (jogoPtr->pausado) {
+        return;
+    }
+    int nivelAnterior = sessaoPtr->sistema.nivelAtual;
+    if (!executarAcaoHeadless(acao, sessaoPtr)) {
+        snprintf(jogoPtr->mensagem, sizeof(jogoPtr->mensagem),
+                 acao == 2 ? "Pilha de reserva vazia!" : acao == 3 ? "Nao e possivel reservar agora." : "Fila vazia!");
+    } else if (sessaoPtr->sistema.nivelAtual != nivelAnterior) {
+        snprintf(jogoPtr->mensagem, sizeof(jogoPtr->mensagem), "*** NIVEL %d ALCANCADO! ***", sessaoPtr->sistema.nivelAtual);
+    } else {
+        jogoPtr->mensagem[0] = '\0';
+    }
+    if (acao == 1) {
+        jogoPtr->passosAteQueda = passosEntreQuedas(sessaoPtr->sistema.nivelAtual);
+    }
+    jogoPtr->alterado = 1;
 }
 
 /**
- * @brief Detecta e processa combos de peças consecutivas
- * @param sistemaPtr Ponteiro para o sistema Expert
- * @param tipoPeca Tipo da peça atual
- * @return Multiplicador de combo aplicado
+ * @brief Executa um passo fixo do jogo (gravidade)
+ * @param jogoPtr Ponteiro para o estado do jogo
+ * 
+ * Quando a contagem chega a zero a peça da frente é jogada; com a fila
+ * vazia, a queda reabastece a fila em vez de jogar.
  */
-double detectarCombo(SistemaExpert* sistemaPtr, char tipoPeca) {
-    if (sistemaPtr->ultimoTipoJogado == tipoPeca) {
-        sistemaPtr->sequenciaTipoAtual++;
-        if (sistemaPtr->sequenciaTipoAtual >= 3) {
-            sistemaPtr->comboAtual = sistemaPtr->sequenciaTipoAtual - 2;
-            if (sistemaPtr->comboAtual > sistemaPtr->melhorCombo) {
-                sistemaPtr->melhorCombo = sistemaPtr->comboAtual;
-            }
-            return 1.0 + (sistemaPtr->comboAtual * 0.2);
-        }
+void executarPassoTempoReal(JogoTempoReal* jogoPtr) {
+    jogoPtr->passos++;
+    if (jogoPtr->pausado || --jogoPtr->passosAteQueda > 0) {
+        return;
+    }
+    
+    SessaoJogo* sessaoPtr = &jogoPtr->sessao;
+    int nivelAnterior = sessaoPtr->sistema.nivelAtual;
+    if (filaVazia(&sessaoPtr->fila)) {
+        executarAcaoHeadless(4, sessaoPtr);
     } else {
-        sistemaPtr->sequenciaTipoAtual = 1;
-        sistemaPtr->comboAtual = 0;
+        executarAcaoHeadless(1, sessaoPtr);
+        jogoPtr->quedas++;
     }
-    sistemaPtr->ultimoTipoJogado = tipoPeca;
-    return 1.0;
+    if (sessaoPtr->sistema.nivelAtual != nivelAnterior) {
+        snprintf(jogoPtr->mensagem, sizeof(jogoPtr->mensagem), "*** NIVEL %d ALCANCADO! ***", sessaoPtr->sistema.nivelAtual);
+    }
+    jogoPtr->passosAteQueda = passosEntreQuedas(sessaoPtr->sistema.nivelAtual);
+    jogoPtr->alterado = 1;
 }
 
 /**
- * @brief Verifica e processa a progressão de nível baseada na pontuação
- * @param sistemaPtr Ponteiro para o sistema Expert
+ * @brief Acumula uma medição de latência
+ * @param metricasPtr Métricas a atualizar
+ * @param nanossegundos Latência medida
+ */
+void registrarLatencia(MetricasLatencia* metricasPtr, double nanossegundos) {
+    metricasPtr->teclas++;
+    metricasPtr->somaNs += nanossegundos;
+    if (nanossegundos > metricasPtr->maiorNs) {
+        metricasPtr->maiorNs = nanossegundos;
+    }
+    if (nanossegundos > LIMITE_LATENCIA_TEMPO_REAL_NS) {
+        metricasPtr->acimaLimite++;
+    }
+}
+
+/**
+ * @brief Desenha o quadro atual do jogo em tempo real
+ * @param jogoPtr Ponteiro para o estado do jogo
  * 
- * Esta função implementa um sistema dinâmico de progressão que:
- * - Monitora a pontuação atual do nível
- * - Calcula progressão exponencial de dificuldade
- * - Ajusta automaticamente multiplicadores e limites
- * - Fornece feedback visual da evolução
+ * Chamada pelo laço de eventos apenas quando o estado mudou. O quadro
+ * ocupa as 24 linhas do terminal e só as células alteradas são emitidas.
  */
-void verificarProgressaoNivel(SistemaExpert* sistemaPtr) {
-    // Verificar se atingiu pontos suficientes para próximo nível
-    if (sistemaPtr->pontuacaoTotal >= sistemaPtr->limitePontosNivel) {
-        sistemaPtr->nivelAtual++;
-        
-        // Calcular novo limite com progressão exponencial
-        sistemaPtr->limitePontosNivel = (int)(1000 * pow(1.5, sistemaPtr->nivelAtual - 1));
-        sistemaPtr->pontosParaProximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
-        
-        // Aumentar fator de dificuldade (máximo 3.0)
-        if (sistemaPtr->fatorDificuldade < 3.0) {
-            sistemaPtr->fatorDificuldade += 0.2;
+void desenharQuadroTempoReal(JogoTempoReal* jogoPtr) {
+    const SessaoJogo* sessaoPtr = &jogoPtr->sessao;
+    const MetricasLatencia* latenciaPtr = &jogoPtr->latencia;
+    QuadroTerminal* quadroPtr = &jogoPtr->quadro;
+    
+    limparQuadroTerminal(quadroPtr);
+    comporFila(quadroPtr, &sessaoPtr->fila);
+    comporPilha(quadroPtr, &sessaoPtr->pilha);
+    comporEstatisticasExpert(quadroPtr, &sessaoPtr->sistema);
+    escreverLinhaQuadro(quadroPtr, "Linhas: %d | queda a cada %d ms%s", jogoPtr->tabuleiro.linhasRemovidas,
+                        passosEntreQuedas(sessaoPtr->sistema.nivelAtual) * PASSO_TEMPO_REAL_MS,
+                        jogoPtr->pausado ? "   [PAUSADO]" : "");
+    escreverLinhaQuadro(quadroPtr, "Latencia: media %.1f us | max %.1f us | >1 ms: %lld",
+                        latenciaPtr->teclas > 0 ? latenciaPtr->somaNs / latenciaPtr->teclas / 1e3 : 0.0,
+                        latenciaPtr->maiorNs / 1e3, latenciaPtr->acimaLimite);
+    escreverLinhaQuadro(quadroPtr, "Quadro: %.1f us, %d bytes | max %.1f us",
+                        quadroPtr->ultimoNs / 1e3, quadroPtr->ultimosBytes, quadroPtr->maiorNs / 1e3);
+    escreverLinhaQuadro(quadroPtr, "%.64s", jogoPtr->mensagem);
+    escreverLinhaQuadro(quadroPtr, "1/j fila   2/k pilha   3/r reservar   4/g gerar   p pausar   q sair");
+    
+    // Poço à direita dos painéis, ocupando as linhas 0 a ALTURA_TABULEIRO
+    comporTabuleiro(quadroPtr, &jogoPtr->tabuleiro, COLUNAS_QUADRO - LARGURA_TABULEIRO - 4);
+    apresentarQuadroTerminal(quadroPtr);
+}
+
+/**
+ * @brief Exibe o resumo de uma partida em tempo real
+ * @param jogoPtr Ponteiro para o estado do jogo
+ */
+void exibirResumoTempoReal(const JogoTempoReal* jogoPtr) {
+    const MetricasLatencia* latenciaPtr = &jogoPtr->latencia;
+    
+    printf("\n=== JOGO EM TEMPO REAL ===\n");
+    printf("Pontuacao final: %d (nivel %d, melhor combo %d)\n", jogoPtr->sessao.sistema.pontuacaoTotal,
+           jogoPtr->sessao.sistema.nivelAtual, jogoPtr->sessao.sistema.melhorCombo);
+    const QuadroTerminal* quadroPtr = &jogoPtr->quadro;
+    printf("Passos de %d ms: %lld | quedas automaticas: %lld\n", PASSO_TEMPO_REAL_MS, jogoPtr->passos, jogoPtr->quedas);
+    printf("Linhas completadas: %d | pocos esvaziados: %d\n", jogoPtr->tabuleiro.linhasRemovidas, jogoPtr->tabuleiro.derrotas);
+    if (jogoPtr->cache.consultas > 0) {
+        printf("Cache de colocacoes: %lld acertos em %lld consultas\n", jogoPtr->cache.acertos, jogoPtr->cache.consultas);
+    }
+    if (quadroPtr->quadros > 0) {
+        printf("Quadros: %lld | %.0f bytes e %.1f celulas alteradas por quadro | tempo medio %.1f us, maximo %.1f us\n",
+               quadroPtr->quadros, (double)quadroPtr->bytes / quadroPtr->quadros,
+               (double)quadroPtr->celulasAlteradas / quadroPtr->quadros,
+               quadroPtr->somaNs / quadroPtr->quadros / 1e3, quadroPtr->maiorNs / 1e3);
+    }
+    printf("Latencia entrada->estado: %lld teclas, media %.2f us, maxima %.2f us, acima de 1 ms: %lld\n",
+           latenciaPtr->teclas, latenciaPtr->teclas > 0 ? latenciaPtr->somaNs / latenciaPtr->teclas / 1e3 : 0.0,
+           latenciaPtr->maiorNs / 1e3, latenciaPtr->acimaLimite);
+}
+
+#ifndef _WIN32
+
+/// Pedido de encerramento do tempo real (SIGTERM/SIGHUP), atendido pelo laço
+static volatile sig_atomic_t tempoRealEncerrando = 0;
+
+/**
+ * @brief Trata SIGTERM e SIGHUP pedindo o encerramento do tempo real
+ */
+static void sinalizarEncerramentoTempoReal(int sinal) {
+    (void)sinal;
+    tempoRealEncerrando = 1;
+}
+
+#endif
+
+/**
+ * @brief Executa o jogo em tempo real até o jogador sair
+ * @param logPtr Log binário das ações (NULL = desativado)
+ * @param rankingPtr Ranking que recebe a pontuação final (NULL = desativado)
+ * @return Código de saída
+ * 
+ * O terminal passa ao modo não canônico e o laço dorme em poll até a
+ * chegada de uma tecla ou o próximo passo fixo, o que vier primeiro. As
+ * teclas são aplicadas assim que chegam, os passos seguem o relógio
+ * monotônico (passos atrasados são recuperados) e um quadro só é desenhado
+ * quando o estado mudou. A latência é medida do despertar do poll até a
+ * ação ser aplicada ao estado. Com a entrada redirecionada (sem terminal)
+ * o laço funciona igual e termina no fim da entrada. SIGTERM e SIGHUP
+ * encerram o laço pelo mesmo caminho da saída normal, que restaura o
+ * terminal e registra a pontuação.
+ */
+int executarJogoTempoReal(LogJogadas* logPtr, RankingRecordes* rankingPtr, int usarCacheColocacoes) {
+#ifdef _WIN32
+    (void)logPtr;
+    (void)rankingPtr;
+    (void)usarCacheColocacoes;
+    printf("Modo tempo real indisponivel nesta plataforma.\n");
+    return 1;
+#else
+    static JogoTempoReal jogo;
+    struct termios terminalOriginal;
+    int terminalConfigurado = 0;
+    
+    if (tcgetattr(STDIN_FILENO, &terminalOriginal) == 0) {
+        struct termios terminalJogo = terminalOriginal;
+        terminalJogo.c_lflag &= ~(tcflag_t)(ICANON | ECHO | ISIG);
+        terminalJogo.c_cc[VMIN] = 0;
+        terminalJogo.c_cc[VTIME] = 0;
+        terminalConfigurado = (tcsetattr(STDIN_FILENO, TCSANOW, &terminalJogo) == 0);
+    }
+    
+    // Sem SA_RESTART: o sinal interrompe o poll e o laço vê o pedido na hora
+    struct sigaction acao, acaoTermAnterior, acaoHupAnterior;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = sinalizarEncerramentoTempoReal;
+    tempoRealEncerrando = 0;
+    sigaction(SIGTERM, &acao, &acaoTermAnterior);
+    sigaction(SIGHUP, &acao, &acaoHupAnterior);
+    
+    inicializarJogoTempoReal(&jogo, (uint64_t)time(NULL), logPtr, usarCacheColocacoes);
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;  // Mensagens do motor vão para o rodapé do quadro
+    
+    const double passoNs = PASSO_TEMPO_REAL_MS * 1e6;
+    double proximoPasso = obterTempoNanossegundos() + passoNs;
+    
+    while (!jogo.encerrado && !tempoRealEncerrando) {
+        if (jogo.alterado) {
+            desenharQuadroTempoReal(&jogo);
+            jogo.alterado = 0;
         }
         
-        // Aumentar multiplicador base (máximo 10.0)
-        if (sistemaPtr->multiplicadorAtual < 10.0) {
-            sistemaPtr->multiplicadorAtual += 0.5;
+        // Dormir até a próxima tecla ou o próximo passo (arredondado para cima)
+        double agora = obterTempoNanossegundos();
+        int esperaMs = proximoPasso > agora ? (int)((proximoPasso - agora + 999999.0) / 1e6) : 0;
+        struct pollfd entrada = {STDIN_FILENO, POLLIN, 0};
+        int prontos = poll(&entrada, 1, esperaMs);
+        if (prontos < 0 && errno != EINTR) {
+            break;
         }
         
-        // Registrar marco alcançado
-        sistemaPtr->marcosAlcancados++;
+        if (prontos > 0) {
+            double despertar = obterTempoNanossegundos();
+            unsigned char teclas[TECLAS_POR_LEITURA];
+            ssize_t lidos = read(STDIN_FILENO, teclas, sizeof(teclas));
+            if (lidos <= 0) {
+                if (lidos < 0 && (errno == EINTR || errno == EAGAIN)) {
+                    continue;
+                }
+                break;  // Fim da entrada
+            }
+            for (ssize_t i = 0; i < lidos && !jogo.encerrado; i++) {
+                processarTeclaTempoReal(&jogo, teclas[i]);
+                registrarLatencia(&jogo.latencia, obterTempoNanossegundos() - despertar);
+            }
+        }
         
-        printf("\n*** NIVEL %d ALCANCADO! ***\n", sistemaPtr->nivelAtual);
-        printf("Novo multiplicador: %.1fx\n", sistemaPtr->multiplicadorAtual);
-        printf("Fator de dificuldade: %.1f\n", sistemaPtr->fatorDificuldade);
-    } else {
-        // Atualizar pontos restantes para próximo nível
-        sistemaPtr->pontosParaProximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
+        // Passo fixo: recupera passos atrasados, mas descarta atrasos longos
+        agora = obterTempoNanossegundos();
+        for (int executados = 0; agora >= proximoPasso; executados++) {
+            if (executados == PASSOS_ATRASADOS_MAXIMO) {
+                proximoPasso = agora + passoNs;
+                break;
+            }
+            executarPassoTempoReal(&jogo);
+            proximoPasso += passoNs;
+        }
     }
     
-    // Verificar conquistas especiais
-    if (sistemaPtr->nivelAtual == 5 && !(sistemaPtr->conquistasDesbloqueadas & 1)) {
-        sistemaPtr->conquistasDesbloqueadas |= 1; // Primeira conquista
-        printf("*** CONQUISTA DESBLOQUEADA: Veterano (Nivel 5)\n");
+    encerrarQuadroTerminal(&jogo.quadro);
+    modoSilencioso = silencioAnterior;
+    if (terminalConfigurado) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminalOriginal);
     }
+    sigaction(SIGTERM, &acaoTermAnterior, NULL);
+    sigaction(SIGHUP, &acaoHupAnterior, NULL);
     
-    if (sistemaPtr->nivelAtual == 10 && !(sistemaPtr->conquistasDesbloqueadas & 2)) {
-        sistemaPtr->conquistasDesbloqueadas |= 2; // Segunda conquista
-        printf("*** CONQUISTA DESBLOQUEADA: Mestre (Nivel 10)\n");
+    exibirResumoTempoReal(&jogo);
+    if (rankingPtr != NULL) {
+        int posicao = registrarRecorde(rankingPtr, &jogo.sessao.sistema);
+        if (posicao > 0) {
+            printf("Posicao no ranking: %d de %u\n", posicao, rankingPtr->cabecalho->quantidade);
+        }
     }
+    liberarCacheColocacoes(&jogo.cache);
+    return 0;
+#endif
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+//                    SERVIDOR MULTIJOGADOR (REATOR EPOLL POR NÚCLEO)
+// ═══════════════════════════════════════════════════════════════════════════════
+
 /**
- * @brief Processa uma jogada completa no sistema Expert
- * @param peca Peça jogada
- * @param origem Origem da peça (0=fila, 1=pilha)
- * @param sistemaPtr Ponteiro para o sistema Expert
+ * @brief Aplica um comando do protocolo a uma sessão e monta a resposta
+ * @param sessaoPtr Sessão do jogador
+ * @param comando Byte recebido (ComandoServidor)
+ * @param respostaPtr Resposta a preencher
+ * @return 1 se o comando é conhecido, 0 caso contrário
+ * 
+ * As ações passam por executarAcaoHeadless, as mesmas regras do menu.
  */
-void processarJogadaExpert(Peca peca, int origem, SistemaExpert* sistemaPtr) {
-    // Cálculo da pontuação
-    int pontos = calcularPontuacao(peca.tipo, sistemaPtr);
-    
-    // Detectar combo e aplicar multiplicador
-    double multiplicadorCombo = detectarCombo(sistemaPtr, peca.tipo);
-    
-    // Aplicar multiplicador de combo à pontuação
-    pontos = (int)(pontos * multiplicadorCombo);
-    
-    // Atualização das pontuações
-    sistemaPtr->pontuacaoTotal += pontos;
-    sistemaPtr->pontuacaoNivel += pontos;
+int aplicarComandoServidor(SessaoJogo* sessaoPtr, unsigned char comando, RespostaServidor* respostaPtr) {
+    INSTRUMENTAR_INICIO(OPERACAO_COMANDO_SERVIDOR, inicio);
+    int conhecido = (comando >= COMANDO_JOGAR_FILA && comando <= COMANDO_ESTATISTICAS);
+    const SistemaExpert* sistemaPtr = &sessaoPtr->sistema;
     
-    // Atualização do recorde pessoal
-    if (sistemaPtr->pontuacaoTotal > sistemaPtr->recordePessoal) {
-        sistemaPtr->recordePessoal = sistemaPtr->pontuacaoTotal;
+    if (!conhecido) {
+        respostaPtr->aplicado = COMANDO_DESCONHECIDO;
+    } else if (comando == COMANDO_ESTATISTICAS) {
+        respostaPtr->aplicado = 1;
+    } else {
+        respostaPtr->aplicado = (uint8_t)executarAcaoHeadless(comando, sessaoPtr);
+    }
+    respostaPtr->comando = comando;
+    respostaPtr->pecasFila = (uint8_t)sessaoPtr->fila.quantidadePecas;
+    respostaPtr->pecasPilha = (uint8_t)(sessaoPtr->pilha.indiceTopo + 1);
+    respostaPtr->ultimoTipo = sistemaPtr->ultimoTipoJogado;
+    respostaPtr->nivel = (uint8_t)sistemaPtr->nivelAtual;
+    respostaPtr->combo = (uint16_t)sistemaPtr->comboAtual;
+    respostaPtr->pontuacao = sistemaPtr->pontuacaoTotal;
+    respostaPtr->jogadas = sistemaPtr->totalJogadas;
+    INSTRUMENTAR_FIM(OPERACAO_COMANDO_SERVIDOR, inicio);
+    return conhecido;
+}
+
+#ifdef __linux__
+
+/// Sinaliza a todos os shards que o servidor deve encerrar
+static volatile sig_atomic_t servidorEncerrando = 0;
+
+/// Pedido de despejo das métricas (SIGUSR1), atendido pela thread principal
+static volatile sig_atomic_t servidorDespejando = 0;
+
+/**
+ * @brief Trata SIGINT e SIGTERM pedindo o encerramento do servidor
+ */
+static void sinalizarEncerramentoServidor(int sinal) {
+    (void)sinal;
+    servidorEncerrando = 1;
+}
+
+/**
+ * @brief Trata SIGUSR1 pedindo o despejo das métricas
+ */
+static void sinalizarDespejoServidor(int sinal) {
+    (void)sinal;
+    servidorDespejando = 1;
+}
+
+/**
+ * @brief Despeja a instrumentação no arquivo de métricas ou na saída padrão
+ */
+static void despejarMetricasServidor(const ConfiguracaoServidor* configPtr) {
+    if (configPtr->arquivoMetricas == NULL || !exportarInstrumentacaoPrometheus(configPtr->arquivoMetricas)) {
+        exibirInstrumentacao();
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Eleva o limite de descritores abertos até o máximo permitido
+ * 
+ * Milhares de sessões excedem o limite brando usual (1024).
+ */
+static void ampliarLimiteDescritores(void) {
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
     }
+}
+
+/**
+ * @brief Coloca um descritor em modo não bloqueante
+ */
+static int tornarNaoBloqueante(int descritor) {
+    int flags = fcntl(descritor, F_GETFL, 0);
+    return flags >= 0 && fcntl(descritor, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Cria um socket TCP em 127.0.0.1 ou um socket Unix
+ * @param caminhoSocket Caminho do socket Unix (NULL = TCP)
+ * @param porta Porta TCP
+ * @param escutar 1 = bind + listen (servidor), 0 = connect (cliente)
+ * @return Descritor, ou -1 em caso de erro (errno preservado)
+ */
+static int abrirSocketLocal(const char* caminhoSocket, int porta, int escutar) {
+    struct sockaddr_un enderecoUnix;
+    struct sockaddr_in enderecoTcp;
+    struct sockaddr* endereco;
+    socklen_t tamanho;
     
-    // Estatísticas de origem das jogadas
-    sistemaPtr->totalJogadas++;
-    if (origem == 0) {
-        sistemaPtr->jogadasDaFila++;
+    if (caminhoSocket != NULL) {
+        memset(&enderecoUnix, 0, sizeof(enderecoUnix));
+        enderecoUnix.sun_family = AF_UNIX;
+        strncpy(enderecoUnix.sun_path, caminhoSocket, sizeof(enderecoUnix.sun_path) - 1);
+        endereco = (struct sockaddr*)&enderecoUnix;
+        tamanho = sizeof(enderecoUnix);
     } else {
-        sistemaPtr->jogadasDaPilha++;
+        memset(&enderecoTcp, 0, sizeof(enderecoTcp));
+        enderecoTcp.sin_family = AF_INET;
+        enderecoTcp.sin_port = htons((uint16_t)porta);
+        enderecoTcp.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        endereco = (struct sockaddr*)&enderecoTcp;
+        tamanho = sizeof(enderecoTcp);
     }
     
-    // Atualizar contadores de tipo de peça
-    switch(peca.tipo) {
-        case 'I': sistemaPtr->contagemTipoI++; break;
-        case 'O': sistemaPtr->contagemTipoO++; break;
-        case 'T': sistemaPtr->contagemTipoT++; break;
-        case 'L': sistemaPtr->contagemTipoL++; break;
+    int descritor = socket(endereco->sa_family, SOCK_STREAM, 0);
+    if (descritor < 0) {
+        return -1;
     }
-    
-    // Determinar tipo mais jogado
-    int maxContagem = 0;
-    if (sistemaPtr->contagemTipoI > maxContagem) {
-        maxContagem = sistemaPtr->contagemTipoI;
-        sistemaPtr->tipoMaisJogado = 'I';
+    int ligado = 1;
+    if (escutar) {
+        if (caminhoSocket != NULL) {
+            unlink(caminhoSocket);
+        } else {
+            setsockopt(descritor, SOL_SOCKET, SO_REUSEADDR, &ligado, sizeof(ligado));
+        }
+        if (bind(descritor, endereco, tamanho) != 0 || listen(descritor, SOMAXCONN) != 0) {
+            int erro = errno;
+            close(descritor);
+            errno = erro;
+            return -1;
+        }
+    } else if (connect(descritor, endereco, tamanho) != 0) {
+        int erro = errno;
+        close(descritor);
+        errno = erro;
+        return -1;
     }
-    if (sistemaPtr->contagemTipoO > maxContagem) {
-        maxContagem = sistemaPtr->contagemTipoO;
-        sistemaPtr->tipoMaisJogado = 'O';
+    if (caminhoSocket == NULL) {
+        setsockopt(descritor, IPPROTO_TCP, TCP_NODELAY, &ligado, sizeof(ligado));
     }
-    if (sistemaPtr->contagemTipoT > maxContagem) {
-        maxContagem = sistemaPtr->contagemTipoT;
-        sistemaPtr->tipoMaisJogado = 'T';
+    return descritor;
+}
+
+/**
+ * @brief Fecha uma conexão e a retira da lista do shard
+ */
+static void fecharConexaoServidor(ShardServidor* shardPtr, ConexaoServidor* conexaoPtr) {
+    close(conexaoPtr->descritor);
+    if (conexaoPtr->anterior != NULL) {
+        conexaoPtr->anterior->proxima = conexaoPtr->proxima;
+    } else {
+        shardPtr->conexoes = conexaoPtr->proxima;
     }
-    if (sistemaPtr->contagemTipoL > maxContagem) {
-        maxContagem = sistemaPtr->contagemTipoL;
-        sistemaPtr->tipoMaisJogado = 'L';
+    if (conexaoPtr->proxima != NULL) {
+        conexaoPtr->proxima->anterior = conexaoPtr->anterior;
     }
-    
-    // Calcular eficiência da reserva
-    if (sistemaPtr->totalJogadas > 0) {
-        sistemaPtr->eficienciaReserva = (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100.0;
+    liberarSessaoPool(&shardPtr->pool, &conexaoPtr->sessao);
+    shardPtr->ativas--;
+}
+
+/**
+ * @brief Aceita todas as conexões prontas no socket de escuta
+ * 
+ * Cada conexão recebe um slot do pool do shard e uma sessão nova, com
+ * semente derivada do shard e da ordem de chegada, e a fila abastecida.
+ */
+static void aceitarConexoesServidor(ShardServidor* shardPtr) {
+    for (;;) {
+        int descritor = accept(shardPtr->escuta, NULL, NULL);
+        if (descritor < 0) {
+            return;  // EAGAIN: outro shard levou a conexão, ou não há mais nenhuma
+        }
+        long long indice = shardPtr->conexoesAceitas * shardPtr->config->shards + shardPtr->indice;
+        SessaoJogo* sessaoPtr;
+        if (!tornarNaoBloqueante(descritor) ||
+            alocarSessoesPool(&shardPtr->pool, &sessaoPtr, 1, shardPtr->config->semente, indice, GERADOR_UNIFORME) != 1) {
+            close(descritor);
+            continue;
+        }
+        if (shardPtr->tcp) {
+            int ligado = 1;
+            setsockopt(descritor, IPPROTO_TCP, TCP_NODELAY, &ligado, sizeof(ligado));
+        }
+        
+        ConexaoServidor* conexaoPtr = (ConexaoServidor*)sessaoPtr;
+        conexaoPtr->descritor = descritor;
+        conexaoPtr->pendentes = 0;
+        conexaoPtr->bytesEnviados = 0;
+        conexaoPtr->aguardandoEscrita = 0;
+        gerarPecasAleatoriasSessao(&conexaoPtr->sessao);
+        
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = conexaoPtr;
+        if (epoll_ctl(shardPtr->epoll, EPOLL_CTL_ADD, descritor, &evento) != 0) {
+            liberarSessaoPool(&shardPtr->pool, sessaoPtr);
+            close(descritor);
+            continue;
+        }
+        conexaoPtr->anterior = NULL;
+        conexaoPtr->proxima = shardPtr->conexoes;
+        if (shardPtr->conexoes != NULL) {
+            shardPtr->conexoes->anterior = conexaoPtr;
+        }
+        shardPtr->conexoes = conexaoPtr;
+        shardPtr->conexoesAceitas++;
+        
+        // Contador do próprio shard: aceitar não toca em nenhuma linha compartilhada
+        if (++shardPtr->ativas > shardPtr->maiorAtivas) {
+            shardPtr->maiorAtivas = shardPtr->ativas;
+        }
     }
-    
-    // Verificação de progressão de nível
-    verificarProgressaoNivel(sistemaPtr);
 }
 
 /**
- * @brief Exibe estatísticas avançadas do sistema Expert
- * @param sistemaPtr Ponteiro para o sistema Expert
+ * @brief Envia as respostas pendentes de uma conexão
+ * @return 1 se a conexão continua aberta, 0 se foi fechada
+ * 
+ * Se o socket não aceita tudo, a leitura de comandos é suspensa (só
+ * EPOLLOUT) até o restante sair: o jogador que não lê as respostas não
+ * faz o servidor acumular memória.
  */
-void exibirEstatisticasExpert(SistemaExpert* sistemaPtr) {
-    printf("\n+==============================================================+\n");
-    printf("|                    ESTATISTICAS EXPERT                      |\n");
-    printf("+==============================================================+\n");
-    
-    // Pontuacao e Progressao
-    printf("| Pontuacao Total: %8d  |  Nivel Atual: %3d            |\n", 
-           sistemaPtr->pontuacaoTotal, sistemaPtr->nivelAtual);
-    printf("| Recorde Pessoal: %8d  |  Multiplicador: %.1fx         |\n", 
-           sistemaPtr->recordePessoal, sistemaPtr->multiplicadorAtual);
+static int enviarRespostasServidor(ShardServidor* shardPtr, ConexaoServidor* conexaoPtr) {
+    int total = conexaoPtr->pendentes * (int)sizeof(RespostaServidor);
     
-    // Progresso do nivel com barra visual
-    int progresso = (int)((double)sistemaPtr->pontuacaoTotal / sistemaPtr->limitePontosNivel * 20);
-    printf("| Progresso: [");
-    for (int i = 0; i < 20; i++) {
-        printf(i < progresso ? "#" : "-");
+    while (conexaoPtr->bytesEnviados < total) {
+        ssize_t enviados = send(conexaoPtr->descritor, (const char*)conexaoPtr->saida + conexaoPtr->bytesEnviados,
+                                (size_t)(total - conexaoPtr->bytesEnviados), MSG_NOSIGNAL);
+        if (enviados > 0) {
+            conexaoPtr->bytesEnviados += (int)enviados;
+        } else if (enviados < 0 && errno == EINTR) {
+            continue;
+        } else if (enviados < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            fecharConexaoServidor(shardPtr, conexaoPtr);
+            return 0;
+        }
     }
-    printf("] %3d%%    |\n", (int)((double)sistemaPtr->pontuacaoTotal / sistemaPtr->limitePontosNivel * 100));
-    
-    // Combos e Sequencias
-    printf("| Combo Atual: %3d      |  Melhor Combo: %3d           |\n", 
-           sistemaPtr->comboAtual, sistemaPtr->melhorCombo);
-    printf("| Sequencia: %3d        |  Ultima Peca: %c              |\n", 
-           sistemaPtr->sequenciaTipoAtual, sistemaPtr->ultimoTipoJogado);
-    
-    // Estatisticas de Tipos de Pecas
-    printf("+==============================================================+\n");
-    printf("| Tipo Mais Jogado: %c  |  Total de Jogadas: %4d        |\n", 
-           sistemaPtr->tipoMaisJogado, sistemaPtr->totalJogadas);
     
-    printf("| Tipos de Pecas:                                      |\n");
-    printf("|   I:%2d  O:%2d  T:%2d  L:%2d                        |\n", 
-           sistemaPtr->contagemTipoI, sistemaPtr->contagemTipoO, 
-           sistemaPtr->contagemTipoT, sistemaPtr->contagemTipoL);
+    int completo = (conexaoPtr->bytesEnviados == total);
+    if (completo) {
+        conexaoPtr->pendentes = 0;
+        conexaoPtr->bytesEnviados = 0;
+    }
+    if (completo == conexaoPtr->aguardandoEscrita) {
+        struct epoll_event evento;
+        evento.events = completo ? EPOLLIN : EPOLLOUT;
+        evento.data.ptr = conexaoPtr;
+        epoll_ctl(shardPtr->epoll, EPOLL_CTL_MOD, conexaoPtr->descritor, &evento);
+        conexaoPtr->aguardandoEscrita = !completo;
+    }
+    return 1;
+}
+
+/**
+ * @brief Lê os comandos disponíveis de uma conexão, aplica e responde
+ * 
+ * Lê no máximo RESPOSTAS_PENDENTES_CONEXAO bytes (um comando cada) para
+ * um buffer na pilha; as respostas vão para o buffer fixo da conexão e
+ * saem em um único send. Nada é alocado por comando.
+ */
+static void atenderConexaoServidor(ShardServidor* shardPtr, ConexaoServidor* conexaoPtr) {
+    unsigned char comandos[RESPOSTAS_PENDENTES_CONEXAO];
+    ssize_t lidos;
     
-    // Eficiencia do Jogo
-    printf("+==============================================================+\n");
-    printf("| Jogadas da Fila: %4d   |  Jogadas da Pilha: %4d      |\n", 
-           sistemaPtr->jogadasDaFila, sistemaPtr->jogadasDaPilha);
+    do {
+        lidos = recv(conexaoPtr->descritor, comandos, (size_t)(RESPOSTAS_PENDENTES_CONEXAO - conexaoPtr->pendentes), 0);
+    } while (lidos < 0 && errno == EINTR);
+    if (lidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+    }
+    if (lidos <= 0) {
+        fecharConexaoServidor(shardPtr, conexaoPtr);
+        return;
+    }
     
-    // Eficiencia da reserva com barra visual
-    int eficiencia = (int)(sistemaPtr->eficienciaReserva / 5); // Escala para 20 caracteres
-    printf("| Eficiencia Reserva: [");
-    for (int i = 0; i < 20; i++) {
-        printf(i < eficiencia ? "#" : "-");
+    for (ssize_t i = 0; i < lidos; i++) {
+        if (!aplicarComandoServidor(&conexaoPtr->sessao, comandos[i], &conexaoPtr->saida[conexaoPtr->pendentes++])) {
+            shardPtr->comandosInvalidos++;
+        }
     }
-    printf("] %5.1f%% |\n", (double)sistemaPtr->eficienciaReserva);
+    shardPtr->comandos += lidos;
+    enviarRespostasServidor(shardPtr, conexaoPtr);
+}
+
+/**
+ * @brief Laço do reator de um shard
+ * @param argumento ShardServidor
+ * 
+ * O ponteiro de cada evento é a própria conexão (NULL = socket de
+ * escuta), então o despacho não consulta nenhuma tabela.
+ */
+static void* executarShardServidor(void* argumento) {
+    ShardServidor* shardPtr = argumento;
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
     
-    // Conquistas e Marcos
-    printf("| Marcos Alcancados: %2d  |  Fator Dificuldade: %.1fx      |\n", 
-           sistemaPtr->marcosAlcancados, sistemaPtr->fatorDificuldade);
+    while (!servidorEncerrando) {
+        int prontos = epoll_wait(shardPtr->epoll, eventos, EVENTOS_POR_ESPERA, 100);
+        for (int i = 0; i < prontos; i++) {
+            ConexaoServidor* conexaoPtr = eventos[i].data.ptr;
+            if (conexaoPtr == NULL) {
+                aceitarConexoesServidor(shardPtr);
+            } else if (eventos[i].events & EPOLLOUT) {
+                enviarRespostasServidor(shardPtr, conexaoPtr);
+            } else if (eventos[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                atenderConexaoServidor(shardPtr, conexaoPtr);
+            }
+        }
+    }
     
-    printf("+==============================================================+\n");
+    while (shardPtr->conexoes != NULL) {
+        fecharConexaoServidor(shardPtr, shardPtr->conexoes);
+    }
+    return NULL;
 }
 
+#endif
+
 /**
- * @brief Otimiza e valida o sistema Expert
- * @param sistemaPtr Ponteiro para o sistema Expert
- * @return 1 se otimização foi aplicada, 0 caso contrário
+ * @brief Executa o servidor multijogador até SIGINT/SIGTERM ou o fim da duração
+ * @param configPtr Configuração do servidor
+ * @return 0 em caso de sucesso, 1 se o socket não pôde ser aberto
+ * 
+ * Um shard por núcleo, cada um com seu epoll e suas conexões. Cada
+ * conexão é um jogador com fila, pilha e sistema Expert próprios.
  */
-int otimizarSistemaExpert(SistemaExpert* sistemaPtr) {
-    int otimizacaoAplicada = 0;
-    
-    // Validação e correção de valores inconsistentes
-    if (sistemaPtr->multiplicadorAtual > 10.0) {
-        sistemaPtr->multiplicadorAtual = 10.0;
-        otimizacaoAplicada = 1;
+int executarServidor(const ConfiguracaoServidor* configPtr) {
+#ifndef __linux__
+    (void)configPtr;
+    printf("Servidor multijogador indisponivel nesta plataforma (requer epoll).\n");
+    return 1;
+#else
+    ampliarLimiteDescritores();
+    int escuta = abrirSocketLocal(configPtr->caminhoSocket, configPtr->porta, 1);
+    if (escuta < 0 || !tornarNaoBloqueante(escuta)) {
+        printf("Nao foi possivel escutar em %s: %s\n",
+               configPtr->caminhoSocket != NULL ? configPtr->caminhoSocket : "127.0.0.1", strerror(errno));
+        if (escuta >= 0) {
+            close(escuta);
+        }
+        return 1;
     }
     
-    if (sistemaPtr->multiplicadorAtual < 1.0) {
-        sistemaPtr->multiplicadorAtual = 1.0;
-        otimizacaoAplicada = 1;
+    ShardServidor* shards = NULL;
+    if (posix_memalign((void**)&shards, 64, (size_t)configPtr->shards * sizeof(ShardServidor)) != 0) {
+        printf("Memoria insuficiente para os shards do servidor.\n");
+        close(escuta);
+        return 1;
     }
+    memset(shards, 0, (size_t)configPtr->shards * sizeof(ShardServidor));
     
-    // Recálculo da eficiência se necessário
-    if (sistemaPtr->totalJogadas > 0) {
-        double novaEficiencia = (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100.0;
-        if (abs((int)(novaEficiencia - sistemaPtr->eficienciaReserva)) > 1) {
-            sistemaPtr->eficienciaReserva = novaEficiencia;
-            otimizacaoAplicada = 1;
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = sinalizarEncerramentoServidor;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    acao.sa_handler = sinalizarDespejoServidor;
+    sigaction(SIGUSR1, &acao, NULL);
+    int silencioAnterior = modoSilencioso;
+    modoSilencioso = 1;
+    servidorEncerrando = 0;
+    
+    // EPOLLEXCLUSIVE acorda um único shard por conexão nova
+    uint32_t eventosEscuta = EPOLLIN;
+#ifdef EPOLLEXCLUSIVE
+    eventosEscuta |= EPOLLEXCLUSIVE;
+#endif
+    int iniciados = 0;
+    for (int s = 0; s < configPtr->shards; s++) {
+        ShardServidor* shardPtr = &shards[s];
+        shardPtr->indice = s;
+        shardPtr->escuta = escuta;
+        shardPtr->tcp = (configPtr->caminhoSocket == NULL);
+        shardPtr->config = configPtr;
+        inicializarPoolSessoes(&shardPtr->pool, sizeof(ConexaoServidor));
+        shardPtr->epoll = epoll_create1(0);
+        
+        struct epoll_event evento;
+        evento.events = eventosEscuta;
+        evento.data.ptr = NULL;
+        if (shardPtr->epoll < 0 || epoll_ctl(shardPtr->epoll, EPOLL_CTL_ADD, escuta, &evento) != 0 ||
+            pthread_create(&shardPtr->thread, NULL, executarShardServidor, shardPtr) != 0) {
+            if (shardPtr->epoll >= 0) {
+                close(shardPtr->epoll);
+            }
+            break;
+        }
+        iniciados++;
+    }
+    
+    if (configPtr->caminhoSocket != NULL) {
+        printf("Servidor escutando em %s com %d shards\n", configPtr->caminhoSocket, iniciados);
+    } else {
+        printf("Servidor escutando em 127.0.0.1:%d com %d shards\n", configPtr->porta, iniciados);
+    }
+    fflush(stdout);
+    
+    double inicio = obterTempoNanossegundos();
+    while (!servidorEncerrando && iniciados > 0 &&
+           (configPtr->duracao <= 0 || obterTempoNanossegundos() - inicio < configPtr->duracao * 1e9)) {
+        struct timespec espera = {0, 50 * 1000000L};
+        nanosleep(&espera, NULL);
+        if (servidorDespejando) {
+            servidorDespejando = 0;
+            despejarMetricasServidor(configPtr);
         }
     }
+    servidorEncerrando = 1;
     
-    // Ajuste automático da dificuldade baseado no desempenho
-    if (sistemaPtr->nivelAtual > 5 && sistemaPtr->fatorDificuldade < 2.0) {
-        sistemaPtr->fatorDificuldade = 1.0 + (sistemaPtr->nivelAtual - 1) * 0.2;
-        otimizacaoAplicada = 1;
+    ShardServidor total;
+    memset(&total, 0, sizeof(total));
+    inicializarPoolSessoes(&total.pool, sizeof(ConexaoServidor));
+    for (int s = 0; s < iniciados; s++) {
+        pthread_join(shards[s].thread, NULL);
+        close(shards[s].epoll);
+        total.conexoesAceitas += shards[s].conexoesAceitas;
+        total.comandos += shards[s].comandos;
+        total.comandosInvalidos += shards[s].comandosInvalidos;
+        // Cada shard conta as próprias conexões; o máximo é a soma dos picos
+        total.maiorAtivas += shards[s].maiorAtivas;
+        // Ocupação somada dos pools (o pico é a soma dos picos de cada shard)
+        total.pool.lajesAlocadas += shards[s].pool.lajesAlocadas;
+        total.pool.emUso += shards[s].pool.emUso;
+        total.pool.maiorEmUso += shards[s].pool.maiorEmUso;
+        total.pool.alocacoes += shards[s].pool.alocacoes;
+        total.pool.liberacoes += shards[s].pool.liberacoes;
+        liberarPoolSessoes(&shards[s].pool);
+    }
+    double segundos = (obterTempoNanossegundos() - inicio) / 1e9;
+    close(escuta);
+    if (configPtr->caminhoSocket != NULL) {
+        unlink(configPtr->caminhoSocket);
     }
+    free(shards);
+    modoSilencioso = silencioAnterior;
     
-    return otimizacaoAplicada;
+    printf("\n*** SERVIDOR ENCERRADO:\n");
+    printf("   * Shards: %d  |  Conexoes aceitas: %lld  |  Maximo simultaneo (soma dos shards): %lld\n",
+           iniciados, total.conexoesAceitas, total.maiorAtivas);
+    printf("   * Comandos: %lld (desconhecidos: %lld)  |  Tempo: %.1f s  |  Vazao: %.0f comandos/s\n",
+           total.comandos, total.comandosInvalidos, segundos, segundos > 0 ? total.comandos / segundos : 0.0);
+    exibirOcupacaoPool(&total.pool);
+    if (configPtr->arquivoMetricas != NULL) {
+        exibirInstrumentacao();
+        despejarMetricasServidor(configPtr);
+    }
+    return iniciados > 0 ? 0 : 1;
+#endif
 }
 
 /**
- * @brief Gera relatório detalhado do sistema Expert
- * @param sistemaPtr Ponteiro para o sistema Expert
+ * @brief Interpreta os argumentos de linha de comando do modo --servidor
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos
+ * @param configPtr Configuração a ser preenchida
+ * @return 1 se os argumentos são válidos, 0 caso contrário
+ * 
+ * Opções aceitas (após --servidor):
+ * - --socket CAMINHO   Socket Unix (padrão SOCKET_SERVIDOR_PADRAO)
+ * - --porta N          Usa TCP em 127.0.0.1:N em vez do socket Unix
+ * - --shards N         Threads do reator; 0 usa todos os núcleos (padrão 0)
+ * - --semente N        Semente base das sessões (padrão 1)
+ * - --duracao S        Encerra após S segundos (padrão 0 = até SIGINT/SIGTERM)
+ * - --metricas ARQ     Grava a instrumentação em ARQ (Prometheus) a cada SIGUSR1 e no
+ *                      encerramento; sem a opção, SIGUSR1 a exibe na saída padrão
  */
-void gerarRelatorioExpert(SistemaExpert* sistemaPtr) {
-    printf("\n+==============================================================+\n");
-    printf("|                     RELATORIO EXPERT                        |\n");
-    printf("+==============================================================+\n");
-    
-    // Analise de Performance
-    printf("\n*** ANALISE DE PERFORMANCE:\n");
-    printf("   * Pontuacao Media por Jogada: %.1f\n", 
-           sistemaPtr->totalJogadas > 0 ? (double)sistemaPtr->pontuacaoTotal / sistemaPtr->totalJogadas : 0);
-    printf("   * Taxa de Uso da Reserva: %.1f%%\n", 
-           sistemaPtr->totalJogadas > 0 ? (double)sistemaPtr->jogadasDaPilha / sistemaPtr->totalJogadas * 100 : 0);
-    printf("   * Progressao de Nivel: %d niveis alcancados\n", sistemaPtr->nivelAtual - 1);
+int interpretarArgumentosServidor(int argc, char* argv[], ConfiguracaoServidor* configPtr) {
+    configPtr->caminhoSocket = SOCKET_SERVIDOR_PADRAO;
+    configPtr->porta = 0;
+    configPtr->shards = 0;
+    configPtr->semente = 1;
+    configPtr->duracao = 0;
+    configPtr->arquivoMetricas = NULL;
     
-    // Recomendacoes Estrategicas
-    printf("\n*** RECOMENDACOES ESTRATEGICAS:\n");
-    if (sistemaPtr->eficienciaReserva < 20) {
-        printf("   * Utilize mais a pilha de reserva para melhor estrategia\n");
-    }
-    if (sistemaPtr->melhorCombo < 5) {
-        printf("   * Foque em formar combos de pecas consecutivas\n");
-    }
-    if (sistemaPtr->sequenciaTipoAtual < 3) {
-        printf("   * Mantenha sequencias longas para maximizar multiplicadores\n");
+    for (int i = 2; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (valor == NULL) {
+            printf("Opcao %s sem valor.\n", opcao);
+            return 0;
+        }
+        
+        if (strcmp(opcao, "--socket") == 0) {
+            configPtr->caminhoSocket = valor;
+        } else if (strcmp(opcao, "--porta") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, 65535, &configPtr->porta)) {
+                return 0;
+            }
+            configPtr->caminhoSocket = NULL;
+        } else if (strcmp(opcao, "--shards") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 0, INT_MAX, &configPtr->shards)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--semente") == 0) {
+            long long semente;
+            if (!lerInteiroLongoOpcao(opcao, valor, 0, UINT_MAX, &semente)) {
+                return 0;
+            }
+            configPtr->semente = (unsigned int)semente;
+        } else if (strcmp(opcao, "--duracao") == 0) {
+            if (!lerRealOpcao(opcao, valor, 0.0, 1e9, &configPtr->duracao)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--metricas") == 0) {
+            configPtr->arquivoMetricas = valor;
+        } else {
+            printf("Opcao desconhecida: %s\n", opcao);
+            return 0;
+        }
+        i++;
     }
     
-    // Projecoes de Melhoria
-    printf("\n*** PROJECOES DE MELHORIA:\n");
-    int proximoNivel = sistemaPtr->limitePontosNivel - sistemaPtr->pontuacaoTotal;
-    printf("   * Pontos para proximo nivel: %d\n", proximoNivel);
-    printf("   * Potencial de pontuacao com combo maximo: %d\n", 
-           sistemaPtr->pontuacaoTotal + (sistemaPtr->melhorCombo * 100));
-    printf("   * Eficiencia otima da reserva: 40-60%%\n");
+    if (configPtr->shards <= 0) {
+        configPtr->shards = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    return 1;
 }
 
-/**
- * @brief Cria uma nova peça
- * @param tipo Tipo da peça
- * @param id ID da peça
- * @return Nova peça criada
- */
-Peca criarPeca(char tipo, int id) {
-    Peca novaPeca;
-    novaPeca.tipo = tipo;
-    novaPeca.id = id;
-    return novaPeca;
-}
+// ═══════════════════════════════════════════════════════════════════════════════
+//                        GERADOR DE CARGA DO SERVIDOR
+// ═══════════════════════════════════════════════════════════════════════════════
 
-/**
- * @brief Gera peças aleatórias para a fila
- * @param filaPtr Ponteiro para a fila
- */
-void gerarPecasAleatorias(FilaCircular* filaPtr) {
-    char tipos[] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
-    for (int i = 0; i < 5; i++) {
-        char tipoAleatorio = tipos[rand() % 7];
-        Peca novaPeca = criarPeca(tipoAleatorio, proximoId++);
-        inserirPecaNaFila(filaPtr, novaPeca);
-    }
-}
+#ifdef __linux__
+
+/// Roteiro de comandos repetido por cada sessão do gerador de carga
+static const unsigned char roteiroCarga[] = {
+    COMANDO_JOGAR_FILA, COMANDO_JOGAR_FILA, COMANDO_RESERVAR, COMANDO_JOGAR_FILA,
+    COMANDO_JOGAR_PILHA, COMANDO_GERAR, COMANDO_ESTATISTICAS
+};
 
 /**
- * @brief Transfere uma peça da fila para a pilha
- * @param filaPtr Ponteiro para a fila
- * @param pilhaPtr Ponteiro para a pilha
+ * @brief Envia o próximo comando do roteiro de uma sessão
+ * @return 1 se enviado, 0 se a conexão falhou
  */
-void transferirPecaFilaParaPilha(FilaCircular* filaPtr, PilhaReserva* pilhaPtr) {
-    if (!filaVazia(filaPtr) && !pilhaCheia(pilhaPtr)) {
-        Peca peca = jogarPecaDaFila(filaPtr);
-        reservarPeca(pilhaPtr, peca);
-        printf("Peca %c transferida da fila para a pilha de reserva.\n", peca.tipo);
-    }
+static int enviarComandoCarga(SessaoCarga* sessaoPtr) {
+    unsigned char comando = roteiroCarga[sessaoPtr->passo++ % sizeof(roteiroCarga)];
+    sessaoPtr->enviadoNs = obterTempoNanossegundos();
+    sessaoPtr->emVoo = 1;
+    sessaoPtr->recebidos = 0;
+    return send(sessaoPtr->descritor, &comando, 1, MSG_NOSIGNAL) == 1;
 }
 
 /**
- * @brief Exibe o estado completo do sistema
- * @param filaPtr Ponteiro para a fila
- * @param pilhaPtr Ponteiro para a pilha
- * @param sistemaPtr Ponteiro para o sistema Expert
+ * @brief Thread do gerador: mantém emVoo comandos pendentes em sessões alternadas
+ * @param argumento TrabalhadorCarga
+ * 
+ * Cada resposta completa registra a latência do comando e dispara o
+ * próximo na sessão seguinte do rodízio que não tenha comando em voo,
+ * de modo que todas as sessões são exercitadas.
  */
-void exibirEstadoCompleto(FilaCircular* filaPtr, PilhaReserva* pilhaPtr, SistemaExpert* sistemaPtr) {
-    printf("\n===============================================================\n");
-    printf("                    ESTADO ATUAL DO SISTEMA\n");
-    printf("===============================================================\n");
+static void* executarTrabalhadorCarga(void* argumento) {
+    TrabalhadorCarga* trabalhadorPtr = argumento;
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    int epoll = epoll_create1(0);
+    if (epoll < 0) {
+        trabalhadorPtr->falhou = 1;
+        return NULL;
+    }
+    
+    for (int i = 0; i < trabalhadorPtr->quantidade; i++) {
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = &trabalhadorPtr->sessoes[i];
+        epoll_ctl(epoll, EPOLL_CTL_ADD, trabalhadorPtr->sessoes[i].descritor, &evento);
+    }
     
-    exibirFila(filaPtr);
-    exibirPilha(pilhaPtr);
-    exibirEstatisticasExpert(sistemaPtr);
+    long long enviados = 0;
+    int cursor = 0;
+    for (; enviados < trabalhadorPtr->emVoo && enviados < trabalhadorPtr->comandos; enviados++) {
+        if (!enviarComandoCarga(&trabalhadorPtr->sessoes[cursor])) {
+            trabalhadorPtr->falhou = 1;
+        }
+        cursor = (cursor + 1) % trabalhadorPtr->quantidade;
+    }
+    
+    while (trabalhadorPtr->medidos < trabalhadorPtr->comandos && !trabalhadorPtr->falhou) {
+        int prontos = epoll_wait(epoll, eventos, EVENTOS_POR_ESPERA, 2000);
+        if (prontos == 0) {
+            trabalhadorPtr->falhou = 1;  // Servidor parou de responder
+        }
+        for (int i = 0; i < prontos; i++) {
+            SessaoCarga* sessaoPtr = eventos[i].data.ptr;
+            ssize_t lidos = recv(sessaoPtr->descritor, (char*)&sessaoPtr->resposta + sessaoPtr->recebidos,
+                                 sizeof(RespostaServidor) - (size_t)sessaoPtr->recebidos, 0);
+            if (lidos <= 0) {
+                if (lidos < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    continue;
+                }
+                trabalhadorPtr->falhou = 1;
+                break;
+            }
+            sessaoPtr->recebidos += (int)lidos;
+            if (sessaoPtr->recebidos < (int)sizeof(RespostaServidor)) {
+                continue;
+            }
+            
+            trabalhadorPtr->latencias[trabalhadorPtr->medidos++] = obterTempoNanossegundos() - sessaoPtr->enviadoNs;
+            trabalhadorPtr->respostasInvalidas += (sessaoPtr->resposta.aplicado == COMANDO_DESCONHECIDO);
+            sessaoPtr->emVoo = 0;
+            if (enviados < trabalhadorPtr->comandos) {
+                while (trabalhadorPtr->sessoes[cursor].emVoo) {
+                    cursor = (cursor + 1) % trabalhadorPtr->quantidade;
+                }
+                if (!enviarComandoCarga(&trabalhadorPtr->sessoes[cursor])) {
+                    trabalhadorPtr->falhou = 1;
+                }
+                cursor = (cursor + 1) % trabalhadorPtr->quantidade;
+                enviados++;
+            }
+        }
+    }
+    close(epoll);
+    return NULL;
 }
 
+#endif
+
 /**
- * @brief Exibe o menu principal
+ * @brief Abre as sessões, dispara os comandos e verifica a meta de latência
+ * @param configPtr Configuração da carga
+ * @return 0 se todos os comandos foram respondidos dentro da meta de p99, 1 caso contrário
+ * 
+ * A latência é medida do envio do comando ao último byte da resposta,
+ * com todas as sessões conectadas ao mesmo tempo. O p99 é comparado com
+ * LIMITE_P99_SERVIDOR_NS.
  */
-void exibirMenu() {
-    printf("\n+==============================================================+\n");
-    printf("|                    TETRIS EXPERT SYSTEM                     |\n");
-    printf("+==============================================================+\n");
-    printf("| 1. Jogar peca da fila                                       |\n");
-    printf("| 2. Jogar peca da pilha de reserva                           |\n");
-    printf("| 3. Transferir peca da fila para reserva                     |\n");
-    printf("| 4. Gerar novas pecas aleatorias                             |\n");
-    printf("| 5. Exibir estado completo                                   |\n");
-    printf("| 6. Exibir estatisticas Expert                               |\n");
-    printf("| 7. Otimizar sistema Expert                                  |\n");
-    printf("| 8. Gerar relatorio Expert                                   |\n");
-    printf("| 0. Sair                                                     |\n");
-    printf("+==============================================================+\n");
-    printf("Escolha uma opcao: ");
+int executarCarga(const ConfiguracaoCarga* configPtr) {
+#ifndef __linux__
+    (void)configPtr;
+    printf("Gerador de carga indisponivel nesta plataforma (requer epoll).\n");
+    return 1;
+#else
+    ampliarLimiteDescritores();
+    SessaoCarga* sessoes = calloc((size_t)configPtr->sessoes, sizeof(SessaoCarga));
+    TrabalhadorCarga* trabalhadores = calloc((size_t)configPtr->threads, sizeof(TrabalhadorCarga));
+    double* latencias = malloc((size_t)configPtr->comandos * sizeof(double));
+    if (sessoes == NULL || trabalhadores == NULL || latencias == NULL) {
+        printf("Memoria insuficiente para o gerador de carga.\n");
+        free(sessoes);
+        free(trabalhadores);
+        free(latencias);
+        return 1;
+    }
+    
+    // Todas as sessões são abertas antes da medição
+    double inicioConexao = obterTempoNanossegundos();
+    int conectadas = 0;
+    for (; conectadas < configPtr->sessoes; conectadas++) {
+        int descritor = abrirSocketLocal(configPtr->caminhoSocket, configPtr->porta, 0);
+        if (descritor < 0 || !tornarNaoBloqueante(descritor)) {
+            printf("Falha ao conectar a sessao %d: %s\n", conectadas + 1, strerror(errno));
+            break;
+        }
+        sessoes[conectadas].descritor = descritor;
+    }
+    double segundosConexao = (obterTempoNanossegundos() - inicioConexao) / 1e9;
+    
+    int codigo = 1;
+    if (conectadas == configPtr->sessoes) {
+        long long distribuidos = 0;
+        int sessoesDistribuidas = 0;
+        for (int t = 0; t < configPtr->threads; t++) {
+            TrabalhadorCarga* trabalhadorPtr = &trabalhadores[t];
+            trabalhadorPtr->config = configPtr;
+            trabalhadorPtr->sessoes = sessoes + sessoesDistribuidas;
+            trabalhadorPtr->quantidade = configPtr->sessoes / configPtr->threads + (t < configPtr->sessoes % configPtr->threads);
+            trabalhadorPtr->comandos = configPtr->comandos / configPtr->threads + (t < configPtr->comandos % configPtr->threads);
+            trabalhadorPtr->emVoo = configPtr->emVoo / configPtr->threads + (t < configPtr->emVoo % configPtr->threads);
+            if (trabalhadorPtr->emVoo < 1) {
+                trabalhadorPtr->emVoo = 1;
+            }
+            if (trabalhadorPtr->emVoo > trabalhadorPtr->quantidade) {
+                trabalhadorPtr->emVoo = trabalhadorPtr->quantidade;
+            }
+            trabalhadorPtr->latencias = latencias + distribuidos;
+            sessoesDistribuidas += trabalhadorPtr->quantidade;
+            distribuidos += trabalhadorPtr->comandos;
+        }
+        
+        double inicio = obterTempoNanossegundos();
+        for (int t = 0; t < configPtr->threads; t++) {
+            trabalhadores[t].emThread = (pthread_create(&trabalhadores[t].thread, NULL, executarTrabalhadorCarga,
+                                                        &trabalhadores[t]) == 0);
+            if (!trabalhadores[t].emThread) {
+                // Sem thread disponível: estas sessões são exercitadas pela chamadora
+                executarTrabalhadorCarga(&trabalhadores[t]);
+            }
+        }
+        long long medidos = 0;
+        long long invalidas = 0;
+        int falhou = 0;
+        int metaAtingida = 0;
+        for (int t = 0; t < configPtr->threads; t++) {
+            if (trabalhadores[t].emThread) {
+                pthread_join(trabalhadores[t].thread, NULL);
+            }
+            falhou |= trabalhadores[t].falhou;
+            invalidas += trabalhadores[t].respostasInvalidas;
+            // Compacta as latências de cada thread em sequência
+            memmove(latencias + medidos, trabalhadores[t].latencias, (size_t)trabalhadores[t].medidos * sizeof(double));
+            medidos += trabalhadores[t].medidos;
+        }
+        double segundos = (obterTempoNanossegundos() - inicio) / 1e9;
+        
+        printf("*** GERADOR DE CARGA:\n");
+        printf("   * Sessoes: %d (conectadas em %.2f s)  |  Threads: %d  |  Comandos em voo: %d\n",
+               conectadas, segundosConexao, configPtr->threads, configPtr->emVoo);
+        printf("   * Comandos respondidos: %lld de %lld em %.2f s  |  Vazao: %.0f comandos/s\n",
+               medidos, configPtr->comandos, segundos, segundos > 0 ? medidos / segundos : 0.0);
+        if (medidos > 0) {
+            qsort(latencias, (size_t)medidos, sizeof(double), compararDoubles);
+            double p99 = latencias[(medidos - 1) * 99 / 100];
+            metaAtingida = p99 < LIMITE_P99_SERVIDOR_NS;
+            printf("   * Latencia: p50 %.1f us  |  p90 %.1f us  |  p99 %.1f us  |  p99.9 %.1f us  |  maxima %.1f us\n",
+                   latencias[(medidos - 1) / 2] / 1e3, latencias[(medidos - 1) * 9 / 10] / 1e3, p99 / 1e3,
+                   latencias[(medidos - 1) * 999 / 1000] / 1e3, latencias[medidos - 1] / 1e3);
+            printf("   * Meta p99 < %.0f us: %s\n", LIMITE_P99_SERVIDOR_NS / 1e3,
+                   metaAtingida ? "atingida" : "NAO atingida");
+        }
+        if (invalidas > 0) {
+            printf("   * Respostas a comandos desconhecidos: %lld\n", invalidas);
+        }
+        if (falhou) {
+            printf("   * O servidor fechou uma conexao ou parou de responder.\n");
+        }
+        codigo = (falhou || medidos < configPtr->comandos || !metaAtingida) ? 1 : 0;
+    }
+    
+    for (int i = 0; i < conectadas; i++) {
+        close(sessoes[i].descritor);
+    }
+    free(sessoes);
+    free(trabalhadores);
+    free(latencias);
+    return codigo;
+#endif
 }
 
 /**
- * @brief Pausa a execução aguardando entrada do usuário
+ * @brief Interpreta os argumentos de linha de comando do modo --carga
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos
+ * @param configPtr Configuração a ser preenchida
+ * @return 1 se os argumentos são válidos, 0 caso contrário
+ * 
+ * Opções aceitas (após --carga):
+ * - --socket CAMINHO   Socket Unix do servidor (padrão SOCKET_SERVIDOR_PADRAO)
+ * - --porta N          Conecta por TCP em 127.0.0.1:N
+ * - --sessoes N        Conexões simultâneas (padrão 10000)
+ * - --comandos N       Comandos medidos (padrão 200000)
+ * - --em-voo N         Comandos aguardando resposta ao mesmo tempo (padrão 1: latência pura)
+ * - --threads N        Threads geradoras (padrão 1)
  */
-void pausarExecucao() {
-    printf("\nPressione Enter para continuar...");
-    getchar();
+int interpretarArgumentosCarga(int argc, char* argv[], ConfiguracaoCarga* configPtr) {
+    configPtr->caminhoSocket = SOCKET_SERVIDOR_PADRAO;
+    configPtr->porta = 0;
+    configPtr->sessoes = 10000;
+    configPtr->comandos = 200000;
+    configPtr->emVoo = 1;
+    configPtr->threads = 1;
+    
+    for (int i = 2; i < argc; i++) {
+        const char* opcao = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (valor == NULL) {
+            printf("Opcao %s sem valor.\n", opcao);
+            return 0;
+        }
+        
+        if (strcmp(opcao, "--socket") == 0) {
+            configPtr->caminhoSocket = valor;
+        } else if (strcmp(opcao, "--porta") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, 65535, &configPtr->porta)) {
+                return 0;
+            }
+            configPtr->caminhoSocket = NULL;
+        } else if (strcmp(opcao, "--sessoes") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->sessoes)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--comandos") == 0) {
+            if (!lerInteiroLongoOpcao(opcao, valor, 1, LLONG_MAX, &configPtr->comandos)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--em-voo") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->emVoo)) {
+                return 0;
+            }
+        } else if (strcmp(opcao, "--threads") == 0) {
+            if (!lerInteiroOpcao(opcao, valor, 1, INT_MAX, &configPtr->threads)) {
+                return 0;
+            }
+        } else {
+            printf("Opcao desconhecida: %s\n", opcao);
+            return 0;
+        }
+        i++;
+    }
+    
+    if (configPtr->threads > configPtr->sessoes) {
+        printf("Threads nao podem exceder as sessoes.\n");
+        return 0;
+    }
+    return 1;
 }
 
 /**
  * @brief Função principal do programa
+ * @param argc Quantidade de argumentos
+ * @param argv Vetor de argumentos ("--simular", "--balanceamento", "--benchmark", "--replay" e "--ranking"
+ *             ativam os modos não interativos; "--tempo-real" inicia o jogo com gravidade; "--servidor" atende jogadores
+ *             por socket e "--carga" o exercita; "--gravar ARQ" grava o jogo interativo no log binário ARQ,
+ *             "--recordes ARQ" registra o resultado no ranking ARQ e "--alimentador" sorteia as peças do
+ *             jogo interativo em uma thread produtora)
  * @return Código de saída
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // Modo headless: executa a simulação e emite apenas o resumo final
+    if (argc > 1 && strcmp(argv[1], "--simular") == 0) {
+        ConfiguracaoSimulacao config;
+        ResultadoSimulacao resultado;
+        static LogJogadas log;
+        static RankingRecordes ranking;
+        
+        if (!interpretarArgumentosSimulacao(argc, argv, &config)) {
+            return 1;
+        }
+        if (config.arquivoLog != NULL) {
+            if (!abrirLogJogadas(&log, config.arquivoLog)) {
+                return 1;
+            }
+            config.log = &log;
+        }
+        if (config.arquivoRanking != NULL) {
+            if (!abrirRanking(&ranking, config.arquivoRanking, CAPACIDADE_RANKING_PADRAO)) {
+                return 1;
+            }
+            config.ranking = &ranking;
+        }
+        executarSimulacaoHeadless(&config, &resultado);
+        if (config.log != NULL) {
+            fecharLogJogadas(config.log);
+        }
+        exibirResumoSimulacao(&config, &resultado);
+        if (config.ranking != NULL) {
+            exibirRanking(config.ranking, 5);
+            fecharRanking(config.ranking);
+        }
+        if (config.arquivoMetricas != NULL) {
+            exibirInstrumentacao();
+            if (exportarInstrumentacaoPrometheus(config.arquivoMetricas)) {
+                printf("Metricas gravadas em %s\n", config.arquivoMetricas);
+            }
+        }
+        return 0;
+    }
+    
+    // Modo balanceamento: distribuições de pontuação, nível e combo sob regras alternativas
+    if (argc > 1 && strcmp(argv[1], "--balanceamento") == 0) {
+        ConfiguracaoSimulacao config;
+        RegrasPontuacao regras;
+        ResultadoSimulacao resultado;
+        
+        if (!interpretarArgumentosBalanceamento(argc, argv, &config, &regras)) {
+            return 1;
+        }
+        config.pontuacoesBalanceamento = malloc((size_t)config.totalPartidas * sizeof(long long));
+        if (config.pontuacoesBalanceamento == NULL) {
+            printf("Memoria insuficiente para %lld partidas.\n", config.totalPartidas);
+            return 1;
+        }
+        executarSimulacaoHeadless(&config, &resultado);
+        exibirAnaliseBalanceamento(&config, &regras, &resultado);
+        free(config.pontuacoesBalanceamento);
+        return resultado.divergencias == 0 ? 0 : 1;
+    }
+    
+    // Modo ranking: exibe os melhores recordes de um arquivo de ranking
+    // (--ranking ARQ [--top K] [--posicao PONTOS])
+    if (argc > 2 && strcmp(argv[1], "--ranking") == 0) {
+        RankingRecordes ranking;
+        int quantidade = 10;
+        int pontuacao = 0;
+        int consultarPosicao = 0;
+        
+        for (int i = 3; i < argc; i++) {
+            if (i + 1 >= argc) {
+                printf("Opcao %s sem valor.\n", argv[i]);
+                return 1;
+            }
+            if (strcmp(argv[i], "--top") == 0) {
+                if (!lerInteiroOpcao(argv[i], argv[i + 1], 1, INT_MAX, &quantidade)) {
+                    return 1;
+                }
+                i++;
+            } else if (strcmp(argv[i], "--posicao") == 0) {
+                if (!lerInteiroOpcao(argv[i], argv[i + 1], INT_MIN, INT_MAX, &pontuacao)) {
+                    return 1;
+                }
+                consultarPosicao = 1;
+                i++;
+            } else {
+                printf("Opcao desconhecida: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        if (!abrirRanking(&ranking, argv[2], CAPACIDADE_RANKING_PADRAO)) {
+            return 1;
+        }
+        if (consultarPosicao) {
+            printf("Pontuacao %d ficaria na posicao %d de %u recordes\n", pontuacao,
+                   posicaoNoRanking(&ranking, pontuacao), ranking.cabecalho->quantidade);
+        } else {
+            exibirRanking(&ranking, quantidade);
+        }
+        fecharRanking(&ranking);
+        return 0;
+    }
+    
+    // Modo replay: reproduz um log binário pelo motor de pontuação
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        ResultadoReplay resultado;
+        long long sessaoDetalhada = -1;
+        
+        if (argc > 4 && strcmp(argv[3], "--sessao") == 0 &&
+            !lerInteiroLongoOpcao(argv[3], argv[4], 0, LLONG_MAX, &sessaoDetalhada)) {
+            return 1;
+        }
+        if (!reproduzirLogJogadas(argv[2], sessaoDetalhada, &resultado)) {
+            return 1;
+        }
+        exibirResumoReplay(argv[2], &resultado);
+        return (resultado.registrosInvalidos > 0 || resultado.bytesIgnorados > 0) ? 1 : 0;
+    }
+    
+    // Modo benchmark: mede o caminho crítico e grava o resultado em JSON
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        ConfiguracaoBenchmark config;
+        
+        if (!interpretarArgumentosBenchmark(argc, argv, &config)) {
+            return 1;
+        }
+        return executarBenchmark(&config);
+    }
+    
+    // Modo tempo real: laço de eventos com gravidade
+    // (--tempo-real [--gravar ARQ] [--recordes ARQ] [--cache-colocacoes])
+    if (argc > 1 && strcmp(argv[1], "--tempo-real") == 0) {
+        static LogJogadas log;
+        static RankingRecordes ranking;
+        LogJogadas* logPtr = NULL;
+        const char* arquivoLog = NULL;
+        const char* arquivoRanking = NULL;
+        int usarCacheColocacoes = 0;
+        
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--cache-colocacoes") == 0) {
+                usarCacheColocacoes = 1;
+            } else if (strcmp(argv[i], "--gravar") == 0 || strcmp(argv[i], "--recordes") == 0) {
+                if (i + 1 >= argc) {
+                    printf("Opcao %s sem valor.\n", argv[i]);
+                    return 1;
+                }
+                if (strcmp(argv[i], "--gravar") == 0) {
+                    arquivoLog = argv[++i];
+                } else {
+                    arquivoRanking = argv[++i];
+                }
+            } else {
+                printf("Opcao desconhecida: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        if (arquivoLog != NULL) {
+            if (!abrirLogJogadas(&log, arquivoLog)) {
+                return 1;
+            }
+            logPtr = &log;
+        }
+        int rankingAberto = 0;
+        if (arquivoRanking != NULL) {
+            rankingAberto = abrirRanking(&ranking, arquivoRanking, CAPACIDADE_RANKING_PADRAO);
+            if (!rankingAberto) {
+                if (logPtr != NULL) {
+                    fecharLogJogadas(logPtr);
+                }
+                return 1;
+            }
+        }
+        int codigo = executarJogoTempoReal(logPtr, rankingAberto ? &ranking : NULL, usarCacheColocacoes);
+        if (logPtr != NULL) {
+            fecharLogJogadas(logPtr);
+        }
+        if (rankingAberto) {
+            fecharRanking(&ranking);
+        }
+        return codigo;
+    }
+    
+    // Modo servidor: sessões remotas por socket (--servidor [opções])
+    if (argc > 1 && strcmp(argv[1], "--servidor") == 0) {
+        ConfiguracaoServidor config;
+        
+        if (!interpretarArgumentosServidor(argc, argv, &config)) {
+            return 1;
+        }
+        return executarServidor(&config);
+    }
+    
+    // Modo carga: gerador de carga local para o servidor (--carga [opções])
+    if (argc > 1 && strcmp(argv[1], "--carga") == 0) {
+        ConfiguracaoCarga config;
+        
+        if (!interpretarArgumentosCarga(argc, argv, &config)) {
+            return 1;
+        }
+        return executarCarga(&config);
+    }
+    
+    // Log opcional da partida interativa (--gravar ARQ), ranking (--recordes ARQ)
+    // e alimentador de peças (--alimentador)
+    static LogJogadas log;
+    LogJogadas* logPtr = NULL;
+    const char* arquivoRanking = NULL;
+    int usarAlimentador = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            if (!abrirLogJogadas(&log, argv[++i])) {
+                return 1;
+            }
+            logPtr = &log;
+        } else if (strcmp(argv[i], "--recordes") == 0 && i + 1 < argc) {
+            arquivoRanking = argv[++i];
+        } else if (strcmp(argv[i], "--alimentador") == 0) {
+            usarAlimentador = 1;
+        }
+    }
+    
     // Inicialização das estruturas
     FilaCircular fila;
     PilhaReserva pilha;
@@ -933,9 +9780,41 @@ int main() {
     inicializarPilha(&pilha);
     inicializarSistemaExpert(&sistema);
     
-    // Gerar peças iniciais
-    srand((unsigned int)time(NULL));
-    gerarPecasAleatorias(&fila);
+    // Com --recordes, o recorde pessoal parte do melhor resultado já gravado no ranking
+    static RankingRecordes ranking;
+    int rankingAberto = arquivoRanking != NULL && abrirRanking(&ranking, arquivoRanking, CAPACIDADE_RANKING_PADRAO);
+    if (rankingAberto) {
+        RegistroRecorde melhor;
+        if (consultarMelhoresRecordes(&ranking, &melhor, 1) == 1) {
+            sistema.recordePessoal = melhor.pontuacao;
+        }
+    }
+    
+    // Conselheiro de jogadas (opção 11): todas as threads, prazo fixo de resposta
+    static ConselheiroJogadas conselheiro;
+    ConfiguracaoConselheiro configConselheiro = {
+        PROFUNDIDADE_CONSELHEIRO_INTERATIVO, (int)sysconf(_SC_NPROCESSORS_ONLN),
+        ORCAMENTO_CONSELHEIRO_INTERATIVO_MS, BITS_CACHE_CONSELHEIRO_INTERATIVO, 0
+    };
+    if (!inicializarConselheiro(&conselheiro, &configConselheiro)) {
+        printf("Memoria insuficiente para o conselheiro de jogadas.\n");
+        return 1;
+    }
+    
+    // Gerar peças iniciais (com --alimentador, uma thread produtora sorteia as peças adiantadas)
+    static AlimentadorPecas alimentador;
+    inicializarGeradorPecas(&geradorGlobal, (uint64_t)time(NULL), GERADOR_UNIFORME);
+    registrarEventoLog(logPtr, EVENTO_INICIO_SESSAO, 0, criarPeca('X', 0), 0);
+    if (usarAlimentador && !iniciarAlimentadorPecas(&alimentador, &geradorGlobal, proximoId)) {
+        printf("Nao foi possivel iniciar o alimentador de pecas.\n");
+        usarAlimentador = 0;
+    }
+    if (usarAlimentador) {
+        abastecerFilaAlimentador(&alimentador, &fila, logPtr);
+    } else {
+        registrarEventoLog(logPtr, EVENTO_REABASTECIMENTO, 0, criarPeca('X', proximoId), CAPACIDADE_FILA);
+        gerarPecasAleatorias(&fila);
+    }
     
     int opcao;
     
@@ -955,6 +9834,7 @@ int main() {
             case 1: {
                 if (!filaVazia(&fila)) {
                     Peca peca = jogarPecaDaFila(&fila);
+                    registrarEventoLog(logPtr, EVENTO_JOGADA, 0, peca, 0);
                     processarJogadaExpert(peca, 0, &sistema);
                     printf("Peca %c (ID: %d) jogada da fila!\n", peca.tipo, peca.id);
                 } else {
@@ -966,6 +9846,7 @@ int main() {
             case 2: {
                 if (!pilhaVazia(&pilha)) {
                     Peca peca = jogarPecaDaPilha(&pilha);
+                    registrarEventoLog(logPtr, EVENTO_JOGADA, 1, peca, 0);
                     processarJogadaExpert(peca, 1, &sistema);
                     printf("Peca %c (ID: %d) jogada da pilha de reserva!\n", peca.tipo, peca.id);
                 } else {
@@ -975,12 +9856,27 @@ int main() {
                 break;
             }
             case 3: {
+                if (logPtr != NULL && !filaVazia(&fila) && !pilhaCheia(&pilha)) {
+                    Peca frente;
+                    espiarPecasDaFila(&fila, &frente, 1);
+                    registrarEventoLog(logPtr, EVENTO_RESERVA, 0, frente, 0);
+                }
                 transferirPecaFilaParaPilha(&fila, &pilha);
                 pausarExecucao();
                 break;
             }
             case 4: {
-                gerarPecasAleatorias(&fila);
+                int livres = CAPACIDADE_FILA - fila.quantidadePecas;
+                if (usarAlimentador) {
+                    if (abastecerFilaAlimentador(&alimentador, &fila, logPtr) < livres) {
+                        printf("Alimentador sem pecas suficientes; a fila foi completada em parte.\n");
+                    }
+                } else {
+                    if (livres > 0) {
+                        registrarEventoLog(logPtr, EVENTO_REABASTECIMENTO, 0, criarPeca('X', proximoId), livres);
+                    }
+                    gerarPecasAleatorias(&fila);
+                }
                 printf("Novas pecas geradas na fila!\n");
                 pausarExecucao();
                 break;
@@ -997,6 +9893,7 @@ int main() {
             }
             case 7: {
                 if (otimizarSistemaExpert(&sistema)) {
+                    registrarEventoLog(logPtr, EVENTO_OTIMIZACAO, 0, criarPeca('X', 0), 0);
                     printf("Sistema Expert otimizado com sucesso!\n");
                 } else {
                     printf("Sistema Expert ja esta otimizado.\n");
@@ -1009,6 +9906,58 @@ int main() {
                 pausarExecucao();
                 break;
             }
+            case 9: {
+                SnapshotJogo snapshot;
+                if (usarAlimentador) {
+                    // O gerador pertence ao produtor; as peças já no anel não entram no snapshot
+                    pararAlimentadorPecas(&alimentador);
+                    capturarSnapshotJogo(&snapshot, &fila, &pilha, &sistema, alimentador.proximoId, &alimentador.gerador);
+                    retomarAlimentadorPecas(&alimentador);
+                } else {
+                    capturarSnapshotJogo(&snapshot, &fila, &pilha, &sistema, proximoId, &geradorGlobal);
+                }
+                if (gravarSnapshotJogo(ARQUIVO_SNAPSHOT_PADRAO, &snapshot)) {
+                    printf("Estado salvo em %s (%zu bytes).\n", ARQUIVO_SNAPSHOT_PADRAO, sizeof(snapshot));
+                }
+                pausarExecucao();
+                break;
+            }
+            case 10: {
+                SnapshotJogo snapshot;
+                if (logPtr != NULL) {
+                    // O replay não teria como reproduzir um salto de estado
+                    printf("Carregar estado nao e permitido durante a gravacao do log.\n");
+                } else if (lerSnapshotJogo(ARQUIVO_SNAPSHOT_PADRAO, &snapshot)) {
+                    fila = snapshot.fila;
+                    pilha = snapshot.pilha;
+                    sistema = snapshot.sistema;
+                    proximoId = snapshot.proximoId;
+                    geradorGlobal = snapshot.gerador;
+                    if (usarAlimentador) {
+                        pararAlimentadorPecas(&alimentador);
+                        redefinirAlimentadorPecas(&alimentador, &snapshot.gerador, snapshot.proximoId);
+                        retomarAlimentadorPecas(&alimentador);
+                    }
+                    printf("Estado restaurado de %s.\n", ARQUIVO_SNAPSHOT_PADRAO);
+                }
+                pausarExecucao();
+                break;
+            }
+            case 11: {
+                SugestaoConselheiro sugestao;
+                aconselharJogada(&conselheiro, &fila, &pilha, &sistema, &sugestao);
+                exibirSugestaoConselheiro(&fila, &pilha, &sugestao);
+                pausarExecucao();
+                break;
+            }
+            case 12: {
+                exibirInstrumentacao();
+                if (exportarInstrumentacaoPrometheus(ARQUIVO_METRICAS_PADRAO)) {
+                    printf("Metricas gravadas em %s\n", ARQUIVO_METRICAS_PADRAO);
+                }
+                pausarExecucao();
+                break;
+            }
             case 0: {
                 printf("\n+==============================================================+\n");
                 printf("|                    OBRIGADO POR JOGAR!                      |\n");
@@ -1017,6 +9966,12 @@ int main() {
                 printf("|  Nivel Alcancado: %3d                                    |\n", sistema.nivelAtual);
                 printf("|  Melhor Combo: %3d                                       |\n", sistema.melhorCombo);
                 printf("+==============================================================+\n");
+                if (rankingAberto) {
+                    int posicao = registrarRecorde(&ranking, &sistema);
+                    if (posicao > 0) {
+                        printf("Posicao no ranking: %d de %u\n", posicao, ranking.cabecalho->quantidade);
+                    }
+                }
                 break;
             }
             default: {
@@ -1027,6 +9982,17 @@ int main() {
         }
     } while (opcao != 0);
     
+    if (usarAlimentador) {
+        pararAlimentadorPecas(&alimentador);
+        exibirEstatisticasAlimentador(&alimentador);
+    }
+    if (logPtr != NULL) {
+        fecharLogJogadas(logPtr);
+    }
+    if (rankingAberto) {
+        fecharRanking(&ranking);
+    }
+    liberarConselheiro(&conselheiro);
     return 0;
 }
 